@@ -4,6 +4,25 @@
  */
 
 #include <cli.h>
+#include <cli_stream.h>
+#include <cli_var.h>
+#include <cli_kv.h>
+#include <cli_mem.h>
+#include <cli_ymodem.h>
+#include <cli_table.h>
+#include <cli_style.h>
+#include <cli_diag.h>
+#include <cli_prof.h>
+#include <cli_heap.h>
+#include <cli_event.h>
+#include <cli_audit.h>
+#include <cli_bench.h>
+#include <cli_metrics.h>
+#include <cli_fmt.h>
+#include <cli_arg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 
 /* 注册命令数据 */
 extern const cli_command_t cmd_help_struct;
@@ -11,20 +30,115 @@ extern const cli_command_t cmd_echo_struct;
 extern const cli_command_t cmd_clear_struct;
 extern const cli_command_t cmd_version_struct;
 extern const cli_command_t cmd_led_struct;
+extern const cli_command_t cmd_stats_struct;
 
-/* 声明平台函数（在 cli_port_x86.c 中实现） */
+/* 声明平台函数（在 cli_demo_port_*.c 中实现） */
 void platform_init(void);
 void platform_cleanup(void);
 int  platform_getchar(void);
 void platform_putchar(char c);
 void platform_puts(const char *s);
+void platform_write(const char *buf, size_t len);
+uint32_t platform_get_tick_ms(void);
+void platform_set_binary(int enable);
+void platform_idle(void);
 
 extern const cli_command_t g_cli_commands[];
 
+#if defined(CLI_PLATFORM_STM32F1)
+/* 每次按键的处理周期数（在 cli_demo_port_stm32f1.c 中统计） */
+extern volatile uint32_t g_port_key_cycles;
+extern volatile uint32_t g_port_key_cycles_max;
+/* SysTick 换算的周期计数（32位回绕），用于基准计时 */
+uint32_t platform_get_cycles(void);
+#else
+/* 文件模拟的 Flash（在 cli_demo_kv_file.c 中实现） */
+const cli_kv_flash_t* demo_kv_file_open(const char *path);
+#endif
+
+/* 演示内存区域（在 cli_demo_mem.c 中实现） */
+void demo_mem_init(void);
+
+/* YMODEM 文件存储（在 cli_demo_files.c 中实现） */
+extern const cli_ymodem_storage_t g_demo_file_storage;
+
+/* 演示用遥测变量，由主循环更新 */
+static volatile uint32_t s_demo_loops = 0;
+static volatile uint32_t s_demo_uptime = 0;
+static volatile int16_t s_demo_saw = 0;
+static bool s_demo_saw_high = false;
+
+/* 演示用调参变量 */
+static volatile uint8_t s_demo_brightness = 50;
+static volatile float s_demo_gain = 1.5f;
+static volatile bool s_demo_verbose = false;
+static volatile int s_demo_mode = 0;
+static const char *const s_demo_mode_names[] = { "off", "auto", "manual" };
+
+/* 演示指标：主循环次数在热路径上计数，亮度在导出时读取 */
+static cli_metric_t s_metric_loops;
+static cli_metric_t s_metric_brightness;
+
+static int32_t demo_metric_brightness(void)
+{
+    return (int32_t)s_demo_brightness;
+}
+
+/* 调参变量修改回调 */
+static void demo_var_changed(const cli_var_t *var)
+{
+    if (s_demo_verbose)
+    {
+        cli_printf("[%s changed]\r\n", var->name);
+    }
+}
+
+/* 演示基准（bench all） */
+static uint8_t s_bench_src[256];
+static uint8_t s_bench_dst[256];
+
+static void demo_bench_memcpy(uint32_t n)
+{
+    while (n--)
+    {
+        s_bench_src[n & 0xFFu] = (uint8_t)n;
+        memcpy(s_bench_dst, s_bench_src, sizeof(s_bench_dst));
+        cli_bench_sink += s_bench_dst[n & 0xFFu];
+    }
+}
+
+static void demo_bench_fmt_float(uint32_t n)
+{
+    char buf[32];
+    while (n--)
+    {
+        cli_bench_sink += (uint32_t)cli_fmt_float(buf, (float)n * 0.37f);
+    }
+}
+
+static void demo_bench_var_find(uint32_t n)
+{
+    while (n--)
+    {
+        cli_bench_sink += (cli_var_find("gain") != NULL);
+    }
+}
+
+#if defined(__linux__)
+#include <time.h>
+/* 基准计时：单调时钟的纳秒数（32位回绕） */
+static uint32_t demo_bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
 /* Linux 信号处理 */
 #if defined(__linux__) || defined(__unix__)
 #include <signal.h>
-#include <stdlib.h>
+#include <unistd.h>
 static void signal_handler(int sig)
 {
     (void)sig;
@@ -47,18 +161,157 @@ int main(void)
     cli_io_t io = {
         .getchar = platform_getchar,
         .putchar = platform_putchar,
-        .puts    = platform_puts
+        .puts    = platform_puts,
+        .write   = platform_write,
+        .get_tick_ms = platform_get_tick_ms,
+        .set_binary = platform_set_binary
     };
 
     /* 初始化CLI */
     cli_init(&io);
 
+#if (defined(__linux__) || defined(__unix__)) && !defined(CLI_PLATFORM_TTY)
+    /* 哑终端或输出被重定向时不输出颜色（串口控制台不受本地终端影响） */
+    {
+        const char *term = getenv("TERM");
+        if (term == NULL || strcmp(term, "dumb") == 0 || !isatty(STDOUT_FILENO))
+        {
+            cli_style_enable(false);
+        }
+    }
+#endif
+
     /* 注册内置命令（传入命令结构体指针） */
     cli_command_register(&cmd_help_struct);
     cli_command_register(&cmd_echo_struct);
     cli_command_register(&cmd_clear_struct);
     cli_command_register(&cmd_version_struct);
     cli_command_register(&cmd_led_struct);
+    cli_command_register(&cli_stream_cmd);
+    cli_command_register(&cli_var_get_cmd);
+    cli_command_register(&cli_var_set_cmd);
+    cli_command_register(&cli_var_list_cmd);
+    cli_command_register(&cli_kv_config_cmd);
+    cli_command_register(&cli_mem_md_cmd);
+    cli_command_register(&cli_mem_mw_cmd);
+    cli_command_register(&cli_mem_mf_cmd);
+    cli_command_register(&cli_mem_mc_cmd);
+    cli_command_register(&cli_ymodem_rx_cmd);
+    cli_command_register(&cli_ymodem_sx_cmd);
+    cli_command_register(&cmd_stats_struct);
+    cli_command_register(&cli_table_format_cmd);
+    cli_command_register(&cli_automation_cmd);
+    cli_command_register(&cli_limit_cmd);
+    cli_command_register(&cli_event_subscribe_cmd);
+    cli_command_register(&cli_event_unsubscribe_cmd);
+    cli_command_register(&cli_bench_cmd);
+    cli_command_register(&cli_metrics_cmd);
+#if defined(__linux__)
+    cli_command_register(&cli_diag_ps_cmd);
+    cli_command_register(&cli_diag_mem_cmd);
+    cli_command_register(&cli_diag_fds_cmd);
+    cli_command_register(&cli_diag_loop_cmd);
+    cli_command_register(&cli_prof_cmd);
+    cli_command_register(&cli_audit_cmd);
+#endif
+#if CLI_HEAP_PROFILE
+    cli_command_register(&cli_heap_cmd);
+#endif
+
+    /* 变量绑定：遥测量只读，调参量带范围和回调 */
+    cli_var_register("loops", &s_demo_loops, CLI_VAR_UINT32, CLI_VAR_FLAG_READONLY);
+    cli_var_register("uptime", &s_demo_uptime, CLI_VAR_UINT32, CLI_VAR_FLAG_READONLY);
+    cli_var_register("saw", &s_demo_saw, CLI_VAR_INT16, CLI_VAR_FLAG_READONLY);
+    cli_var_register("brightness", &s_demo_brightness, CLI_VAR_UINT8, CLI_VAR_FLAG_PERSIST);
+    cli_var_set_range("brightness", 0, 100);
+    cli_var_register("gain", &s_demo_gain, CLI_VAR_FLOAT, CLI_VAR_FLAG_PERSIST);
+    cli_var_set_range_f("gain", 0.0f, 10.0f);
+    cli_var_register("verbose", &s_demo_verbose, CLI_VAR_BOOL, 0);
+    cli_var_register("mode", &s_demo_mode, CLI_VAR_ENUM, CLI_VAR_FLAG_PERSIST);
+    cli_var_set_enum("mode", s_demo_mode_names, 3);
+    cli_var_set_notify("brightness", demo_var_changed);
+    cli_var_set_notify("gain", demo_var_changed);
+    cli_var_set_notify("mode", demo_var_changed);
+
+#if defined(CLI_PLATFORM_STM32F1)
+    cli_var_register("key_cycles", &g_port_key_cycles, CLI_VAR_UINT32, CLI_VAR_FLAG_READONLY);
+    cli_var_register("key_cycles_max", &g_port_key_cycles_max, CLI_VAR_UINT32, CLI_VAR_FLAG_READONLY);
+#else
+    /* 持久化配置：挂载文件模拟的 Flash 并恢复变量 */
+    {
+        const char *path = getenv("CLI_DEMO_KV_FILE");
+        const cli_kv_flash_t *flash = demo_kv_file_open(path ? path : "cli_demo_kv.bin");
+        if (flash != NULL && cli_kv_mount(flash) == CLI_SUCCESS)
+        {
+            cli_kv_load_vars();
+        }
+    }
+#endif
+
+    /* 内存查看区域 */
+    demo_mem_init();
+
+    /* 文件传输（裸机平台没有文件存储，rx/sx 提示无存储） */
+#if defined(CLI_PLATFORM_STM32F1)
+    cli_ymodem_init(NULL);
+#else
+    cli_ymodem_init(&g_demo_file_storage);
+#endif
+
+    /* 基准：优先使用高精度计数器 */
+#if defined(CLI_PLATFORM_STM32F1)
+    cli_bench_set_counter(platform_get_cycles, STM32F1_HCLK_HZ);
+#elif defined(__linux__)
+    cli_bench_set_counter(demo_bench_ns, 1000000000u);
+#endif
+    CLI_BENCH(memcpy_256, demo_bench_memcpy);
+    CLI_BENCH(fmt_float, demo_bench_fmt_float);
+    CLI_BENCH(var_find, demo_bench_var_find);
+
+    /* 指标 */
+    cli_metrics_counter(&s_metric_loops, "demo_loops", "Main loop iterations");
+    cli_metrics_gauge(&s_metric_brightness, "demo_brightness", "Brightness setting in percent", demo_metric_brightness);
+
+    /* 遥测流 */
+    cli_stream_init();
+
+    /* 事件 */
+    cli_event_init();
+
+#if defined(__linux__)
+    /* 进程诊断 */
+    cli_diag_init();
+    cli_prof_init();
+
+    /* 会话审计：设置 CLI_AUDIT_LOG 时从启动开始记录 */
+    cli_audit_init();
+    {
+        const char *audit = getenv("CLI_AUDIT_LOG");
+        if (audit != NULL && audit[0] != '\0')
+        {
+            cli_audit_start(audit, NULL);
+        }
+    }
+
+    /* 指标抓取端口：设置 CLI_METRICS_PORT 时在本机回环地址上监听 */
+    {
+        const char *port = getenv("CLI_METRICS_PORT");
+        uint32_t value;
+        cli_error_t err;
+        if (port != NULL && port[0] != '\0')
+        {
+            if (cli_arg_u32(CLI_ARG(port), 1u, 65535u, &value) != CLI_SUCCESS)
+            {
+                cli_arg_report("CLI_METRICS_PORT", CLI_ARG(port));
+            }
+            else if ((err = cli_metrics_listen(NULL, (uint16_t)value)) != CLI_SUCCESS)
+            {
+                cli_printf("Metrics listen failed: %s\r\n",
+                           (err == CLI_ERR_TABLE_FULL) ? "poll table full" : strerror(errno));
+            }
+        }
+    }
+#endif
 
     /* 主循环 */
     while (1)
@@ -66,6 +319,19 @@ int main(void)
         /* 周期性的调用处理函数，处理端口输入内容 */
         cli_ticks_handler();
         /* 可添加其他后台任务 */
+        s_demo_loops++;
+        cli_metrics_inc(&s_metric_loops);
+        s_demo_uptime = platform_get_tick_ms();
+        s_demo_saw = (int16_t)((s_demo_uptime % 2000u) - 1000);
+        /* 演示事件：每次循环一个高频事件，锯齿波越过阈值时一个低频事件 */
+        cli_event_publish("demo.tick", NULL);
+        if (s_demo_saw >= 900 && !s_demo_saw_high)
+        {
+            cli_event_publish("demo.saw.high", "900");
+        }
+        s_demo_saw_high = (s_demo_saw >= 900);
+        /* 空闲等待，嵌入式平台在此休眠到下一个中断 */
+        platform_idle();
     }
 
     /* 不会到达这里，但保留 */
@@ -4,6 +4,12 @@
  */
 
 #include <cli.h>
+#include <cli_z.h>
+#include <cli_stream.h>
+#include <cli_kv.h>
+#include <cli_arg.h>
+#include <cli_event.h>
+#include <cli_help.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdarg.h>
@@ -14,43 +20,51 @@ static int cmd_echo(int argc, char **argv);
 static int cmd_clear(int argc, char **argv);
 static int cmd_version(int argc, char **argv);
 static int cmd_led(int argc, char **argv);
+static int cmd_stats(int argc, char **argv);
 
 /* 定义命令结构体（静态常量，生命周期持续整个程序） */
 const cli_command_t cmd_help_struct = {
     .name = "help",
     .short_name = "h",               /* 短名 h */
-    .help = "Show this help message",
+    .help = CLI_HELP("Show this help message"),
     .handler = cmd_help
 };
 
 const cli_command_t cmd_echo_struct = {
     .name = "echo",
     .short_name = "e",               /* 短名 e */
-    .help = "Echo the arguments",
+    .help = CLI_HELP("Echo the arguments"),
     .handler = cmd_echo
 };
 
 const cli_command_t cmd_clear_struct = {
     .name = "clear",
     .short_name = "c",               /* 短名 c */
-    .help = "Clear the screen",
+    .help = CLI_HELP("Clear the screen"),
     .handler = cmd_clear
 };
 
 const cli_command_t cmd_version_struct = {
     .name = "version",
     .short_name = "v",               /* 短名 v */
-    .help = "Show version information",
+    .help = CLI_HELP("Show version information"),
     .handler = cmd_version
 };
 
 const cli_command_t cmd_led_struct = {
     .name = "led",
     .short_name = "l",               /* 短名 l */
-    .help = "Control and change the state of an LED light",
+    .help = CLI_HELP("Control and change the state of an LED light: led <0..3> <on|off>"),
     .handler = cmd_led
 };
 
+const cli_command_t cmd_stats_struct = {
+    .name = "stats",
+    .short_name = NULL,
+    .help = CLI_HELP("Show compression, stream and config store statistics"),
+    .handler = cmd_stats
+};
+
 /* 帮助命令 - 动态获取所有已注册命令 */
 static int cmd_help(int argc, char **argv)
 {
@@ -77,10 +91,7 @@ static int cmd_help(int argc, char **argv)
                 cli_puts(")");
             }
             cli_puts(" - ");
-            if (cmd->help != NULL)
-            {
-                cli_puts(cmd->help);
-            }
+            cli_help_write(cmd);
             cli_puts("\r\n");
         }
     }
@@ -122,22 +133,65 @@ static int cmd_version(int argc, char **argv)
     return 0;
 }
 
-/* LED 控制命令示例 */
+/* LED 控制命令示例：led <0..3> <on|off> */
 static int cmd_led(int argc, char **argv)
 {
+    uint32_t index;
+    bool on;
+
+    if (argc < 3)
+    {
+        cli_puts("Incomplete parameter.\r\n");
+        return -1;
+    }
+    if (cli_arg_u32(CLI_ARG(argv[1]), 0, 3, &index) != CLI_SUCCESS)
+    {
+        cli_arg_report("led", CLI_ARG(argv[1]));
+        return -1;
+    }
+    if (cli_arg_bool(CLI_ARG(argv[2]), &on) != CLI_SUCCESS)
+    {
+        cli_arg_report("state", CLI_ARG(argv[2]));
+        return -1;
+    }
+    cli_printf("LED %u %s\r\n", (unsigned int)index, on ? "on" : "off");
+    {
+        char name[] = "led.0";
+        name[4] = (char)('0' + index);
+        cli_event_publish(name, on ? "on" : "off");
+    }
+    return 0;
+}
+
+/* 统计命令 - 汇总各模块的运行统计 */
+static int cmd_stats(int argc, char **argv)
+{
+    cli_z_stats_t z;
+    cli_stream_stats_t st;
+    cli_kv_stats_t kv;
+
     (void)argc;
     (void)argv;
-    if(argc > 2)
+
+    cli_z_get_stats(&z);
+    cli_printf("compress: sessions %u, in %u, out %u",
+               (unsigned int)z.sessions, (unsigned int)z.bytes_in, (unsigned int)z.bytes_out);
+    if (z.bytes_out > 0)
     {
-        cli_puts("LED ");
-        cli_puts(argv[1]);
-        cli_puts(" ");
-        cli_puts(argv[2]);
-        cli_puts("\n");
+        cli_printf(", ratio %.2f:1", (double)z.bytes_in / z.bytes_out);
     }
-    else
+    if (z.elapsed_ms > 0)
     {
-        cli_puts("Incomplete parameter.\r\n");
+        cli_printf(", %.1f KB/s", (double)z.bytes_in / z.elapsed_ms);
     }
+    cli_puts("\r\n");
+
+    cli_stream_get_stats(&st);
+    cli_printf("stream:   samples %u, dropped %u\r\n", (unsigned int)st.samples, (unsigned int)st.dropped);
+
+    cli_kv_get_stats(&kv);
+    cli_printf("config:   keys %u, used %u/%u, compactions %u\r\n",
+               (unsigned int)kv.keys, (unsigned int)kv.bytes_used, (unsigned int)kv.bytes_total,
+               (unsigned int)kv.compactions);
     return 0;
 }
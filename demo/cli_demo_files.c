@@ -0,0 +1,88 @@
+/*
+ * @file cli_demo_files.c
+ * @brief 演示用 YMODEM 存储：在当前目录下读写普通文件
+ */
+
+#include <cli_ymodem.h>
+#include <stdio.h>
+#include <string.h>
+
+static FILE *s_file = NULL;
+
+/* 去掉路径部分，避免写到当前目录之外 */
+static const char* files_basename(const char *name)
+{
+    const char *p = strrchr(name, '/');
+    const char *q = strrchr(name, '\\');
+    if (q != NULL && (p == NULL || q > p))
+    {
+        p = q;
+    }
+    return (p != NULL) ? p + 1 : name;
+}
+
+static int files_open_write(void *ctx, const char *name, uint32_t size)
+{
+    (void)ctx;
+    (void)size;
+    name = files_basename(name);
+    if (name[0] == '\0' || name[0] == '.')
+    {
+        return -1;
+    }
+    s_file = fopen(name, "wb");
+    return (s_file != NULL) ? 0 : -1;
+}
+
+static int files_write(void *ctx, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    return (fwrite(data, 1, len, s_file) == len) ? 0 : -1;
+}
+
+static int files_open_read(void *ctx, const char *name, uint32_t *size)
+{
+    long end;
+    (void)ctx;
+    s_file = fopen(name, "rb");
+    if (s_file == NULL)
+    {
+        return -1;
+    }
+    if (fseek(s_file, 0, SEEK_END) != 0 || (end = ftell(s_file)) < 0 || fseek(s_file, 0, SEEK_SET) != 0)
+    {
+        fclose(s_file);
+        s_file = NULL;
+        return -1;
+    }
+    *size = (uint32_t)end;
+    return 0;
+}
+
+static int files_read(void *ctx, uint8_t *buf, size_t len)
+{
+    size_t n;
+    (void)ctx;
+    n = fread(buf, 1, len, s_file);
+    return (n == 0 && ferror(s_file)) ? -1 : (int)n;
+}
+
+static void files_close(void *ctx, bool ok)
+{
+    (void)ctx;
+    (void)ok;
+    if (s_file != NULL)
+    {
+        fclose(s_file);
+        s_file = NULL;
+    }
+}
+
+const cli_ymodem_storage_t g_demo_file_storage = {
+    .open_write = files_open_write,
+    .write = files_write,
+    .open_read = files_open_read,
+    .read = files_read,
+    .close = files_close,
+    .ctx = NULL
+};
@@ -0,0 +1,114 @@
+/*
+ * @file cli_demo_kv_file.c
+ * @brief 以普通文件模拟 NOR Flash，供 cli_kv 在 PC 上测试
+ *
+ * 写入按 NOR 语义与原内容按位与，擦除填充 0xFF，掉电/重复编程等行为与真实
+ * Flash 一致，便于在本地验证日志结构存储的恢复逻辑。
+ */
+
+#include <cli_kv.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 模拟介质参数 */
+#ifndef DEMO_KV_SECTOR_SIZE
+#define DEMO_KV_SECTOR_SIZE     4096u
+#endif
+
+#ifndef DEMO_KV_SECTOR_COUNT
+#define DEMO_KV_SECTOR_COUNT    4u
+#endif
+
+static FILE *s_kv_file = NULL;
+
+static int kv_file_read(void *ctx, uint32_t addr, void *buf, size_t len)
+{
+    (void)ctx;
+    if (fseek(s_kv_file, (long)addr, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    return (fread(buf, 1, len, s_kv_file) == len) ? 0 : -1;
+}
+
+static int kv_file_write(void *ctx, uint32_t addr, const void *buf, size_t len)
+{
+    uint8_t chunk[64];
+    const uint8_t *src = (const uint8_t *)buf;
+
+    while (len > 0)
+    {
+        size_t n = (len < sizeof(chunk)) ? len : sizeof(chunk);
+        if (kv_file_read(ctx, addr, chunk, n) != 0)
+        {
+            return -1;
+        }
+        /* NOR 编程只能把1变为0 */
+        for (size_t i = 0; i < n; i++)
+        {
+            chunk[i] &= src[i];
+        }
+        if (fseek(s_kv_file, (long)addr, SEEK_SET) != 0 ||
+            fwrite(chunk, 1, n, s_kv_file) != n)
+        {
+            return -1;
+        }
+        addr += (uint32_t)n;
+        src += n;
+        len -= n;
+    }
+    return (fflush(s_kv_file) == 0) ? 0 : -1;
+}
+
+static int kv_file_erase(void *ctx, uint32_t sector)
+{
+    uint8_t ff[256];
+    (void)ctx;
+    memset(ff, 0xFF, sizeof(ff));
+    if (fseek(s_kv_file, (long)(sector * DEMO_KV_SECTOR_SIZE), SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    for (uint32_t i = 0; i < DEMO_KV_SECTOR_SIZE; i += sizeof(ff))
+    {
+        if (fwrite(ff, 1, sizeof(ff), s_kv_file) != sizeof(ff))
+        {
+            return -1;
+        }
+    }
+    return (fflush(s_kv_file) == 0) ? 0 : -1;
+}
+
+static const cli_kv_flash_t s_kv_file_flash = {
+    .sector_size = DEMO_KV_SECTOR_SIZE,
+    .sector_count = DEMO_KV_SECTOR_COUNT,
+    .read = kv_file_read,
+    .write = kv_file_write,
+    .erase = kv_file_erase,
+    .ctx = NULL
+};
+
+/* 打开（不存在则创建）模拟介质文件，返回 Flash 接口，失败返回NULL */
+const cli_kv_flash_t* demo_kv_file_open(const char *path)
+{
+    s_kv_file = fopen(path, "r+b");
+    if (s_kv_file == NULL)
+    {
+        /* 新文件：整个介质填充为擦除状态 */
+        s_kv_file = fopen(path, "w+b");
+        if (s_kv_file == NULL)
+        {
+            return NULL;
+        }
+        for (uint32_t i = 0; i < DEMO_KV_SECTOR_COUNT; i++)
+        {
+            if (kv_file_erase(NULL, i) != 0)
+            {
+                fclose(s_kv_file);
+                s_kv_file = NULL;
+                return NULL;
+            }
+        }
+    }
+    return &s_kv_file_flash;
+}
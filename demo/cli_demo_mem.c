@@ -0,0 +1,52 @@
+/*
+ * @file cli_demo_mem.c
+ * @brief 演示用内存区域：静态数组模拟片内RAM，Linux 下以 mmap 文件模拟设备内存
+ */
+
+#include <cli_mem.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__linux__) || defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/* 模拟设备内存大小 */
+#ifndef DEMO_MEM_DEVICE_SIZE
+#define DEMO_MEM_DEVICE_SIZE    (1024u * 1024u)
+#endif
+
+/* 模拟片内RAM */
+static uint64_t s_demo_sram[4096 / sizeof(uint64_t)];
+
+/* 只读的版本信息区 */
+static const char s_demo_rom[64] = "CLI Framework demo ROM";
+
+void demo_mem_init(void)
+{
+    cli_mem_region_register("sram", 0x20000000u, s_demo_sram, sizeof(s_demo_sram), 0);
+    cli_mem_region_register("rom", 0x08000000u, (volatile void *)s_demo_rom, sizeof(s_demo_rom),
+                            CLI_MEM_FLAG_READONLY);
+
+#if defined(__linux__) || defined(__unix__)
+    {
+        const char *path = getenv("CLI_DEMO_MEM_FILE");
+        int fd = open(path ? path : "cli_demo_mem.bin", O_RDWR | O_CREAT, 0644);
+        if (fd >= 0)
+        {
+            if (ftruncate(fd, DEMO_MEM_DEVICE_SIZE) == 0)
+            {
+                void *p = mmap(NULL, DEMO_MEM_DEVICE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    cli_mem_region_register("device", 0x40000000u, p, DEMO_MEM_DEVICE_SIZE, 0);
+                }
+            }
+            /* 映射建立后即可关闭描述符 */
+            close(fd);
+        }
+    }
+#endif
+}
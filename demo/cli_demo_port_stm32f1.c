@@ -0,0 +1,346 @@
+/*
+ * @file cli_demo_port_stm32f1.c
+ * @brief 平台抽象层实现 (STM32F1 / Cortex-M3，裸机)
+ *
+ * USART2 (PA2 TX / PA3 RX) 作为控制台：接收在中断中写入环形缓冲区，
+ * 发送由 TXE 中断从发送环形缓冲区取数据；SysTick 提供 1ms 节拍；
+ * 主循环空闲时 WFI 休眠，由 USART 或 SysTick 中断唤醒。
+ * 时钟使用复位后的 HSI 8MHz，不配置 PLL。
+ * 定义 STM32F1_QEMU_NETDUINO2 时在 QEMU netduino2（STM32F205）上运行：其 USART2、
+ * NVIC 中断号和 SysTick 与 F1 相同，但 RCC/GPIO 位于其它地址，F1 的地址上没有
+ * 外设，因此跳过时钟使能和引脚配置（QEMU 的 USART 不需要）。
+ *
+ * 同时包含向量表和复位处理，链接脚本见 demo/stm32f1.ld。
+ */
+
+#include "cli_port.h"
+#include <string.h>
+
+/* 系统时钟（HCLK = PCLK1 = HSI） */
+#ifndef STM32F1_HCLK_HZ
+#define STM32F1_HCLK_HZ         8000000u
+#endif
+
+/* 控制台波特率 */
+#ifndef STM32F1_CONSOLE_BAUD
+#define STM32F1_CONSOLE_BAUD    115200u
+#endif
+
+/* 收发环形缓冲区大小（2的幂） */
+#ifndef STM32F1_RX_RING_SIZE
+#define STM32F1_RX_RING_SIZE    64u
+#endif
+#ifndef STM32F1_TX_RING_SIZE
+#define STM32F1_TX_RING_SIZE    256u
+#endif
+
+/* 寄存器访问 */
+#define REG32(addr)             (*(volatile uint32_t *)(addr))
+
+/* RCC */
+#define RCC_BASE                0x40021000u
+#define RCC_APB2ENR             REG32(RCC_BASE + 0x18u)
+#define RCC_APB1ENR             REG32(RCC_BASE + 0x1Cu)
+#define RCC_APB2ENR_AFIOEN      (1u << 0)
+#define RCC_APB2ENR_IOPAEN      (1u << 2)
+#define RCC_APB1ENR_USART2EN    (1u << 17)
+
+/* GPIOA */
+#define GPIOA_BASE              0x40010800u
+#define GPIOA_CRL               REG32(GPIOA_BASE + 0x00u)
+
+/* USART2 */
+#define USART2_BASE             0x40004400u
+#define USART2_SR               REG32(USART2_BASE + 0x00u)
+#define USART2_DR               REG32(USART2_BASE + 0x04u)
+#define USART2_BRR              REG32(USART2_BASE + 0x08u)
+#define USART2_CR1              REG32(USART2_BASE + 0x0Cu)
+#define USART_SR_ORE            (1u << 3)
+#define USART_SR_RXNE           (1u << 5)
+#define USART_SR_TXE            (1u << 7)
+#define USART_CR1_RE            (1u << 2)
+#define USART_CR1_TE            (1u << 3)
+#define USART_CR1_RXNEIE        (1u << 5)
+#define USART_CR1_TXEIE         (1u << 7)
+#define USART_CR1_UE            (1u << 13)
+#define USART2_IRQN             38u
+
+/* Cortex-M3 内核外设 */
+#define NVIC_ISER(n)            REG32(0xE000E100u + 4u * (n))
+#define SYST_CSR                REG32(0xE000E010u)
+#define SYST_RVR                REG32(0xE000E014u)
+#define SYST_CVR                REG32(0xE000E018u)
+#define SYST_CSR_ENABLE         (1u << 0)
+#define SYST_CSR_TICKINT        (1u << 1)
+#define SYST_CSR_CLKSOURCE      (1u << 2)
+
+/* SysTick 重装值：1ms */
+#define SYSTICK_RELOAD          (STM32F1_HCLK_HZ / 1000u - 1u)
+
+/* 链接脚本提供的符号 */
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+extern int main(void);
+
+/* 单生产者单消费者环形缓冲区，下标自由增长，取模在访问时进行 */
+static struct
+{
+    uint8_t buf[STM32F1_RX_RING_SIZE];
+    volatile uint16_t head;         /* 中断写入 */
+    volatile uint16_t tail;         /* 主循环读取 */
+    volatile uint32_t overflow;     /* 缓冲区满丢弃的字节数 */
+} s_rx;
+
+static struct
+{
+    uint8_t buf[STM32F1_TX_RING_SIZE];
+    volatile uint16_t head;         /* 主循环写入 */
+    volatile uint16_t tail;         /* 中断读取 */
+} s_tx;
+
+static volatile uint32_t s_ticks = 0;
+
+/* 按键处理耗时（周期数）：从取出字符到下一次进入空闲 */
+volatile uint32_t g_port_key_cycles = 0;
+volatile uint32_t g_port_key_cycles_max = 0;
+static uint32_t s_key_start = 0;
+static int s_key_pending = 0;
+
+static uint32_t irq_save(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static void irq_restore(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/* 以 SysTick 计数换算的周期数（32位回绕，仅用于求差） */
+static uint32_t port_cycles(void)
+{
+    uint32_t ms;
+    uint32_t val;
+    do {
+        ms = s_ticks;
+        val = SYST_CVR;
+    } while (ms != s_ticks);
+    return ms * (SYSTICK_RELOAD + 1u) + (SYSTICK_RELOAD - val);
+}
+
+uint32_t platform_get_cycles(void)
+{
+    return port_cycles();
+}
+
+void SysTick_Handler(void)
+{
+    s_ticks++;
+}
+
+void USART2_IRQHandler(void)
+{
+    uint32_t sr = USART2_SR;
+
+    if (sr & (USART_SR_RXNE | USART_SR_ORE))
+    {
+        /* 读 DR 同时清除 RXNE/ORE */
+        uint8_t c = (uint8_t)USART2_DR;
+        uint16_t head = s_rx.head;
+        if ((uint16_t)(head - s_rx.tail) < STM32F1_RX_RING_SIZE)
+        {
+            s_rx.buf[head & (STM32F1_RX_RING_SIZE - 1u)] = c;
+            s_rx.head = (uint16_t)(head + 1u);
+        }
+        else
+        {
+            s_rx.overflow++;
+        }
+    }
+    if ((sr & USART_SR_TXE) && (USART2_CR1 & USART_CR1_TXEIE))
+    {
+        uint16_t tail = s_tx.tail;
+        if (tail != s_tx.head)
+        {
+            USART2_DR = s_tx.buf[tail & (STM32F1_TX_RING_SIZE - 1u)];
+            s_tx.tail = (uint16_t)(tail + 1u);
+        }
+        else
+        {
+            /* 发送完毕，关闭 TXE 中断 */
+            USART2_CR1 &= ~USART_CR1_TXEIE;
+        }
+    }
+}
+
+void platform_init(void)
+{
+#ifndef STM32F1_QEMU_NETDUINO2
+    RCC_APB2ENR |= RCC_APB2ENR_IOPAEN | RCC_APB2ENR_AFIOEN;
+    RCC_APB1ENR |= RCC_APB1ENR_USART2EN;
+
+    /* PA2: 复用推挽输出 2MHz (0xA)，PA3: 浮空输入 (0x4) */
+    GPIOA_CRL = (GPIOA_CRL & ~0x0000FF00u) | 0x00004A00u;
+#endif
+
+    USART2_BRR = (STM32F1_HCLK_HZ + STM32F1_CONSOLE_BAUD / 2u) / STM32F1_CONSOLE_BAUD;
+    USART2_CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE | USART_CR1_RXNEIE;
+    NVIC_ISER(USART2_IRQN / 32u) = 1u << (USART2_IRQN % 32u);
+
+    SYST_RVR = SYSTICK_RELOAD;
+    SYST_CVR = 0;
+    SYST_CSR = SYST_CSR_CLKSOURCE | SYST_CSR_TICKINT | SYST_CSR_ENABLE;
+}
+
+void platform_cleanup(void)
+{
+}
+
+int platform_getchar(void)
+{
+    uint16_t tail = s_rx.tail;
+    int c;
+
+    if (tail == s_rx.head)
+    {
+        return -1;
+    }
+    c = s_rx.buf[tail & (STM32F1_RX_RING_SIZE - 1u)];
+    s_rx.tail = (uint16_t)(tail + 1u);
+    s_key_start = port_cycles();
+    s_key_pending = 1;
+    return c;
+}
+
+void platform_write(const char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        uint16_t head = s_tx.head;
+        uint16_t room = (uint16_t)(STM32F1_TX_RING_SIZE - (uint16_t)(head - s_tx.tail));
+        uint32_t primask;
+
+        if (room == 0)
+        {
+            /* 缓冲区满：等待发送中断腾出空间 */
+            __asm volatile ("wfi");
+            continue;
+        }
+        while (room > 0 && len > 0)
+        {
+            s_tx.buf[head & (STM32F1_TX_RING_SIZE - 1u)] = (uint8_t)*buf++;
+            head++;
+            room--;
+            len--;
+        }
+        s_tx.head = head;
+
+        /* 与中断中的清除互斥，避免读-改-写覆盖 */
+        primask = irq_save();
+        USART2_CR1 |= USART_CR1_TXEIE;
+        irq_restore(primask);
+    }
+}
+
+void platform_putchar(char c)
+{
+    platform_write(&c, 1);
+}
+
+void platform_puts(const char *s)
+{
+    platform_write(s, strlen(s));
+}
+
+uint32_t platform_get_tick_ms(void)
+{
+    return s_ticks;
+}
+
+void platform_set_binary(int enable)
+{
+    /* 串口本身是透明的，无需切换 */
+    (void)enable;
+}
+
+void platform_idle(void)
+{
+    if (s_key_pending)
+    {
+        uint32_t cycles = port_cycles() - s_key_start;
+        g_port_key_cycles = cycles;
+        if (cycles > g_port_key_cycles_max)
+        {
+            g_port_key_cycles_max = cycles;
+        }
+        s_key_pending = 0;
+    }
+    /* 还有未处理的输入时不休眠 */
+    if (s_rx.tail == s_rx.head)
+    {
+        __asm volatile ("wfi");
+    }
+}
+
+/* 复位处理：初始化 .data/.bss 后进入 main */
+void Reset_Handler(void)
+{
+    uint32_t *src = &_sidata;
+    uint32_t *dst = &_sdata;
+
+    while (dst < &_edata)
+    {
+        *dst++ = *src++;
+    }
+    for (dst = &_sbss; dst < &_ebss; dst++)
+    {
+        *dst = 0;
+    }
+    main();
+    for (;;)
+    {
+    }
+}
+
+void Default_Handler(void)
+{
+    for (;;)
+    {
+    }
+}
+
+/* 向量表：16个内核异常 + STM32F10x 大容量产品的60个外设中断 */
+#define VEC_DEFAULT             ((uintptr_t)Default_Handler)
+#define VEC_DEFAULT4            VEC_DEFAULT, VEC_DEFAULT, VEC_DEFAULT, VEC_DEFAULT
+
+__attribute__((section(".isr_vector"), used))
+const uintptr_t g_vector_table[16 + 60] = {
+    (uintptr_t)&_estack,
+    (uintptr_t)Reset_Handler,
+    VEC_DEFAULT,                    /* NMI */
+    VEC_DEFAULT,                    /* HardFault */
+    VEC_DEFAULT,                    /* MemManage */
+    VEC_DEFAULT,                    /* BusFault */
+    VEC_DEFAULT,                    /* UsageFault */
+    0, 0, 0, 0,                     /* 保留 */
+    VEC_DEFAULT,                    /* SVCall */
+    VEC_DEFAULT,                    /* DebugMon */
+    0,                              /* 保留 */
+    VEC_DEFAULT,                    /* PendSV */
+    (uintptr_t)SysTick_Handler,
+    /* IRQ0..IRQ37 */
+    VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4,
+    VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4,
+    VEC_DEFAULT4, VEC_DEFAULT, VEC_DEFAULT,
+    (uintptr_t)USART2_IRQHandler,   /* IRQ38 */
+    /* IRQ39..IRQ59 */
+    VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4, VEC_DEFAULT4,
+    VEC_DEFAULT4, VEC_DEFAULT
+};
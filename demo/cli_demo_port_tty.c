@@ -0,0 +1,311 @@
+/*
+ * @file cli_demo_port_tty.c
+ * @brief 平台抽象层实现 (Linux 串口设备)
+ *
+ * 控制台为串口设备而不是标准输入，参数由环境变量给出：
+ *   CLI_TTY_DEVICE   设备路径，默认 /dev/ttyUSB0；为 "pty" 时用 openpty 新建
+ *                    伪终端对，从端路径打印到 stderr，便于在本机测试
+ *   CLI_TTY_BAUD     波特率，默认 115200
+ *   CLI_TTY_VMIN     termios VMIN，默认 0
+ *   CLI_TTY_VTIME    termios VTIME（0.1s），默认 0
+ *   CLI_TTY_RTSCTS   非0时启用硬件流控
+ *
+ * 设备以原始模式打开，并尽量降低驱动侧延迟（ASYNC_LOW_LATENCY、
+ * FTDI latency_timer）。读取一次取出所有可读字节；输出先进入缓冲区，
+ * 在等待输入前或缓冲区满时一次写出，部分写入时继续写剩余部分。
+ */
+
+#include "cli_port.h"
+#include <cli_timer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+/* 输入、输出缓冲区大小 */
+#ifndef TTY_RX_BUF_SIZE
+#define TTY_RX_BUF_SIZE         256
+#endif
+#ifndef TTY_TX_BUF_SIZE
+#define TTY_TX_BUF_SIZE         4096
+#endif
+
+/* 空闲时等待输入的最长时间，保证后台轮询的节拍 */
+#define TTY_IDLE_TIMEOUT_MS     1
+
+static struct
+{
+    int fd;
+    int pty_slave;              /* 自建伪终端时的从端，否则为 -1 */
+    struct termios saved;
+    int saved_valid;
+    unsigned char rx[TTY_RX_BUF_SIZE];
+    size_t rx_pos;
+    size_t rx_len;
+    char tx[TTY_TX_BUF_SIZE];
+    size_t tx_len;
+} s_tty = { .fd = -1, .pty_slave = -1 };
+
+/* 波特率到 termios 常量 */
+static speed_t tty_speed(unsigned long baud)
+{
+    static const struct
+    {
+        unsigned long baud;
+        speed_t speed;
+    } table[] = {
+        { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+        { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+        { 500000, B500000 }, { 576000, B576000 }, { 921600, B921600 },
+        { 1000000, B1000000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+        { 3000000, B3000000 }, { 4000000, B4000000 },
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    {
+        if (table[i].baud == baud)
+        {
+            return table[i].speed;
+        }
+    }
+    return 0;
+}
+
+static unsigned long tty_env(const char *name, unsigned long def)
+{
+    const char *v = getenv(name);
+    return (v != NULL && *v != '\0') ? strtoul(v, NULL, 0) : def;
+}
+
+/* 降低驱动延迟：失败（如伪终端、非 FTDI 设备）时忽略 */
+static void tty_low_latency(const char *path)
+{
+    struct serial_struct ss;
+    const char *name = strrchr(path, '/');
+    char sysfs[128];
+    int fd;
+
+    if (ioctl(s_tty.fd, TIOCGSERIAL, &ss) == 0)
+    {
+        ss.flags |= ASYNC_LOW_LATENCY;
+        ioctl(s_tty.fd, TIOCSSERIAL, &ss);
+    }
+
+    /* FTDI 芯片默认每 16ms 才上报一次，改为 1ms */
+    name = (name != NULL) ? name + 1 : path;
+    snprintf(sysfs, sizeof(sysfs), "/sys/bus/usb-serial/devices/%s/latency_timer", name);
+    fd = open(sysfs, O_WRONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        if (write(fd, "1", 1) != 1)
+        {
+            /* 没有权限时保持默认值 */
+        }
+        close(fd);
+    }
+}
+
+/* 写出全部数据，处理部分写入和 EAGAIN */
+static void tty_write_all(const char *buf, size_t len)
+{
+    while (len > 0 && s_tty.fd >= 0)
+    {
+        ssize_t n = write(s_tty.fd, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN)
+            {
+                struct pollfd pfd = { .fd = s_tty.fd, .events = POLLOUT };
+                poll(&pfd, 1, -1);
+                continue;
+            }
+            break;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+static void tty_flush(void)
+{
+    if (s_tty.tx_len > 0)
+    {
+        tty_write_all(s_tty.tx, s_tty.tx_len);
+        s_tty.tx_len = 0;
+    }
+}
+
+void platform_init(void)
+{
+    const char *path = getenv("CLI_TTY_DEVICE");
+    unsigned long baud = tty_env("CLI_TTY_BAUD", 115200);
+    speed_t speed = tty_speed(baud);
+    struct termios t;
+    int cfg_fd;
+
+    if (path == NULL || *path == '\0')
+    {
+        path = "/dev/ttyUSB0";
+    }
+    if (speed == 0)
+    {
+        fprintf(stderr, "cli_demo: unsupported baud rate %lu\n", baud);
+        exit(1);
+    }
+
+    if (strcmp(path, "pty") == 0)
+    {
+        char name[64];
+        if (openpty(&s_tty.fd, &s_tty.pty_slave, name, NULL, NULL) != 0)
+        {
+            perror("cli_demo: openpty");
+            exit(1);
+        }
+        /* 从端保持打开，对端断开后读取不会返回 EIO */
+        fprintf(stderr, "cli_demo: console on %s\n", name);
+    }
+    else
+    {
+        /* O_NONBLOCK 避免在等待 DCD 时阻塞，打开后恢复阻塞写 */
+        s_tty.fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (s_tty.fd < 0)
+        {
+            fprintf(stderr, "cli_demo: %s: %s\n", path, strerror(errno));
+            exit(1);
+        }
+        fcntl(s_tty.fd, F_SETFL, fcntl(s_tty.fd, F_GETFL) & ~O_NONBLOCK);
+    }
+
+    /* 伪终端的线路规程在从端 */
+    cfg_fd = (s_tty.pty_slave >= 0) ? s_tty.pty_slave : s_tty.fd;
+    if (tcgetattr(cfg_fd, &t) == 0)
+    {
+        s_tty.saved = t;
+        s_tty.saved_valid = 1;
+        cfmakeraw(&t);
+        t.c_cflag |= CLOCAL | CREAD;
+        if (tty_env("CLI_TTY_RTSCTS", 0) != 0)
+        {
+            t.c_cflag |= CRTSCTS;
+        }
+        else
+        {
+            t.c_cflag &= ~CRTSCTS;
+        }
+        t.c_cc[VMIN] = (cc_t)tty_env("CLI_TTY_VMIN", 0);
+        t.c_cc[VTIME] = (cc_t)tty_env("CLI_TTY_VTIME", 0);
+        cfsetispeed(&t, speed);
+        cfsetospeed(&t, speed);
+        if (tcsetattr(cfg_fd, TCSANOW, &t) != 0)
+        {
+            perror("cli_demo: tcsetattr");
+        }
+        tcflush(cfg_fd, TCIFLUSH);
+    }
+    if (s_tty.pty_slave < 0)
+    {
+        tty_low_latency(path);
+    }
+}
+
+void platform_cleanup(void)
+{
+    if (s_tty.fd >= 0)
+    {
+        tty_flush();
+        if (s_tty.saved_valid && s_tty.pty_slave < 0)
+        {
+            tcsetattr(s_tty.fd, TCSADRAIN, &s_tty.saved);
+        }
+        close(s_tty.fd);
+        s_tty.fd = -1;
+        if (s_tty.pty_slave >= 0)
+        {
+            close(s_tty.pty_slave);
+            s_tty.pty_slave = -1;
+        }
+    }
+}
+
+int platform_getchar(void)
+{
+    if (s_tty.rx_pos == s_tty.rx_len)
+    {
+        ssize_t n;
+
+        /* 等待输入前先把已生成的输出写出 */
+        tty_flush();
+        n = read(s_tty.fd, s_tty.rx, sizeof(s_tty.rx));
+        if (n <= 0)
+        {
+            return -1;
+        }
+        s_tty.rx_pos = 0;
+        s_tty.rx_len = (size_t)n;
+    }
+    return s_tty.rx[s_tty.rx_pos++];
+}
+
+void platform_write(const char *buf, size_t len)
+{
+    if (len >= sizeof(s_tty.tx))
+    {
+        /* 大块数据直接写出 */
+        tty_flush();
+        tty_write_all(buf, len);
+        return;
+    }
+    if (s_tty.tx_len + len > sizeof(s_tty.tx))
+    {
+        tty_flush();
+    }
+    memcpy(s_tty.tx + s_tty.tx_len, buf, len);
+    s_tty.tx_len += len;
+}
+
+void platform_putchar(char c)
+{
+    platform_write(&c, 1);
+}
+
+void platform_puts(const char *s)
+{
+    platform_write(s, strlen(s));
+}
+
+uint32_t platform_get_tick_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+void platform_set_binary(int enable)
+{
+    /* 设备已是原始模式，切换前写出缓冲的文本即可 */
+    (void)enable;
+    tty_flush();
+}
+
+void platform_idle(void)
+{
+    struct pollfd pfd = { .fd = s_tty.fd, .events = POLLIN };
+
+    tty_flush();
+    if (s_tty.rx_pos == s_tty.rx_len)
+    {
+        /* 有输入或有定时器已到期时立即返回，否则最多等待一个节拍 */
+        poll(&pfd, 1, (cli_timer_next_expiry() == 0) ? 0 : TTY_IDLE_TIMEOUT_MS);
+    }
+}
@@ -19,11 +19,14 @@
 #include <sys/select.h>
 #include <sys/time.h>
 #include <signal.h>
+#include <time.h>
+#include <errno.h>
 #endif
 
 /* 静态变量，用于Linux恢复终端 */
 #if defined(__linux__) || defined(__unix__)
 static struct termios s_orig_termios;
+static struct termios s_cli_termios;
 static int s_termios_modified = 0;
 #endif
 
@@ -77,6 +80,7 @@ void platform_init(void)
         new_termios.c_cc[VTIME] = 0;
         if (tcsetattr(STDIN_FILENO, TCSANOW, &new_termios) == 0)
         {
+            s_cli_termios = new_termios;
             s_termios_modified = 1;
         }
     }
@@ -179,3 +183,77 @@ void platform_puts(const char *s)
         platform_putchar(*s++);
     }
 }
+
+void platform_write(const char *buf, size_t len)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    fwrite(buf, 1, len, stdout);
+    fflush(stdout);
+#elif defined(__linux__) || defined(__unix__)
+    /* 处理部分写入，直到整块数据写完 */
+    while (len > 0)
+    {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            break;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+#endif
+}
+
+uint32_t platform_get_tick_ms(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return (uint32_t)GetTickCount();
+#elif defined(__linux__) || defined(__unix__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+#else
+    return 0;
+#endif
+}
+
+void platform_set_binary(int enable)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    (void)enable;
+#elif defined(__linux__) || defined(__unix__)
+    struct termios raw;
+    if (!s_termios_modified)
+    {
+        return;
+    }
+    if (enable)
+    {
+        /* 原始模式：不转换 CR/LF，不处理 XON/XOFF 和 Ctrl-C 等信号字符 */
+        raw = s_cli_termios;
+        raw.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF);
+        raw.c_oflag &= ~OPOST;
+        raw.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+        raw.c_cflag &= ~(CSIZE | PARENB);
+        raw.c_cflag |= CS8;
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSADRAIN, &raw);
+    }
+    else
+    {
+        tcsetattr(STDIN_FILENO, TCSADRAIN, &s_cli_termios);
+    }
+#else
+    (void)enable;
+#endif
+}
+
+void platform_idle(void)
+{
+    /* PC 上保持忙轮询，不做等待 */
+}
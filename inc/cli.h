@@ -7,6 +7,7 @@
 #define CLI_H
 
 #include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint32_t */
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,13 +18,39 @@ extern "C" {
 #define CLI_MAX_COMMANDS 16
 #endif
 
+/* 最大后台轮询函数数 */
+#ifndef CLI_MAX_POLLS
+#define CLI_MAX_POLLS 4
+#endif
+
+/*
+ * 帮助文本压缩存储（见 cli_help.h）：为1时 CLI_HELP("...") 展开为 NULL，
+ * 文本由构建时从源码提取、压缩生成的 cli_help_data.c 提供。
+ * 命令定义中的帮助文本应写作 .help = CLI_HELP("...")。
+ */
+#ifndef CLI_HELP_COMPRESSED
+#define CLI_HELP_COMPRESSED 0
+#endif
+
+#if CLI_HELP_COMPRESSED
+#define CLI_HELP(s) NULL
+#else
+#define CLI_HELP(s) s
+#endif
+
 /* 错误码定义 */
 typedef enum
 {
     CLI_SUCCESS = 0,                /* 成功 */
     CLI_ERR_INVALID_PARAM = -1,      /* 无效参数 */
     CLI_ERR_TABLE_FULL = -2,         /* 命令表已满 */
-    CLI_ERR_DUPLICATE = -3           /* 命令名重复 */
+    CLI_ERR_DUPLICATE = -3,          /* 命令名重复 */
+    CLI_ERR_NOT_FOUND = -4,          /* 对象不存在 */
+    CLI_ERR_RANGE = -5,              /* 数值超出范围 */
+    CLI_ERR_READONLY = -6,           /* 对象只读 */
+    CLI_ERR_NO_SPACE = -7,           /* 存储空间不足 */
+    CLI_ERR_IO = -8,                 /* 底层读写失败 */
+    CLI_ERR_BUSY = -9                /* 超出限额，稍后重试 */
 } cli_error_t;
 
 /* IO接口结构体 */
@@ -32,8 +59,25 @@ typedef struct
     int  (*getchar)(void);          /* 非阻塞获取字符，返回-1表示无字符 */
     void (*putchar)(char c);         /* 输出字符 */
     void (*puts)(const char *s);     /* 输出字符串 */
+    void (*write)(const char *buf, size_t len); /* 批量输出（可含'\0'），可为NULL，为NULL时逐字符输出 */
+    uint32_t (*get_tick_ms)(void);   /* 单调毫秒时钟，可为NULL（无时间基准） */
+    void (*set_binary)(int enable);  /* 切换二进制透明传输（关闭换行转换/流控/信号字符），可为NULL */
 } cli_io_t;
 
+/* 输出过滤器：安装后所有 cli_putchar/cli_puts/cli_write 输出都交由它处理 */
+typedef void (*cli_output_filter_t)(const char *buf, size_t len);
+
+/* 输入接管函数：返回后字符不再进入行编辑器 */
+typedef void (*cli_input_hook_t)(char c);
+
+/* 输出模式：文本供人阅读，CSV/JSON 供脚本解析（表格、样式等模块据此切换） */
+typedef enum
+{
+    CLI_MODE_TEXT,
+    CLI_MODE_CSV,
+    CLI_MODE_JSON
+} cli_output_mode_t;
+
 /* 命令结构体定义 */
 typedef struct cli_command
 {
@@ -55,10 +99,14 @@ int cli_get_command_count(void);
 /* 根据索引获取命令结构体指针，索引范围 0 ~ cli_get_command_count()-1，返回NULL表示无效索引 */
 const cli_command_t* cli_get_command_dsc(int index);
 
-/* 定时处理函数（通常在主循环中调用），处理输入字符 */
+/* 定时处理函数（通常在主循环中调用），处理输入字符、到期的定时器（cli_timer.h）和后台轮询 */
 void cli_ticks_handler(void);
 
-/* 处理单个字符（如果外部直接提供字符，也可以调用此函数） */
+/*
+ * 处理单个字符（如果外部直接提供字符，也可以调用此函数）。
+ * 一行可用 ; && || 连接多条命令（引号内不算），如 "led 1 on && led 2 on; version"，
+ * && / || 按上一条处理函数的返回值是否为0短路；整行作为一条历史记录。
+ */
 void cli_process_char(char c);
 
 /* 输出字符（供命令处理函数使用） */
@@ -67,7 +115,112 @@ void cli_putchar(char c);
 /* 输出字符串（供命令处理函数使用） */
 void cli_puts(const char *s);
 
-/* 格式化输出（支持 %d, %u, %x, %s, %c, %%），通过 cli_putchar 逐字符输出 */
+/* 批量输出一段数据（可包含'\0'），优先使用 io->write 一次写出 */
+void cli_write(const char *buf, size_t len);
+
+/* 绕过输出过滤器直接写端口（供过滤器自身输出使用） */
+void cli_write_raw(const char *buf, size_t len);
+
+/* 旁路记录的方向 */
+typedef enum
+{
+    CLI_TAP_INPUT,              /* 执行的整行命令（不含换行） */
+    CLI_TAP_OUTPUT              /* 命令和异步输出（不含行编辑回显和提示符），在输出过滤器之前 */
+} cli_tap_dir_t;
+
+/* 旁路记录函数（会话记录、审计），不改变输出 */
+typedef void (*cli_tap_t)(cli_tap_dir_t dir, const char *buf, size_t len);
+
+/* 安装/移除（传NULL）旁路记录 */
+void cli_set_tap(cli_tap_t tap);
+
+/* 安装/移除（传NULL）输出过滤器 */
+void cli_set_output_filter(cli_output_filter_t filter);
+
+/* 登记一次性回调，在下一次 cli_putchar/cli_puts/cli_write 输出前执行（用于合并延迟输出） */
+void cli_defer_output(void (*fn)(void));
+
+/* 设置/获取输出模式 */
+void cli_set_output_mode(cli_output_mode_t mode);
+cli_output_mode_t cli_get_output_mode(void);
+
+/* 切换二进制透明传输模式（文件传输、二进制遥测帧使用） */
+void cli_set_binary(int enable);
+
+/* 获取单调毫秒时钟，端口未提供时恒为0 */
+uint32_t cli_get_tick_ms(void);
+
+/* 端口是否提供了毫秒时钟（依赖计时的功能据此拒绝启动） */
+int cli_has_clock(void);
+
+/* 注册后台轮询函数，由 cli_ticks_handler 每次调用 */
+cli_error_t cli_poll_register(void (*poll)(void));
+
+/* 接管输入：之后收到的字符交由 hook 处理，命令返回后不再显示提示符 */
+void cli_input_acquire(cli_input_hook_t hook);
+
+/* 释放输入接管，恢复行编辑并重新显示提示符 */
+void cli_input_release(void);
+
+/* 输入是否被命令接管（接管期间不应插入异步输出） */
+int cli_input_is_acquired(void);
+
+/*
+ * 在主循环中（命令之外）输出异步内容，如事件通知：begin 清除正在编辑的行，
+ * end 重新显示提示符和已输入的内容。begin 可重复调用，只在第一次清除。
+ */
+void cli_async_begin(void);
+void cli_async_end(void);
+
+/*
+ * 自动化模式：不回显输入、不显示提示符、不记录历史，供脚本连续写入多行命令。
+ * 任何模式下以 "@标记 " 开头的行，其响应前后各输出一行：
+ *   @@begin 标记
+ *   ...命令输出...
+ *   @@end 标记 返回码
+ * 返回码为处理函数的返回值，未知命令为 CLI_ERR_NOT_FOUND；命令接管输入时
+ * （如 stream、rx），结束标记在释放输入时输出，期间的输入交给该命令。
+ */
+void cli_set_automation(int enable);
+int cli_get_automation(void);
+
+/* auto [on|off]：查看或切换自动化模式 */
+extern const cli_command_t cli_automation_cmd;
+
+/*
+ * 命令限额：一个令牌桶限制每秒执行的命令数，另一个限制处理函数在每个窗口内
+ * 的累计耗时，避免脚本洪泛时 CLI 占满与应用共用的主循环。每条命令分派前
+ * 检查，超限时不执行，输出 "Rate limited" 或 "CPU budget exhausted" 及重试
+ * 等待时间，返回码为 CLI_ERR_BUSY，同一行中其后的命令也不再执行。
+ * 处理函数的执行时间按 cli_bench_set_counter 提供的高精度计数器计算（未提供时
+ * 按毫秒时钟，不足1毫秒的命令可能计为0），超出预算的部分在之后的窗口中扣回。
+ */
+typedef struct
+{
+    uint16_t rate;              /* 每秒命令数，0 表示不限 */
+    uint16_t burst;             /* 可连续执行的命令数（桶容量），0 时等于 rate */
+    uint16_t cpu_ms;            /* 每个窗口内处理函数的累计耗时上限，0 表示不限 */
+    uint16_t window_ms;         /* 耗时预算的窗口，0 时为1000 */
+} cli_limit_t;
+
+/* 设置限额（NULL 为不限，桶重新装满）；需要端口提供 get_tick_ms，否则返回 CLI_ERR_IO */
+cli_error_t cli_set_limits(const cli_limit_t *limits);
+void cli_get_limits(cli_limit_t *limits);
+
+/*
+ * limit                            显示限额和拒绝计数
+ * limit rate <每秒> [突发]          限制命令速率（0 为不限）
+ * limit cpu <时长> [窗口]           限制处理函数耗时，如 "limit cpu 200ms 1s"
+ * limit off                        取消所有限额
+ */
+extern const cli_command_t cli_limit_cmd;
+
+/*
+ * 格式化输出（支持 %d, %u, %x, %s, %c, %%，%ld/%lu/%lx 读取 long），不支持宽度
+ * 和标志。文字和整数逐字符经 cli_putchar 输出，浮点转换的结果经 cli_write 整段
+ * 输出。CLI_PRINTF_FLOAT 启用时另支持 %f/%e/%g（可带 .N 或 .* 精度，大写形式
+ * 同理，%lf 等同 %f）；不带精度的 %g 输出最短往返表示，例如 0.1f 输出 "0.1"。
+ */
 void cli_printf(const char *format, ...);
 
 #ifdef __cplusplus
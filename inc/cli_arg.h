@@ -0,0 +1,69 @@
+/*
+ * @file cli_arg.h
+ * @brief 命令参数解析：统一的数值/开关/枚举/大小/时长解析与错误提示
+ *
+ * 所有函数作用于 (ptr, len)，不依赖 locale 和 errno，整串必须完整匹配。
+ * 整数可写为十进制或 0x 前缀的十六进制（不识别八进制，"010" 即10）。
+ * 返回 CLI_SUCCESS、CLI_ERR_INVALID_PARAM（格式错误）或 CLI_ERR_RANGE
+ * （超出范围），失败时 *out 不变，可随后调用 cli_arg_report 输出提示。
+ *
+ *   uint32_t id;
+ *   if (cli_arg_u32(CLI_ARG(argv[1]), 0, 3, &id) != CLI_SUCCESS)
+ *   {
+ *       cli_arg_report("led", CLI_ARG(argv[1]));
+ *       return -1;
+ *   }
+ */
+
+#ifndef CLI_ARG_H
+#define CLI_ARG_H
+
+#include <cli.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 以 NUL 结尾的字符串（如 argv[i]）展开为 ptr, len */
+#define CLI_ARG(s)              (s), strlen(s)
+
+/* 无符号32位整数，范围 [min, max] */
+cli_error_t cli_arg_u32(const char *s, size_t len, uint32_t min, uint32_t max, uint32_t *out);
+
+/* 无符号64位整数，范围 [min, max] */
+cli_error_t cli_arg_u64(const char *s, size_t len, uint64_t min, uint64_t max, uint64_t *out);
+
+/* 有符号64位整数，范围 [min, max] */
+cli_error_t cli_arg_i64(const char *s, size_t len, int64_t min, int64_t max, int64_t *out);
+
+/* 十六进制（0x 前缀可省略），不超过 max */
+cli_error_t cli_arg_hex(const char *s, size_t len, uint64_t max, uint64_t *out);
+
+/* 开关：on/off、true/false、yes/no、enable/disable、1/0，不区分大小写 */
+cli_error_t cli_arg_bool(const char *s, size_t len, bool *out);
+
+/* 枚举：完全匹配或唯一前缀匹配 names[0..count)，输出下标 */
+cli_error_t cli_arg_enum(const char *s, size_t len, const char *const *names, int count, int *out);
+
+/* 字节数：整数后可跟 k/K、M、G（1024进制）及可选的 B，范围 [min, max] */
+cli_error_t cli_arg_size(const char *s, size_t len, uint64_t min, uint64_t max, uint64_t *out);
+
+/* 时长：数值后跟 ms（默认）、s、m、h，s/m/h 可带小数（如 1.5s），输出毫秒 */
+cli_error_t cli_arg_duration(const char *s, size_t len, uint32_t min_ms, uint32_t max_ms, uint32_t *out_ms);
+
+/*
+ * 单精度浮点：[+-]数字[.数字][e[+-]数字]，只接受十进制，与区域设置无关，
+ * 不接受 nan/inf 和十六进制浮点，超出单精度范围时失败
+ */
+cli_error_t cli_arg_float(const char *s, size_t len, float *out);
+
+/* 按最近一次失败的解析输出统一格式的错误提示，what 为参数名 */
+void cli_arg_report(const char *what, const char *s, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_ARG_H */
@@ -0,0 +1,78 @@
+/*
+ * @file cli_audit.h
+ * @brief 会话审计记录（仅 Linux 主机构建）：命令行和命令输出写入日志文件
+ *
+ * 通过 cli_set_tap 取得执行的命令行和输出，在 CLI 线程中只复制到无锁环形
+ * 缓冲区；独立的写线程负责格式化并批量追加到文件（O_APPEND，每次 write 只含
+ * 完整的行，多个进程可共用同一个文件）。磁盘阻塞导致缓冲区满时丢弃新数据并
+ * 计数，日志中记一行丢弃的字节数，CLI 线程从不等待。
+ *
+ * 日志每行格式：
+ *   2026-01-02T03:04:05.678Z <会话> > 命令行
+ *   2026-01-02T03:04:05.679Z <会话> < 输出的一行（控制字符写作 \xHH）
+ *   2026-01-02T03:04:05.680Z <会话> ! dropped N bytes
+ *   2026-01-02T03:04:05.600Z <会话> * start | stop
+ */
+
+#ifndef CLI_AUDIT_H
+#define CLI_AUDIT_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__linux__)
+
+/* 环形缓冲区大小（2的幂） */
+#ifndef CLI_AUDIT_RING_SIZE
+#define CLI_AUDIT_RING_SIZE     (1u << 20)
+#endif
+
+/* 写线程最长等待时间，超时后写出已有数据 */
+#ifndef CLI_AUDIT_FLUSH_MS
+#define CLI_AUDIT_FLUSH_MS      200
+#endif
+
+/* 统计信息 */
+typedef struct
+{
+    bool active;
+    uint64_t records;           /* 已记录的命令行和输出段数 */
+    uint64_t bytes;             /* 进入缓冲区的字节数 */
+    uint64_t written;           /* 写入文件的字节数（格式化后） */
+    uint64_t dropped;           /* 缓冲区满丢弃的字节数 */
+    uint64_t write_errors;      /* 写文件失败次数 */
+} cli_audit_stats_t;
+
+/* 初始化（需在 cli_init 之后调用，注册后台轮询） */
+void cli_audit_init(void);
+
+/*
+ * 开始记录：path 中的 "%p" 替换为进程号；session 为日志中的会话名，
+ * NULL 时使用进程号。已在记录时先停止。
+ */
+cli_error_t cli_audit_start(const char *path, const char *session);
+
+/* 停止记录，写出剩余数据后返回 */
+void cli_audit_stop(void);
+
+/* 获取统计信息 */
+void cli_audit_get_stats(cli_audit_stats_t *stats);
+
+/*
+ * audit                       显示状态
+ * audit start <path> [name]   开始记录
+ * audit stop                  停止记录
+ */
+extern const cli_command_t cli_audit_cmd;
+
+#endif /* __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_AUDIT_H */
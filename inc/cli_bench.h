@@ -0,0 +1,95 @@
+/*
+ * @file cli_bench.h
+ * @brief 设备端微基准：模块登记基准函数，bench 命令自动标定迭代次数并计时
+ *
+ * 基准函数执行被测操作 n 次（循环写在函数内，不计每次调用的开销）：
+ *
+ *   static void bench_crc(uint32_t n)
+ *   {
+ *       while (n--)
+ *       {
+ *           cli_bench_sink += crc16(buf, sizeof(buf));
+ *       }
+ *   }
+ *   ...
+ *   CLI_BENCH(crc16_64, bench_crc);     // 在初始化函数中登记，名称为 "crc16_64"
+ *
+ * 运行时先预热 CLI_BENCH_WARMUP_MS，再从 n=1 起按上一轮耗时推算 n，直到一轮
+ * 不短于目标时长，之后以该 n 重复测量若干轮取最快一轮，输出 ns/op 和 ops/s。
+ * 计时默认使用毫秒时钟，端口可用 cli_bench_set_counter 提供周期计数器等
+ * 高精度计数器。测量在命令中同步进行，期间主循环暂停。
+ */
+
+#ifndef CLI_BENCH_H
+#define CLI_BENCH_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 可登记的基准数 */
+#ifndef CLI_BENCH_MAX
+#define CLI_BENCH_MAX           16
+#endif
+
+/* 每轮测量的默认目标时长 */
+#ifndef CLI_BENCH_TARGET_MS
+#define CLI_BENCH_TARGET_MS     200
+#endif
+
+/* 预热时长 */
+#ifndef CLI_BENCH_WARMUP_MS
+#define CLI_BENCH_WARMUP_MS     20
+#endif
+
+/* 默认测量轮数 */
+#ifndef CLI_BENCH_RUNS
+#define CLI_BENCH_RUNS          3
+#endif
+
+/* 基准函数：执行被测操作 n 次 */
+typedef void (*cli_bench_fn_t)(uint32_t n);
+
+/* 登记基准，名称重复返回 CLI_ERR_DUPLICATE，表满返回 CLI_ERR_TABLE_FULL */
+cli_error_t cli_bench_register(const char *name, cli_bench_fn_t fn);
+
+/* 登记基准，name 为标识符（不加引号） */
+#define CLI_BENCH(name, fn)     cli_bench_register(#name, (fn))
+
+/*
+ * 设置计时用的计数器：read 返回32位回绕的计数值，hz 为每秒计数数。
+ * read 为 NULL 时恢复使用 cli_get_tick_ms（1000Hz）。
+ */
+void cli_bench_set_counter(uint32_t (*read)(void), uint32_t hz);
+
+/* 读取计时计数器的当前值（未设置时为 cli_get_tick_ms），hz 非NULL时返回每秒计数数 */
+uint32_t cli_bench_counter(uint32_t *hz);
+
+/* 测量结果 */
+typedef struct
+{
+    uint32_t iterations;        /* 每轮迭代次数 */
+    uint32_t runs;              /* 测量轮数 */
+    uint64_t best_ns;           /* 最快一轮的耗时 */
+    uint64_t total_ns;          /* 所有测量轮的总耗时 */
+} cli_bench_result_t;
+
+/* 运行一个基准（target_ms 为0时使用默认值），返回 CLI_ERR_NOT_FOUND 表示未登记 */
+cli_error_t cli_bench_run(const char *name, uint32_t target_ms, uint32_t runs, cli_bench_result_t *result);
+
+/* 基准函数可把结果累加到这里，防止被测代码被编译器优化掉 */
+extern volatile uint32_t cli_bench_sink;
+
+/*
+ * bench                            列出已登记的基准
+ * bench <name|all> [-t 时长] [-r 轮数]   运行并输出迭代次数、ns/op 和 ops/s
+ */
+extern const cli_command_t cli_bench_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_BENCH_H */
@@ -0,0 +1,52 @@
+/*
+ * @file cli_diag.h
+ * @brief 进程诊断命令（仅 Linux 主机构建）：线程、内存、文件描述符、主循环
+ *
+ * 数据直接读取 /proc/self 下的文件（每个文件一次 read），结果经 cli_table 输出，
+ * 随 format 命令切换文本/CSV/JSON。
+ */
+
+#ifndef CLI_DIAG_H
+#define CLI_DIAG_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__linux__)
+
+/* 主循环统计 */
+typedef struct
+{
+    uint64_t iterations;        /* 累计轮询次数 */
+    double rate;                /* 最近一个统计窗口的轮询频率（次/秒） */
+    uint64_t lag_us;            /* 最近一个窗口内相邻两次轮询的最大间隔 */
+    uint64_t worst_us;          /* 启动（或复位）以来的最大间隔 */
+} cli_diag_loop_stats_t;
+
+/* 初始化（需在 cli_init 之后调用，注册后台轮询用于主循环统计） */
+void cli_diag_init(void);
+
+/* 获取主循环统计 */
+void cli_diag_get_loop_stats(cli_diag_loop_stats_t *stats);
+
+/*
+ * ps                  线程列表：tid、名称、状态、用户态/内核态 CPU 时间
+ * mem                 RSS、虚拟内存和 malloc 统计
+ * fds                 打开的文件描述符及其目标
+ * loop [reset]        主循环频率和最大延迟
+ */
+extern const cli_command_t cli_diag_ps_cmd;
+extern const cli_command_t cli_diag_mem_cmd;
+extern const cli_command_t cli_diag_fds_cmd;
+extern const cli_command_t cli_diag_loop_cmd;
+
+#endif /* __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_DIAG_H */
@@ -0,0 +1,97 @@
+/*
+ * @file cli_event.h
+ * @brief 事件发布/订阅：应用发布命名事件，订阅者按通配模式接收，高频事件合并投递
+ *
+ * 事件名建议用 '.' 分级，如 "link.eth0.up"、"temp.cpu.high"；模式支持
+ * '*'（任意长度）和 '?'（单个字符）。每个事件名首次发布时登记到索引表，
+ * 同时算出匹配它的订阅者集合，之后发布只需一次查表；订阅变化时重建索引。
+ *
+ * 投递在后台轮询中进行，每个订阅者两次投递至少间隔 CLI_EVENT_INTERVAL_MS，
+ * 期间同名事件只保留最新值并计数（latest wins）。
+ * 命令行会话本身也是一个订阅者（subscribe 命令），命令接管输入时暂停投递。
+ */
+
+#ifndef CLI_EVENT_H
+#define CLI_EVENT_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 订阅者数（不超过32） */
+#ifndef CLI_EVENT_MAX_SUBS
+#define CLI_EVENT_MAX_SUBS      4
+#endif
+
+/* 所有订阅者的模式总数 */
+#ifndef CLI_EVENT_MAX_PATTERNS
+#define CLI_EVENT_MAX_PATTERNS  8
+#endif
+
+/* 索引表可登记的不同事件名数（2的幂），满后新事件名的发布被丢弃 */
+#ifndef CLI_EVENT_MAX_NAMES
+#define CLI_EVENT_MAX_NAMES     32
+#endif
+
+/* 事件名/模式最大长度（含终止符） */
+#ifndef CLI_EVENT_NAME_LEN
+#define CLI_EVENT_NAME_LEN      24
+#endif
+
+/* 事件值最大长度（含终止符），超出部分截断 */
+#ifndef CLI_EVENT_VALUE_LEN
+#define CLI_EVENT_VALUE_LEN     24
+#endif
+
+/* 同一订阅者两次投递的最小间隔 */
+#ifndef CLI_EVENT_INTERVAL_MS
+#define CLI_EVENT_INTERVAL_MS   200
+#endif
+
+/* 投递函数：count 为自上次投递以来该事件发布的次数，value 为最新值 */
+typedef void (*cli_event_handler_t)(const char *name, const char *value, uint32_t count, void *ctx);
+
+/* 统计信息 */
+typedef struct
+{
+    uint32_t published;         /* 发布次数 */
+    uint32_t delivered;         /* 投递次数（合并后） */
+    uint32_t coalesced;         /* 被合并掉的次数 */
+    uint32_t dropped;           /* 索引表满而丢弃的发布 */
+    uint32_t names;             /* 已登记的事件名数 */
+} cli_event_stats_t;
+
+/* 初始化（需在 cli_init 之后调用，注册后台轮询） */
+void cli_event_init(void);
+
+/* 发布事件，value 可为 NULL（主循环上下文，不可在中断中调用） */
+void cli_event_publish(const char *name, const char *value);
+
+/*
+ * 订阅：handler 和 ctx 相同的订阅视为同一订阅者，可添加多个模式。
+ * 返回 CLI_ERR_DUPLICATE（模式已存在）、CLI_ERR_TABLE_FULL 或 CLI_ERR_INVALID_PARAM。
+ */
+cli_error_t cli_event_subscribe(const char *pattern, cli_event_handler_t handler, void *ctx);
+
+/* 取消订阅，pattern 为 NULL 时取消该订阅者的所有模式 */
+cli_error_t cli_event_unsubscribe(const char *pattern, cli_event_handler_t handler, void *ctx);
+
+/* 获取统计信息 */
+void cli_event_get_stats(cli_event_stats_t *stats);
+
+/*
+ * subscribe                   列出会话的订阅和统计
+ * subscribe <pattern>         会话订阅匹配的事件
+ * unsubscribe [pattern]       取消会话的订阅（不带参数时全部取消）
+ * 交互模式输出 "[event] 名称 = 值 (xN)"，自动化模式输出 "@@event 名称 N 值"。
+ */
+extern const cli_command_t cli_event_subscribe_cmd;
+extern const cli_command_t cli_event_unsubscribe_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_EVENT_H */
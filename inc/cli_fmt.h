@@ -0,0 +1,41 @@
+/*
+ * @file cli_fmt.h
+ * @brief 浮点数格式化（不依赖 libc printf）
+ *
+ * 最短往返表示使用 Grisu2 算法：输出的数字串按同一精度解析回来与原值相等，
+ * 且绝大多数情况下是最短的。指定精度的 %f 在精度不超过6、数值不大时走
+ * 定点快速路径（一次乘法加64位整数运算）；其余情况基于最短数字串舍入。
+ * 依赖严格的 IEEE 双精度求值，不能用 -ffast-math 编译。
+ */
+
+#ifndef CLI_FMT_H
+#define CLI_FMT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 输出缓冲区最小长度（含终止符） */
+#define CLI_FMT_DOUBLE_MAX      48
+#define CLI_FMT_FLOAT_MAX       20
+
+/* 最大精度，超出部分按此截断（更多位数没有意义） */
+#define CLI_FMT_PREC_MAX        17
+
+/*
+ * 按 conv（'f'/'e'/'g'，大写形式输出大写 E/INF/NAN）格式化 v，返回长度。
+ * prec 小于0时：'f'/'e' 取6；'g' 输出最短往返表示。
+ * %f 的整数部分超过17位时改用指数形式。
+ */
+size_t cli_fmt_double(char *out, double v, char conv, int prec);
+
+/* 按单精度输出最短往返表示（如 0.1f 输出 "0.1"），返回长度 */
+size_t cli_fmt_float(char *out, float v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_FMT_H */
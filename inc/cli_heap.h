@@ -0,0 +1,69 @@
+/*
+ * @file cli_heap.h
+ * @brief 堆分配分析（Linux/glibc 主机构建，可选）
+ *
+ * 启用 CLI_HEAP_PROFILE 后替换 malloc/calloc/realloc/free，按调用点（返回地址）
+ * 统计分配次数、字节数和存活分配。未开始采集时每次调用只多一次分支判断；
+ * 采集时的计数表和存活分配表均为无锁哈希表，多线程下不加锁。
+ * aligned_alloc/posix_memalign 等分配不被统计，其释放不受影响。
+ */
+
+#ifndef CLI_HEAP_H
+#define CLI_HEAP_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 是否编译堆分配分析（由构建系统定义） */
+#ifndef CLI_HEAP_PROFILE
+#define CLI_HEAP_PROFILE        0
+#endif
+
+#if CLI_HEAP_PROFILE
+
+/* 调用点计数表容量（2的幂） */
+#ifndef CLI_HEAP_SITES
+#define CLI_HEAP_SITES          1024
+#endif
+
+/* 存活分配表容量（2的幂），超出的分配不跟踪 */
+#ifndef CLI_HEAP_LIVE
+#define CLI_HEAP_LIVE           32768
+#endif
+
+/* 统计信息 */
+typedef struct
+{
+    bool active;                /* 正在采集 */
+    uint32_t sites;             /* 已记录的调用点数 */
+    uint32_t site_overflow;     /* 调用点表满而未计入的分配 */
+    uint32_t live_overflow;     /* 存活表满而未跟踪的分配 */
+} cli_heap_stats_t;
+
+/* 开始采集（先等待其它线程正在进行的记录完成，再清空之前的结果） */
+void cli_heap_start(void);
+
+/* 停止采集，保留结果 */
+void cli_heap_stop(void);
+
+/* 获取统计信息 */
+void cli_heap_get_stats(cli_heap_stats_t *stats);
+
+/*
+ * heap                        显示状态
+ * heap start | stop           开始/停止采集
+ * heap top [n] [-b|-l]        按分配次数（-b 字节数，-l 存活字节数）排序的前 n 个调用点
+ */
+extern const cli_command_t cli_heap_cmd;
+
+#endif /* CLI_HEAP_PROFILE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_HEAP_H */
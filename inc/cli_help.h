@@ -0,0 +1,48 @@
+/*
+ * @file cli_help.h
+ * @brief 帮助文本输出：支持构建时压缩存储的帮助文本
+ *
+ * CLI_HELP_COMPRESSED 为1时，构建过程用 tools/cli_helpgen 扫描源码中的
+ * .name = "..." 和随后的 CLI_HELP("...")，对全部帮助文本做字节对编码（BPE）：
+ * 0x00..0x7F 为 ASCII 字符本身，0x80..0xFF 各代表字典中的一对符号（可递归）。
+ * 所有命令共用一个字典（最多 256 字节），生成的 cli_help_data.c 放在 Flash 中。
+ * 输出时按命令名哈希查找，用固定深度的栈逐符号展开到小块缓冲区，
+ * 满一块即 cli_write 写出，不需要整段文本大小的 RAM。
+ */
+
+#ifndef CLI_HELP_H
+#define CLI_HELP_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 字典展开的最大嵌套深度（生成器保证不超过，解码栈按此分配） */
+#define CLI_HELP_MAX_DEPTH      16
+
+/* 解码输出块大小 */
+#ifndef CLI_HELP_CHUNK
+#define CLI_HELP_CHUNK          32
+#endif
+
+/* 索引项：按 hash 升序排列（命令名的 FNV-1a 32 位哈希） */
+typedef struct
+{
+    uint32_t hash;
+    uint16_t offset;            /* 在 cli_help_blob 中的偏移 */
+    uint16_t length;            /* 压缩后长度 */
+} cli_help_entry_t;
+
+/*
+ * 输出命令的帮助文本（不含换行）：cmd->help 非 NULL 时直接输出，
+ * 否则在压缩表中查找。返回输出的字符数，没有帮助文本时返回0。
+ */
+size_t cli_help_write(const cli_command_t *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_HELP_H */
@@ -0,0 +1,93 @@
+/*
+ * @file cli_kv.h
+ * @brief 日志结构持久化键值存储（面向 NOR Flash），提供 config 命令
+ */
+
+#ifndef CLI_KV_H
+#define CLI_KV_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 最大键数量（决定RAM索引大小） */
+#ifndef CLI_KV_MAX_KEYS
+#define CLI_KV_MAX_KEYS         64
+#endif
+
+/* 键最大长度（不含终止符） */
+#ifndef CLI_KV_MAX_KEY_LEN
+#define CLI_KV_MAX_KEY_LEN      32
+#endif
+
+/* 值最大长度 */
+#ifndef CLI_KV_MAX_VALUE_LEN
+#define CLI_KV_MAX_VALUE_LEN    128
+#endif
+
+/*
+ * Flash 访问接口。
+ * write 遵循 NOR Flash 语义：只能把位从1写成0，同一位置只编程一次；
+ * erase 把整个扇区恢复为 0xFF。返回0成功，负值失败。
+ */
+typedef struct
+{
+    uint32_t sector_size;       /* 扇区大小（字节，4的倍数） */
+    uint32_t sector_count;      /* 扇区数，至少2个（一个保留用于整理） */
+    int (*read)(void *ctx, uint32_t addr, void *buf, size_t len);
+    int (*write)(void *ctx, uint32_t addr, const void *buf, size_t len);
+    int (*erase)(void *ctx, uint32_t sector);
+    void *ctx;
+} cli_kv_flash_t;
+
+/* 存储统计 */
+typedef struct
+{
+    uint32_t keys;              /* 有效键数 */
+    uint32_t records;           /* 挂载时扫描的记录数 */
+    uint32_t bytes_used;        /* 已写入字节数（含失效记录） */
+    uint32_t bytes_total;       /* 存储总容量 */
+    uint32_t compactions;       /* 整理次数 */
+    uint32_t max_erase;         /* 扇区最大擦除次数 */
+    uint32_t min_erase;         /* 扇区最小擦除次数 */
+    uint32_t mount_ms;          /* 最近一次挂载（重建索引）耗时 */
+} cli_kv_stats_t;
+
+/* 挂载：扫描所有扇区并在RAM中重建索引；空白介质会被格式化 */
+cli_error_t cli_kv_mount(const cli_kv_flash_t *flash);
+
+/* 写入键值（追加新记录，旧记录失效） */
+cli_error_t cli_kv_set(const char *key, const void *value, size_t len);
+
+/* 读取键值，返回值长度，负值为错误码（CLI_ERR_NOT_FOUND 等） */
+int cli_kv_get(const char *key, void *buf, size_t size);
+
+/* 删除键（追加删除标记） */
+cli_error_t cli_kv_delete(const char *key);
+
+/* 按索引槽位遍历键，返回下一个起始位置，-1表示结束 */
+int cli_kv_iterate(int pos, char *key, size_t key_size);
+
+/* 获取统计信息 */
+void cli_kv_get_stats(cli_kv_stats_t *stats);
+
+/*
+ * config 命令：
+ *   config set <key> <value> / get <key> / del <key> / list
+ *   config save   保存所有带 CLI_VAR_FLAG_PERSIST 标志的变量
+ *   config load   将存储中的值恢复到变量
+ *   config info   容量、擦除次数与挂载耗时
+ *   config bench [n]  重复重建索引n次，测量挂载开销
+ */
+extern const cli_command_t cli_kv_config_cmd;
+
+/* 将存储中与持久化变量同名的值恢复到变量，返回恢复数量 */
+int cli_kv_load_vars(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_KV_H */
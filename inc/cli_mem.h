@@ -0,0 +1,58 @@
+/*
+ * @file cli_mem.h
+ * @brief 内存查看命令（md/mw/mf/mc），作用于应用注册的内存区域
+ */
+
+#ifndef CLI_MEM_H
+#define CLI_MEM_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 最大可注册区域数 */
+#ifndef CLI_MEM_MAX_REGIONS
+#define CLI_MEM_MAX_REGIONS     8
+#endif
+
+/* 区域标志 */
+#define CLI_MEM_FLAG_READONLY   0x01    /* 禁止 mw/mf 写入 */
+
+/* 内存区域描述 */
+typedef struct
+{
+    const char *name;           /* 区域名 */
+    uint64_t base;              /* 设备地址（命令中使用的地址） */
+    volatile void *ptr;         /* 本地可访问的指针 */
+    size_t size;                /* 区域大小（字节） */
+    uint8_t flags;              /* CLI_MEM_FLAG_* */
+} cli_mem_region_t;
+
+/* 注册区域：设备地址 [base, base+size) 映射到 ptr */
+cli_error_t cli_mem_region_register(const char *name, uint64_t base, volatile void *ptr, size_t size, uint8_t flags);
+
+/*
+ * 按行格式化十六进制转储（地址 + 数据 + ASCII），返回写入长度。
+ * width 为 1/2/4/8 字节，len 不超过 16；out 至少 CLI_MEM_ROW_MAX 字节。
+ */
+#define CLI_MEM_ROW_MAX         96
+size_t cli_mem_format_row(char *out, uint64_t addr, const uint8_t *data, size_t len, unsigned int width, int addr_digits);
+
+/*
+ * md [-w 1|2|4|8] [-z] <addr> [len]       显示内存（无参数时列出区域，-z 压缩输出）
+ * mw [-w 1|2|4|8] <addr> <value>          写入一个单元
+ * mf [-w 1|2|4|8] <addr> <len> <value>    填充
+ * mc [-w 1|2|4|8] <addr1> <addr2> <len>   比较
+ */
+extern const cli_command_t cli_mem_md_cmd;
+extern const cli_command_t cli_mem_mw_cmd;
+extern const cli_command_t cli_mem_mf_cmd;
+extern const cli_command_t cli_mem_mc_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_MEM_H */
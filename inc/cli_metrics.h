@@ -0,0 +1,171 @@
+/*
+ * @file cli_metrics.h
+ * @brief 指标登记表：计数器、仪表和直方图，按 OpenMetrics 文本格式导出
+ *
+ * 指标描述由调用者分配（通常为模块内的静态变量），登记后即可在任何线程或
+ * 中断中更新。计数器和直方图的值分散在多个分片中，每个线程第一次更新时
+ * 取得一个分片，之后只对该分片做无锁原子加，热路径上不与其它线程或导出
+ * 竞争同一缓存行；导出时把各分片相加。仪表不分片，直接设置，也可以登记
+ * 读取函数在导出时取值。
+ *
+ *   static cli_metric_t s_rx_frames;
+ *   cli_metrics_counter(&s_rx_frames, "app_rx_frames", "Frames received");
+ *   ...
+ *   cli_metrics_inc(&s_rx_frames);
+ *
+ * 导出格式（metrics 命令和 Linux 上的监听端口）：
+ *   # TYPE app_rx_frames counter
+ *   # HELP app_rx_frames Frames received
+ *   app_rx_frames_total 12
+ *   ...
+ *   # EOF
+ * 计数器名称不带 _total 后缀，导出时自动加上。CLI 核心登记 cli_commands、
+ * cli_command_errors、cli_unknown_commands 和 cli_command_duration_ms。
+ */
+
+#ifndef CLI_METRICS_H
+#define CLI_METRICS_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 可登记的指标数 */
+#ifndef CLI_METRICS_MAX
+#define CLI_METRICS_MAX         32
+#endif
+
+/* 每个分片的值槽数：计数器和仪表各占1个，直方图占 桶数+2 个 */
+#ifndef CLI_METRICS_MAX_VALUES
+#define CLI_METRICS_MAX_VALUES  128
+#endif
+
+/* 分片数：主机构建按线程分片，裸机只有主循环和中断，共用一个分片 */
+#ifndef CLI_METRICS_SHARDS
+#if defined(__linux__)
+#define CLI_METRICS_SHARDS      8
+#else
+#define CLI_METRICS_SHARDS      1
+#endif
+#endif
+
+/* 值宽度：主机构建为64位；Cortex-M3 等没有64位原子操作，使用32位（回绕） */
+#ifndef CLI_METRICS_WIDE
+#if defined(__linux__)
+#define CLI_METRICS_WIDE        1
+#else
+#define CLI_METRICS_WIDE        0
+#endif
+#endif
+
+#if CLI_METRICS_WIDE
+typedef uint64_t cli_metric_value_t;
+#else
+typedef uint32_t cli_metric_value_t;
+#endif
+
+/* 直方图最多的桶数（不含 +Inf） */
+#define CLI_METRICS_MAX_BUCKETS 16
+
+typedef enum
+{
+    CLI_METRIC_COUNTER,
+    CLI_METRIC_GAUGE,
+    CLI_METRIC_HISTOGRAM
+} cli_metric_type_t;
+
+/* 仪表读取函数，导出时在主循环中调用 */
+typedef int32_t (*cli_metric_read_t)(void);
+
+/* 指标（成员由本模块维护，调用者只需保证其生命周期） */
+typedef struct cli_metric
+{
+    const char *name;
+    const char *help;               /* 可为NULL */
+    const uint32_t *bounds;         /* 直方图各桶上界（升序） */
+    cli_metric_read_t read;         /* 仪表读取函数，可为NULL */
+    uint16_t base;                  /* 第一个值槽+1，0 表示未登记（未登记的指标更新时忽略） */
+    uint8_t type;
+    uint8_t nbuckets;
+} cli_metric_t;
+
+/*
+ * 登记指标，名称须符合 [a-zA-Z_:][a-zA-Z0-9_:]*。名称重复返回 CLI_ERR_DUPLICATE，
+ * 指标表或值槽用完返回 CLI_ERR_TABLE_FULL。
+ */
+cli_error_t cli_metrics_counter(cli_metric_t *m, const char *name, const char *help);
+
+/* 仪表：read 非NULL时导出时调用它取值，否则使用 cli_metrics_set 设置的值 */
+cli_error_t cli_metrics_gauge(cli_metric_t *m, const char *name, const char *help, cli_metric_read_t read);
+
+/* 直方图：bounds 为 nbuckets 个升序上界（le，含），超出的观测值计入 +Inf 桶 */
+cli_error_t cli_metrics_histogram(cli_metric_t *m, const char *name, const char *help,
+                                  const uint32_t *bounds, uint8_t nbuckets);
+
+/* 计数器加 n（未登记的指标忽略） */
+void cli_metrics_add(cli_metric_t *m, uint32_t n);
+
+/* 计数器加1 */
+#define cli_metrics_inc(m)      cli_metrics_add((m), 1u)
+
+/* 设置仪表值 / 仪表加减 */
+void cli_metrics_set(cli_metric_t *m, int32_t value);
+void cli_metrics_gauge_add(cli_metric_t *m, int32_t delta);
+
+/* 直方图记录一个观测值 */
+void cli_metrics_observe(cli_metric_t *m, uint32_t value);
+
+/* 读取汇总值：计数器为总数，仪表为当前值（按补码），直方图为观测次数 */
+cli_metric_value_t cli_metrics_read(const cli_metric_t *m);
+
+/* 导出输出函数 */
+typedef void (*cli_metrics_out_t)(const char *buf, size_t len, void *ctx);
+
+/* 按 OpenMetrics 文本格式导出所有指标，每行以 nl 结束，最后一行为 "# EOF" */
+void cli_metrics_render(cli_metrics_out_t out, void *ctx, const char *nl);
+
+#if defined(__linux__)
+
+/* 同时连接的抓取客户端数 */
+#ifndef CLI_METRICS_CLIENTS
+#define CLI_METRICS_CLIENTS     4
+#endif
+
+/*
+ * 在 addr:port 上监听 TCP（addr 为NULL时为 127.0.0.1），已在监听时先停止。
+ * 由后台轮询驱动（需在 cli_init 之后调用），不创建线程：以 "GET " 开头的
+ * 请求返回 HTTP/1.0 响应，其它输入或连接后 CLI_METRICS_PLAIN_WAIT_MS 内
+ * 没有输入时直接返回导出文本，之后关闭连接。连接超过
+ * CLI_METRICS_CLIENT_TIMEOUT_MS 仍未完成时直接关闭。
+ */
+cli_error_t cli_metrics_listen(const char *addr, uint16_t port);
+
+/* 停止监听并关闭所有连接 */
+void cli_metrics_stop(void);
+
+/* 纯文本客户端的等待时间 */
+#ifndef CLI_METRICS_PLAIN_WAIT_MS
+#define CLI_METRICS_PLAIN_WAIT_MS   100
+#endif
+
+/* 单个连接从接受到发送完响应的时限 */
+#ifndef CLI_METRICS_CLIENT_TIMEOUT_MS
+#define CLI_METRICS_CLIENT_TIMEOUT_MS   5000
+#endif
+
+#endif /* __linux__ */
+
+/*
+ * metrics                          输出所有指标（OpenMetrics）
+ * metrics listen [port [addr]]     开始监听 / 显示监听状态（仅 Linux）
+ * metrics stop                     停止监听（仅 Linux）
+ */
+extern const cli_command_t cli_metrics_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_METRICS_H */
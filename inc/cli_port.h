@@ -6,6 +6,9 @@
 #ifndef CLI_PORT_H
 #define CLI_PORT_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +28,18 @@ void platform_putchar(char c);
 /* 输出字符串 */
 void platform_puts(const char *s);
 
+/* 批量输出，一次系统调用写出整块数据 */
+void platform_write(const char *buf, size_t len);
+
+/* 单调毫秒时钟 */
+uint32_t platform_get_tick_ms(void);
+
+/* 切换二进制透明传输（原始模式），0 恢复命令行模式 */
+void platform_set_binary(int enable);
+
+/* 主循环空闲时调用，可休眠到下一个中断（输入、时钟节拍） */
+void platform_idle(void);
+
 #ifdef __cplusplus
 }
 #endif
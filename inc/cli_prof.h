@@ -0,0 +1,75 @@
+/*
+ * @file cli_prof.h
+ * @brief 进程内采样分析器（仅 Linux 主机构建）
+ *
+ * 按进程 CPU 时间定时产生 SIGPROF，信号处理函数记录被打断处的 PC
+ * （可选附带几层调用栈）到无锁环形缓冲区；后台轮询把样本汇总到按 PC
+ * 索引的计数表，prof top 时用 dladdr 符号化并按函数合并输出。
+ *
+ * 可执行文件需以 -rdynamic 链接，否则其中的函数只能显示为“模块+偏移”
+ * （static 函数始终如此，可用 addr2line 还原）。
+ */
+
+#ifndef CLI_PROF_H
+#define CLI_PROF_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__linux__)
+
+/* 环形缓冲区样本数（2的幂） */
+#ifndef CLI_PROF_RING_SIZE
+#define CLI_PROF_RING_SIZE      2048
+#endif
+
+/* 计数表容量（2的幂），即最多区分的不同 PC 数 */
+#ifndef CLI_PROF_TABLE_SIZE
+#define CLI_PROF_TABLE_SIZE     4096
+#endif
+
+/* 附带调用栈时记录的调用者层数 */
+#ifndef CLI_PROF_STACK_DEPTH
+#define CLI_PROF_STACK_DEPTH    4
+#endif
+
+/* 采样统计 */
+typedef struct
+{
+    uint32_t hz;                /* 采样频率，0表示未运行 */
+    uint32_t samples;           /* 已汇总的样本数 */
+    uint32_t dropped;           /* 环形缓冲区满而丢弃的样本数 */
+    uint32_t overflow;          /* 计数表满而未能计入的样本数 */
+} cli_prof_stats_t;
+
+/* 初始化（需在 cli_init 之后调用，注册后台轮询） */
+void cli_prof_init(void);
+
+/* 开始采样，清空之前的结果；stacks 为 true 时附带调用栈 */
+cli_error_t cli_prof_start(uint32_t hz, bool stacks);
+
+/* 停止采样（保留结果供 prof top 查看） */
+void cli_prof_stop(void);
+
+/* 获取统计信息 */
+void cli_prof_get_stats(cli_prof_stats_t *stats);
+
+/*
+ * prof                        显示状态
+ * prof start [hz] [-g]        开始采样（默认 999 Hz，-g 附带调用栈）
+ * prof stop                   停止采样
+ * prof top [n]                最热的 n 个函数（默认 20）
+ */
+extern const cli_command_t cli_prof_cmd;
+
+#endif /* __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_PROF_H */
@@ -0,0 +1,53 @@
+/*
+ * @file cli_stream.h
+ * @brief 遥测流模块：按固定频率采样已注册变量并以二进制帧或CSV输出
+ */
+
+#ifndef CLI_STREAM_H
+#define CLI_STREAM_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 单次流最多同时采样的变量数 */
+#ifndef CLI_STREAM_MAX_SELECT
+#define CLI_STREAM_MAX_SELECT   8
+#endif
+
+/* 最大采样频率（受毫秒时钟限制） */
+#ifndef CLI_STREAM_MAX_HZ
+#define CLI_STREAM_MAX_HZ       1000
+#endif
+
+/* 二进制帧同步头 */
+#define CLI_STREAM_SYNC0        0xA5
+#define CLI_STREAM_SYNC1        0x5A
+
+/* 流统计信息 */
+typedef struct
+{
+    uint32_t samples;           /* 已发送样本数 */
+    uint32_t dropped;           /* 因链路阻塞错过的采样点 */
+} cli_stream_stats_t;
+
+/* 初始化流模块（需在 cli_init 之后调用） */
+void cli_stream_init(void);
+
+/* 获取最近一次流的统计信息 */
+void cli_stream_get_stats(cli_stream_stats_t *stats);
+
+/*
+ * stream 命令：stream <var...> [-r hz] [-c] [-n count]，变量来自 cli_var 注册表
+ * 默认以二进制帧输出：A5 5A | seq | len | payload(小端) | sum8，-c 切换为CSV。
+ * 任意按键结束。
+ */
+extern const cli_command_t cli_stream_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_STREAM_H */
@@ -0,0 +1,98 @@
+/*
+ * @file cli_style.h
+ * @brief 终端样式（SGR）：跟踪终端当前属性，只输出必要的变化
+ *
+ * cli_style() 只记录期望样式，真正的转义序列在下一次输出文字前生成：
+ * 相邻的多次切换合并为一个 CSI ... m，与当前状态相同时不输出任何字节；
+ * 差异编码和“复位后重设”两种写法取较短者。
+ * 输出模式为 CSV/JSON、处于自动化模式或调用 cli_style_enable(false) 后不产生转义序列；
+ * 编译时定义 CLI_STYLE_ENABLE 为0则所有接口展开为空。
+ *
+ *   cli_style(CLI_STYLE_ERROR);
+ *   cli_puts("error");
+ *   cli_style(CLI_STYLE_NORMAL);
+ *   cli_puts(": bad value\r\n");
+ */
+
+#ifndef CLI_STYLE_H
+#define CLI_STYLE_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CLI_STYLE_ENABLE
+#define CLI_STYLE_ENABLE        1
+#endif
+
+/* 属性位 */
+#define CLI_ATTR_BOLD           0x01
+#define CLI_ATTR_DIM            0x02
+#define CLI_ATTR_ITALIC         0x04
+#define CLI_ATTR_UNDERLINE      0x08
+#define CLI_ATTR_REVERSE        0x10
+
+/* 颜色：0为终端默认色，1..8 为标准色，9..16 为高亮色 */
+enum
+{
+    CLI_COLOR_DEFAULT = 0,
+    CLI_COLOR_BLACK,
+    CLI_COLOR_RED,
+    CLI_COLOR_GREEN,
+    CLI_COLOR_YELLOW,
+    CLI_COLOR_BLUE,
+    CLI_COLOR_MAGENTA,
+    CLI_COLOR_CYAN,
+    CLI_COLOR_WHITE,
+    CLI_COLOR_BRIGHT_BLACK,
+    CLI_COLOR_BRIGHT_RED,
+    CLI_COLOR_BRIGHT_GREEN,
+    CLI_COLOR_BRIGHT_YELLOW,
+    CLI_COLOR_BRIGHT_BLUE,
+    CLI_COLOR_BRIGHT_MAGENTA,
+    CLI_COLOR_BRIGHT_CYAN,
+    CLI_COLOR_BRIGHT_WHITE
+};
+
+/* 样式：属性 + 前景色 + 背景色 */
+typedef struct
+{
+    uint8_t attr;           /* CLI_ATTR_* */
+    uint8_t fg;             /* CLI_COLOR_* */
+    uint8_t bg;             /* CLI_COLOR_* */
+} cli_style_t;
+
+/* 常用样式 */
+#define CLI_STYLE_NORMAL        ((cli_style_t){ 0, CLI_COLOR_DEFAULT, CLI_COLOR_DEFAULT })
+#define CLI_STYLE_ERROR         ((cli_style_t){ CLI_ATTR_BOLD, CLI_COLOR_RED, CLI_COLOR_DEFAULT })
+#define CLI_STYLE_WARN          ((cli_style_t){ 0, CLI_COLOR_YELLOW, CLI_COLOR_DEFAULT })
+#define CLI_STYLE_OK            ((cli_style_t){ 0, CLI_COLOR_GREEN, CLI_COLOR_DEFAULT })
+#define CLI_STYLE_EMPH          ((cli_style_t){ CLI_ATTR_BOLD, CLI_COLOR_DEFAULT, CLI_COLOR_DEFAULT })
+
+#if CLI_STYLE_ENABLE
+
+/* 设置后续输出的样式（延迟到下一次输出时生效） */
+void cli_style(cli_style_t style);
+
+/* 启用/禁用样式输出（哑终端、非 tty 时禁用），禁用前恢复默认样式 */
+void cli_style_enable(bool enable);
+
+/* 终端被外部复位（如 clear、重新连接）后调用，视当前状态为默认样式 */
+void cli_style_forget(void);
+
+#else
+
+#define cli_style(style)        ((void)0)
+#define cli_style_enable(en)    ((void)0)
+#define cli_style_forget()      ((void)0)
+
+#endif /* CLI_STYLE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_STYLE_H */
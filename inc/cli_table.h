@@ -0,0 +1,88 @@
+/*
+ * @file cli_table.h
+ * @brief 流式表格输出：按列声明格式，逐行推送，每行一次批量写出
+ *
+ * 文本模式按列宽对齐（值超出列宽时该列此后加宽，不截断内容）；
+ * CSV 模式输出表头行和逗号分隔的行；JSON 模式每行输出一个对象（JSON Lines）。
+ * 模式取自 cli_get_output_mode()。内存占用固定，不缓存行。
+ *
+ *   static const cli_table_col_t cols[] = {
+ *       { "name", CLI_COL_STR,  12, 0, 0 },
+ *       { "size", CLI_COL_UINT, 8, CLI_COL_RIGHT, 0 },
+ *   };
+ *   cli_table_t t;
+ *   cli_table_begin(&t, cols, 2);
+ *   cli_table_row(&t, "sram", 65536u);
+ *   cli_table_end(&t);
+ */
+
+#ifndef CLI_TABLE_H
+#define CLI_TABLE_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 最大列数 */
+#ifndef CLI_TABLE_MAX_COLS
+#define CLI_TABLE_MAX_COLS      8
+#endif
+
+/* 行缓冲区大小，超长的行分多次写出 */
+#ifndef CLI_TABLE_LINE_MAX
+#define CLI_TABLE_LINE_MAX      160
+#endif
+
+/* 列类型，决定 cli_table_row 对应可变参数的类型 */
+typedef enum
+{
+    CLI_COL_STR,            /* const char *（NULL 输出为空） */
+    CLI_COL_INT,            /* int */
+    CLI_COL_UINT,           /* unsigned int */
+    CLI_COL_U64,            /* uint64_t */
+    CLI_COL_HEX,            /* uint64_t，prec 为最少位数，输出 0x 前缀 */
+    CLI_COL_FLOAT           /* double，prec 为小数位数，负值为最短表示 */
+} cli_col_type_t;
+
+/* 列标志 */
+#define CLI_COL_RIGHT           0x01    /* 文本模式右对齐 */
+
+/* 列声明 */
+typedef struct
+{
+    const char *name;       /* 表头，也是 JSON 键名 */
+    uint8_t type;           /* cli_col_type_t */
+    uint8_t width;          /* 初始列宽，0 取表头宽度 */
+    uint8_t flags;          /* CLI_COL_* */
+    int8_t prec;            /* 精度，含义见列类型 */
+} cli_table_col_t;
+
+/* 表格状态（由调用方分配，通常在栈上） */
+typedef struct
+{
+    const cli_table_col_t *cols;
+    uint8_t ncols;
+    uint8_t mode;                           /* cli_output_mode_t */
+    uint8_t width[CLI_TABLE_MAX_COLS];      /* 当前列宽 */
+    uint32_t rows;
+} cli_table_t;
+
+/* 开始一张表并输出表头（JSON 模式无表头） */
+void cli_table_begin(cli_table_t *t, const cli_table_col_t *cols, int ncols);
+
+/* 输出一行，参数依次对应各列类型 */
+void cli_table_row(cli_table_t *t, ...);
+
+/* 结束表格 */
+void cli_table_end(cli_table_t *t);
+
+/* format [text|csv|json]：查看或切换输出模式 */
+extern const cli_command_t cli_table_format_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_TABLE_H */
@@ -0,0 +1,83 @@
+/*
+ * @file cli_timer.h
+ * @brief 分级时间轮定时器，由端口的单调毫秒时钟（cli_io_t.get_tick_ms）驱动
+ *
+ * 默认 4 级，每级 32 个槽，第 0 级精度 1ms，覆盖约 17 分钟，更远的到期时刻
+ * 放在最高级并在轮转到时重新计算。定时器为侵入式双向链表节点，由调用者
+ * 分配（通常为模块内的静态变量），启动和取消都是 O(1)。
+ *
+ * 到期回调在 cli_ticks_handler 中（轮询函数之前）调用，与命令处理函数处于
+ * 同一上下文，可在回调中重新启动或取消任何定时器。时钟跳变较大时按槽补齐，
+ * 空级直接跳过。
+ *
+ *   static cli_timer_t t;
+ *   cli_timer_init(&t, on_timeout, NULL);
+ *   cli_timer_start(&t, 500);
+ */
+
+#ifndef CLI_TIMER_H
+#define CLI_TIMER_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 每级槽数的位数（不超过5，槽头指针共 CLI_TIMER_LEVELS << CLI_TIMER_SLOT_BITS 个） */
+#ifndef CLI_TIMER_SLOT_BITS
+#define CLI_TIMER_SLOT_BITS     5
+#endif
+
+/* 级数（与槽位数的乘积不超过31） */
+#ifndef CLI_TIMER_LEVELS
+#define CLI_TIMER_LEVELS        4
+#endif
+
+/* 没有待到期的定时器时 cli_timer_next_expiry 的返回值 */
+#define CLI_TIMER_NEVER         0xFFFFFFFFu
+
+/* 到期回调 */
+typedef void (*cli_timer_fn_t)(void *ctx);
+
+/* 定时器（成员由本模块维护，调用者只需保证其生命周期） */
+typedef struct cli_timer
+{
+    struct cli_timer *next;
+    struct cli_timer *prev;
+    uint32_t expires;               /* 到期时刻（毫秒时钟） */
+    uint16_t slot;                  /* 所在槽，未启动时为 0xFFFF */
+    cli_timer_fn_t fn;
+    void *ctx;
+} cli_timer_t;
+
+/* 初始化定时器（不启动） */
+void cli_timer_init(cli_timer_t *timer, cli_timer_fn_t fn, void *ctx);
+
+/* 启动：delay_ms 毫秒后到期；已启动的定时器按新时刻重新启动 */
+void cli_timer_start(cli_timer_t *timer, uint32_t delay_ms);
+
+/* 启动：在时钟到达 expires_ms 时到期（已过去的时刻在下一次处理时到期），用于无漂移的周期 */
+void cli_timer_start_at(cli_timer_t *timer, uint32_t expires_ms);
+
+/* 取消（未启动时无操作） */
+void cli_timer_cancel(cli_timer_t *timer);
+
+/* 是否已启动且尚未到期 */
+bool cli_timer_pending(const cli_timer_t *timer);
+
+/*
+ * 距最近一个定时器到期的毫秒数（已到期为0），没有定时器时返回 CLI_TIMER_NEVER。
+ * 主循环空闲时可据此决定最长休眠时间。
+ */
+uint32_t cli_timer_next_expiry(void);
+
+/* 处理到 now_ms 为止到期的定时器（cli_ticks_handler 已调用，端口通常无需直接调用） */
+void cli_timer_process(uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_TIMER_H */
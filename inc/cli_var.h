@@ -0,0 +1,119 @@
+/*
+ * @file cli_var.h
+ * @brief 变量绑定注册表：无需编写处理函数即可通过 get/set/list 访问应用变量
+ */
+
+#ifndef CLI_VAR_H
+#define CLI_VAR_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 最大可注册变量数 */
+#ifndef CLI_MAX_VARS
+#define CLI_MAX_VARS            32
+#endif
+
+/* 变量文本表示的最大长度（含终止符） */
+#define CLI_VAR_TEXT_MAX        24
+
+/* 变量标志 */
+#define CLI_VAR_FLAG_READONLY   0x01    /* 只读，set 拒绝修改 */
+#define CLI_VAR_FLAG_PERSIST    0x02    /* 由 config save/load 持久化 */
+
+/* 变量类型（决定存储宽度） */
+typedef enum
+{
+    CLI_VAR_INT8,           /* int8_t */
+    CLI_VAR_UINT8,          /* uint8_t */
+    CLI_VAR_INT16,          /* int16_t */
+    CLI_VAR_UINT16,         /* uint16_t */
+    CLI_VAR_INT32,          /* int32_t */
+    CLI_VAR_UINT32,         /* uint32_t */
+    CLI_VAR_FLOAT,          /* float */
+    CLI_VAR_BOOL,           /* bool */
+    CLI_VAR_ENUM            /* int，取值为枚举名称表下标 */
+} cli_var_type_t;
+
+/* 变量值（按类型解释） */
+typedef union
+{
+    int32_t  i;
+    uint32_t u;
+    float    f;
+} cli_var_value_t;
+
+struct cli_var;
+
+/* 变量被 set 修改后的回调 */
+typedef void (*cli_var_notify_t)(const struct cli_var *var);
+
+/* 变量描述 */
+typedef struct cli_var
+{
+    const char *name;               /* 变量名 */
+    volatile void *ptr;             /* 变量地址 */
+    cli_var_type_t type;            /* 类型 */
+    uint8_t flags;                  /* CLI_VAR_FLAG_* */
+    bool has_range;                 /* 是否限制取值范围 */
+    cli_var_value_t min;            /* 最小值（整数类型用 i/u，浮点用 f） */
+    cli_var_value_t max;            /* 最大值 */
+    const char *const *enum_names;  /* 枚举名称表 */
+    int enum_count;                 /* 枚举名称个数 */
+    cli_var_notify_t notify;        /* 修改回调，可为NULL */
+} cli_var_t;
+
+/* 注册变量（ptr 需在整个程序生命周期内有效） */
+cli_error_t cli_var_register(const char *name, volatile void *ptr, cli_var_type_t type, uint8_t flags);
+
+/* 设置整数类型取值范围（CLI_VAR_UINT32 的下限不能为负） */
+cli_error_t cli_var_set_range(const char *name, int32_t min, int32_t max);
+
+/* 设置 CLI_VAR_UINT32 的取值范围（可超过 INT32_MAX），其它类型返回 CLI_ERR_INVALID_PARAM */
+cli_error_t cli_var_set_range_u(const char *name, uint32_t min, uint32_t max);
+
+/* 设置浮点类型取值范围 */
+cli_error_t cli_var_set_range_f(const char *name, float min, float max);
+
+/* 设置枚举名称表（同时限制取值为 0 ~ count-1） */
+cli_error_t cli_var_set_enum(const char *name, const char *const *names, int count);
+
+/* 设置修改回调 */
+cli_error_t cli_var_set_notify(const char *name, cli_var_notify_t notify);
+
+/* 按名称查找变量（哈希索引，平均 O(1)），未找到返回NULL */
+const cli_var_t* cli_var_find(const char *name);
+
+/* 获取变量数量及按注册顺序访问 */
+int cli_var_get_count(void);
+const cli_var_t* cli_var_get_dsc(int index);
+
+/* 原子读取变量值 */
+cli_var_value_t cli_var_load(const cli_var_t *var);
+
+/* 检查范围后原子写入变量值并触发回调 */
+cli_error_t cli_var_store(const cli_var_t *var, cli_var_value_t value);
+
+/* 变量存储宽度（字节） */
+size_t cli_var_type_size(cli_var_type_t type);
+
+/* 将值格式化为文本，返回长度 */
+size_t cli_var_format(const cli_var_t *var, cli_var_value_t value, char *buf, size_t size);
+
+/* 将文本解析为值（不写入变量） */
+cli_error_t cli_var_parse(const cli_var_t *var, const char *text, cli_var_value_t *value);
+
+/* get/set/list 命令 */
+extern const cli_command_t cli_var_get_cmd;
+extern const cli_command_t cli_var_set_cmd;
+extern const cli_command_t cli_var_list_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_VAR_H */
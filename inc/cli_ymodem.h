@@ -0,0 +1,50 @@
+/*
+ * @file cli_ymodem.h
+ * @brief YMODEM（1K块、CRC-16）文件传输：rx/sx 命令
+ */
+
+#ifndef CLI_YMODEM_H
+#define CLI_YMODEM_H
+
+#include <cli.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 文件名最大长度（含终止符） */
+#ifndef CLI_YMODEM_NAME_MAX
+#define CLI_YMODEM_NAME_MAX     64
+#endif
+
+/*
+ * 存储接口：数据按块流式读写，传输过程中不缓存整个文件。
+ * 返回值：0 成功，负值失败（read 返回实际读取字节数，0 表示文件结束）。
+ */
+typedef struct
+{
+    int (*open_write)(void *ctx, const char *name, uint32_t size);   /* size 为0表示未知 */
+    int (*write)(void *ctx, const uint8_t *data, size_t len);
+    int (*open_read)(void *ctx, const char *name, uint32_t *size);
+    int (*read)(void *ctx, uint8_t *buf, size_t len);
+    void (*close)(void *ctx, bool ok);                               /* ok 为 false 表示传输中止 */
+    void *ctx;
+} cli_ymodem_storage_t;
+
+/* 注册存储接口，需在 cli_init 之后调用 */
+void cli_ymodem_init(const cli_ymodem_storage_t *storage);
+
+/*
+ * rx：接收一批文件（文件名取自 YMODEM 头块）
+ * sx <file>：发送一个文件
+ * 传输期间输入被接管，Ctrl-X（CAN）连按两次可中止。
+ */
+extern const cli_command_t cli_ymodem_rx_cmd;
+extern const cli_command_t cli_ymodem_sx_cmd;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_YMODEM_H */
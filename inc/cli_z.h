@@ -0,0 +1,72 @@
+/*
+ * @file cli_z.h
+ * @brief 压缩批量输出通道：为大块文本输出提供流式 LZ 压缩
+ *
+ * 处理函数在大量输出前调用 cli_z_begin()，结束后调用 cli_z_end()，期间所有
+ * CLI 输出都被压缩并按帧发送，主机端用 tools/cli_unz 实时解压。
+ *
+ * 帧格式：
+ *   magic "\0CZ1" | { len(2字节小端) | 压缩数据 } ... | 0x0000
+ * 压缩数据由令牌组成：
+ *   0LLLLLLL              L+1 个字面字节紧随其后（1..128）
+ *   1MMMMOOO OOOOOOOO     匹配，距离 O+1（1..2048），长度 M+3；
+ *                         M 为15时再跟一个字节 E，长度为 18+E
+ * 匹配可引用前面所有块的输出（窗口跨块延续）。
+ */
+
+#ifndef CLI_Z_H
+#define CLI_Z_H
+
+#include <cli.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 历史窗口大小（2的幂，最大2048），越大压缩率越高、占用RAM越多 */
+#ifndef CLI_Z_WINDOW
+#define CLI_Z_WINDOW            1024
+#endif
+
+/* 每帧块的未压缩长度 */
+#ifndef CLI_Z_CHUNK
+#define CLI_Z_CHUNK             512
+#endif
+
+/* 哈希表位数 */
+#ifndef CLI_Z_HASH_BITS
+#define CLI_Z_HASH_BITS         9
+#endif
+
+#define CLI_Z_MAGIC             "\0CZ1"
+#define CLI_Z_MAGIC_LEN         4
+#define CLI_Z_MAX_OFFSET        2048
+#define CLI_Z_MIN_MATCH         3
+#define CLI_Z_MAX_MATCH         (18 + 255)
+
+/* 压缩统计（累计） */
+typedef struct
+{
+    uint32_t sessions;          /* 压缩会话次数 */
+    uint32_t bytes_in;          /* 未压缩字节数 */
+    uint32_t bytes_out;         /* 压缩后字节数（含帧开销） */
+    uint32_t elapsed_ms;        /* 会话累计耗时 */
+} cli_z_stats_t;
+
+/* 开始压缩输出（切换到二进制模式并输出帧头），已开始时返回错误 */
+cli_error_t cli_z_begin(void);
+
+/* 结束压缩输出：刷新剩余数据并输出结束标记 */
+void cli_z_end(void);
+
+/* 当前是否处于压缩输出中 */
+int cli_z_active(void);
+
+/* 获取累计统计 */
+void cli_z_get_stats(cli_z_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_Z_H */
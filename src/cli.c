@@ -4,6 +4,10 @@
  */
 
 #include <cli.h>
+#include <cli_timer.h>
+#include <cli_metrics.h>
+#include <cli_arg.h>
+#include <cli_bench.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
@@ -21,10 +25,39 @@
 #define CLI_HISTORY_SIZE        5     /* 历史命令条数，0表示不启用 */
 #endif
 
+#ifndef CLI_PRINTF_FLOAT
+#define CLI_PRINTF_FLOAT        1     /* cli_printf 支持 %f/%e/%g，0表示不启用 */
+#endif
+
+#ifndef CLI_MAX_TAG_LENGTH
+#define CLI_MAX_TAG_LENGTH      16    /* 响应标记最大长度（含终止符） */
+#endif
+
+/* 默认限额（见 cli_limit_t），0 表示不限，运行时可用 limit 命令修改 */
+#ifndef CLI_LIMIT_RATE
+#define CLI_LIMIT_RATE          0     /* 每秒命令数 */
+#endif
+
+#ifndef CLI_LIMIT_BURST
+#define CLI_LIMIT_BURST         0     /* 可连续执行的命令数 */
+#endif
+
+#ifndef CLI_LIMIT_CPU_MS
+#define CLI_LIMIT_CPU_MS        0     /* 每个窗口内处理函数的累计耗时（毫秒） */
+#endif
+
+#ifndef CLI_LIMIT_WINDOW_MS
+#define CLI_LIMIT_WINDOW_MS     1000  /* 耗时预算窗口（毫秒） */
+#endif
+
 #ifndef CLI_OUTPUT_NEWLINE
 #define CLI_OUTPUT_NEWLINE      "\r\n"   /* 默认 CRLF，Windows 风格 */
 #endif
 
+#if CLI_PRINTF_FLOAT
+#include <cli_fmt.h>
+#endif
+
 /* 命令行状态 */
 typedef enum
 {
@@ -34,6 +67,15 @@ typedef enum
     CLI_STATE_SS3              /* 收到SS3 (ESC O)，等待后续 */
 } cli_state_t;
 
+/* 命令连接符 */
+typedef enum
+{
+    CLI_CHAIN_END,             /* 行尾 */
+    CLI_CHAIN_SEQ,             /* ;  总是执行下一条 */
+    CLI_CHAIN_AND,             /* && 上一条返回0时执行下一条 */
+    CLI_CHAIN_OR               /* || 上一条返回非0时执行下一条 */
+} cli_chain_t;
+
 /* 全局CLI数据 */
 static struct
 {
@@ -56,6 +98,40 @@ typedef struct
     int count;
 } cli_command_table_t;
 
+/* 后台轮询函数表 */
+static void (*s_polls[CLI_MAX_POLLS])(void);
+static int s_poll_count = 0;
+
+/* 输出过滤器，NULL表示直接输出到端口 */
+static cli_output_filter_t s_output_filter = NULL;
+
+/* 输入接管函数，NULL表示正常行编辑 */
+static cli_input_hook_t s_input_hook = NULL;
+
+/* 输出模式 */
+static cli_output_mode_t s_output_mode = CLI_MODE_TEXT;
+
+/* 旁路记录函数，NULL表示不记录 */
+static cli_tap_t s_tap = NULL;
+
+/* 正在输出行编辑回显或提示符（不交给旁路记录） */
+static bool s_editing = false;
+
+/* 异步输出进行中（输入行已清除，结束时重绘） */
+static bool s_async = false;
+
+/* 下一次输出前执行的一次性回调 */
+static void (*s_deferred)(void) = NULL;
+
+/* 自动化模式与带标记响应 */
+static struct
+{
+    bool enabled;                       /* 关闭回显、提示符和历史记录 */
+    bool pending;                       /* 命令接管了输入，结束标记延迟到释放时输出 */
+    int ret;                            /* 待输出的返回码 */
+    char tag[CLI_MAX_TAG_LENGTH];       /* 当前行的标记，空串表示无标记 */
+} s_auto;
+
 /* 静态命令表实例 */
 static cli_command_table_t s_cmd_table = { .count = 0 };
 
@@ -76,12 +152,48 @@ static cli_history_t s_history = {
 };
 #endif
 
+/* 核心指标（见 cli_metrics.h） */
+static struct
+{
+    cli_metric_t commands;              /* 执行的命令数 */
+    cli_metric_t errors;                /* 返回非0的命令数 */
+    cli_metric_t unknown;               /* 未知命令数 */
+    cli_metric_t duration;              /* 处理函数耗时（毫秒） */
+    cli_metric_t rate_limited;          /* 超出命令速率被拒绝的命令数 */
+    cli_metric_t budget_limited;        /* 超出耗时预算被拒绝的命令数 */
+} s_metrics;
+
+static const uint32_t s_duration_bounds[] = { 1, 5, 10, 50, 100, 500, 1000, 5000 };
+
+/*
+ * 命令限额的两个令牌桶。命令桶每条命令1000单位，每毫秒补充 rate 单位；
+ * 耗时桶每毫秒补充 cpu_ms*1000 单位，处理函数每执行1微秒扣除 window_ms 单位，
+ * 余额为正时才允许分派，可以透支（长时间的命令之后等待更久）。
+ */
+static struct
+{
+    cli_limit_t cfg;
+    int64_t cmd_tokens;
+    int64_t cpu_tokens;
+    uint32_t last;                      /* 上次补充的时刻 */
+} s_limit = {
+    .cfg = { CLI_LIMIT_RATE, CLI_LIMIT_BURST, CLI_LIMIT_CPU_MS, CLI_LIMIT_WINDOW_MS }
+};
+
 /* 静态函数声明 */
 static void cli_newline(void);
 static void cli_backspace(void);
 static void cli_redraw_line(void);
 static void cli_execute(void);
-static int  cli_parse_line(char *line, char **argv, int max_args);
+static void cli_edit_char(char c);
+static int  cli_run_line(char *line);
+static int  cli_run_command(int argc, char **argv);
+static void cli_tag_end(int ret);
+static int  cmd_auto(int argc, char **argv);
+static int  cmd_limit(int argc, char **argv);
+static void cli_limit_reset(void);
+static int  cli_parse_line(char *line, char **argv, int max_args, char **next, cli_chain_t *op);
+static size_t cli_chain_op(const char *p, cli_chain_t *op);
 static void cli_handle_tab(void);
 static int  cli_find_command_matches(const char *prefix, char *matched_name, size_t matched_name_size);
 static void cli_vprintf(const char *format, va_list args);
@@ -92,18 +204,47 @@ static void cli_history_up(void);
 static void cli_history_down(void);
 #endif
 
+/* auto 命令 */
+const cli_command_t cli_automation_cmd = {
+    .name = "auto",
+    .short_name = NULL,
+    .help = CLI_HELP("Automation mode (no echo/prompt): auto [on|off]"),
+    .handler = cmd_auto
+};
+
+/* limit 命令 */
+const cli_command_t cli_limit_cmd = {
+    .name = "limit",
+    .short_name = NULL,
+    .help = CLI_HELP("Command rate/CPU limits: limit [rate <n/s> [burst]|cpu <time> [window]|off]"),
+    .handler = cmd_limit
+};
+
 /* 初始化 */
 void cli_init(const cli_io_t *io)
 {
     s_io = io;
     memset(&s_cli, 0, sizeof(s_cli));
     s_cli.state = CLI_STATE_NORMAL;
+    s_input_hook = NULL;
+    memset(&s_auto, 0, sizeof(s_auto));
 #if CLI_HISTORY_SIZE > 0
     s_history.count = 0;
     s_history.pos = -1;
     s_history.next = 0;
 #endif
+    /* 重复初始化时指标已登记，登记返回 CLI_ERR_DUPLICATE，计数保留 */
+    cli_metrics_counter(&s_metrics.commands, "cli_commands", "Commands executed");
+    cli_metrics_counter(&s_metrics.errors, "cli_command_errors", "Commands whose handler returned non-zero");
+    cli_metrics_counter(&s_metrics.unknown, "cli_unknown_commands", "Unknown command names");
+    cli_metrics_histogram(&s_metrics.duration, "cli_command_duration_ms", "Command handler run time in milliseconds",
+                          s_duration_bounds, (uint8_t)(sizeof(s_duration_bounds) / sizeof(s_duration_bounds[0])));
+    cli_metrics_counter(&s_metrics.rate_limited, "cli_rate_limited", "Commands rejected by the command rate limit");
+    cli_metrics_counter(&s_metrics.budget_limited, "cli_budget_limited", "Commands rejected by the handler time budget");
+    cli_limit_reset();
+    s_editing = true;
     cli_puts(cli_get_prompt());
+    s_editing = false;
 }
 
 /* 注册命令 */
@@ -171,6 +312,28 @@ const cli_command_t* cli_get_command_dsc(int index)
     return &s_cmd_table.commands[index];
 }
 
+/* 注册后台轮询函数 */
+cli_error_t cli_poll_register(void (*poll)(void))
+{
+    if (poll == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    for (int i = 0; i < s_poll_count; i++)
+    {
+        if (s_polls[i] == poll)
+        {
+            return CLI_ERR_DUPLICATE;
+        }
+    }
+    if (s_poll_count >= CLI_MAX_POLLS)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    s_polls[s_poll_count++] = poll;
+    return CLI_SUCCESS;
+}
+
 /* 定时处理函数 */
 void cli_ticks_handler(void)
 {
@@ -180,12 +343,166 @@ void cli_ticks_handler(void)
     {
         cli_process_char((char)c);
     }
+    cli_timer_process(cli_get_tick_ms());
+    for (int i = 0; i < s_poll_count; i++)
+    {
+        s_polls[i]();
+    }
+}
+
+/* 接管输入 */
+void cli_input_acquire(cli_input_hook_t hook)
+{
+    s_input_hook = hook;
+}
+
+/* 释放输入接管 */
+void cli_input_release(void)
+{
+    if (s_input_hook != NULL)
+    {
+        s_input_hook = NULL;
+        if (s_auto.pending)
+        {
+            s_auto.pending = false;
+            cli_tag_end(s_auto.ret);
+        }
+        if (!s_auto.enabled)
+        {
+            s_editing = true;
+            cli_puts(cli_get_prompt());
+            s_editing = false;
+        }
+    }
+}
+
+/* 切换自动化模式 */
+void cli_set_automation(int enable)
+{
+    s_auto.enabled = (enable != 0);
+}
+
+/* 查询自动化模式 */
+int cli_get_automation(void)
+{
+    return s_auto.enabled ? 1 : 0;
+}
+
+/* auto 命令 */
+static int cmd_auto(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        cli_puts(s_auto.enabled ? "on" : "off");
+        cli_newline();
+        return 0;
+    }
+    if (strcmp(argv[1], "on") == 0)
+    {
+        cli_set_automation(1);
+        return 0;
+    }
+    if (strcmp(argv[1], "off") == 0)
+    {
+        cli_set_automation(0);
+        return 0;
+    }
+    cli_puts("Usage: auto [on|off]");
+    cli_newline();
+    return -1;
+}
+
+/* 输入是否被接管 */
+int cli_input_is_acquired(void)
+{
+    return (s_input_hook != NULL) ? 1 : 0;
+}
+
+/* 开始异步输出：清除正在编辑的行（可重复调用） */
+void cli_async_begin(void)
+{
+    if (!s_async)
+    {
+        s_async = true;
+        if (!s_auto.enabled && s_input_hook == NULL)
+        {
+            s_editing = true;
+            cli_puts("\r\033[K");
+            s_editing = false;
+        }
+    }
+}
+
+/* 结束异步输出：重新显示提示符和已输入的内容 */
+void cli_async_end(void)
+{
+    if (s_async)
+    {
+        s_async = false;
+        if (!s_auto.enabled && s_input_hook == NULL)
+        {
+            s_editing = true;
+            cli_redraw_line();
+            s_editing = false;
+        }
+    }
+}
+
+/* 切换二进制透明传输模式 */
+void cli_set_binary(int enable)
+{
+    if (s_io && s_io->set_binary)
+    {
+        s_io->set_binary(enable);
+    }
+}
+
+/* 获取单调毫秒时钟 */
+uint32_t cli_get_tick_ms(void)
+{
+    if (s_io && s_io->get_tick_ms)
+    {
+        return s_io->get_tick_ms();
+    }
+    return 0;
+}
+
+/* 端口是否提供毫秒时钟 */
+int cli_has_clock(void)
+{
+    return (s_io != NULL && s_io->get_tick_ms != NULL) ? 1 : 0;
+}
+
+/* 执行延迟回调（先清除，回调内的输出不会再次触发） */
+static void cli_run_deferred(void)
+{
+    void (*fn)(void) = s_deferred;
+    s_deferred = NULL;
+    fn();
+}
+
+/* 登记延迟回调 */
+void cli_defer_output(void (*fn)(void))
+{
+    s_deferred = fn;
 }
 
 /* 输出字符（供外部使用） */
 void cli_putchar(char c)
 {
-    if (s_io && s_io->putchar)
+    if (s_deferred != NULL)
+    {
+        cli_run_deferred();
+    }
+    if (s_tap != NULL && !s_editing)
+    {
+        s_tap(CLI_TAP_OUTPUT, &c, 1);
+    }
+    if (s_output_filter != NULL)
+    {
+        s_output_filter(&c, 1);
+    }
+    else if (s_io && s_io->putchar)
     {
         s_io->putchar(c);
     }
@@ -194,12 +511,95 @@ void cli_putchar(char c)
 /* 输出字符串（供外部使用） */
 void cli_puts(const char *s)
 {
-    if (s_io && s_io->puts)
+    if (s_deferred != NULL)
+    {
+        cli_run_deferred();
+    }
+    if (s_tap != NULL && !s_editing && s != NULL)
+    {
+        s_tap(CLI_TAP_OUTPUT, s, strlen(s));
+    }
+    if (s_output_filter != NULL)
+    {
+        if (s != NULL)
+        {
+            s_output_filter(s, strlen(s));
+        }
+    }
+    else if (s_io && s_io->puts)
     {
         s_io->puts(s);
     }
 }
 
+/* 批量输出（供外部使用） */
+void cli_write(const char *buf, size_t len)
+{
+    if (s_deferred != NULL)
+    {
+        cli_run_deferred();
+    }
+    if (s_tap != NULL && !s_editing && buf != NULL)
+    {
+        s_tap(CLI_TAP_OUTPUT, buf, len);
+    }
+    if (s_output_filter != NULL)
+    {
+        if (buf != NULL)
+        {
+            s_output_filter(buf, len);
+        }
+    }
+    else
+    {
+        cli_write_raw(buf, len);
+    }
+}
+
+/* 绕过输出过滤器直接写端口 */
+void cli_write_raw(const char *buf, size_t len)
+{
+    if (s_io == NULL || buf == NULL)
+    {
+        return;
+    }
+    if (s_io->write)
+    {
+        s_io->write(buf, len);
+    }
+    else if (s_io->putchar)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            s_io->putchar(buf[i]);
+        }
+    }
+}
+
+/* 安装旁路记录 */
+void cli_set_tap(cli_tap_t tap)
+{
+    s_tap = tap;
+}
+
+/* 安装输出过滤器 */
+void cli_set_output_filter(cli_output_filter_t filter)
+{
+    s_output_filter = filter;
+}
+
+/* 设置输出模式 */
+void cli_set_output_mode(cli_output_mode_t mode)
+{
+    s_output_mode = mode;
+}
+
+/* 获取输出模式 */
+cli_output_mode_t cli_get_output_mode(void)
+{
+    return s_output_mode;
+}
+
 /* 获取提示符（静态私有） */
 static const char* cli_get_prompt(void)
 {
@@ -209,6 +609,44 @@ static const char* cli_get_prompt(void)
 /* 处理单个字符 */
 void cli_process_char(char c)
 {
+    /* 输入被接管时直接交给接管函数 */
+    if (s_input_hook != NULL)
+    {
+        s_input_hook(c);
+        return;
+    }
+
+    /* 行编辑的回显和提示符不交给旁路记录（命令执行期间由 cli_execute 恢复） */
+    s_editing = true;
+    cli_edit_char(c);
+    s_editing = false;
+}
+
+/* 行编辑 */
+static void cli_edit_char(char c)
+{
+    /* 自动化模式：不回显、不做行编辑，只收集字符直到行尾 */
+    if (s_auto.enabled)
+    {
+        if (c == '\r' || c == '\n')
+        {
+            cli_execute();
+        }
+        else if (c == '\b' || c == 0x7F)
+        {
+            if (s_cli.len > 0)
+            {
+                s_cli.line[--s_cli.len] = '\0';
+            }
+        }
+        else if (c >= 0x20 && c <= 0x7E && s_cli.len < CLI_MAX_LINE_LENGTH - 1)
+        {
+            s_cli.line[s_cli.len++] = c;
+        }
+        s_cli.pos = s_cli.len;
+        return;
+    }
+
     /* 先处理转义序列 */
     if (s_cli.state != CLI_STATE_NORMAL)
     {
@@ -319,8 +757,11 @@ void cli_process_char(char c)
         /* 回车 */
         cli_newline();
         cli_execute();
-        /* 重新显示提示符 */
-        cli_puts(cli_get_prompt());
+        /* 重新显示提示符（命令接管输入时由 cli_input_release 显示） */
+        if (s_input_hook == NULL && !s_auto.enabled)
+        {
+            cli_puts(cli_get_prompt());
+        }
     }
     else if (c == '\b' || c == 0x7F) /* 退格 */
     {
@@ -628,12 +1069,286 @@ static void cli_history_down(void)
 }
 #endif /* CLI_HISTORY_SIZE > 0 */
 
+/* 输出结束标记 */
+static void cli_tag_end(int ret)
+{
+    cli_printf("@@end %s %d" CLI_OUTPUT_NEWLINE, s_auto.tag, ret);
+    s_auto.tag[0] = '\0';
+}
+
+/* 执行一条命令，返回处理函数的返回值（未知命令为 CLI_ERR_NOT_FOUND） */
+static int cli_run_command(int argc, char **argv)
+{
+    for (int i = 0; i < s_cmd_table.count; i++)
+    {
+        const cli_command_t *cmd = &s_cmd_table.commands[i];
+        /* 同时匹配长名和短名 */
+        if (strcmp(argv[0], cmd->name) == 0 ||
+            (cmd->short_name != NULL && strcmp(argv[0], cmd->short_name) == 0))
+        {
+            uint32_t hz;
+            uint32_t start_ms = cli_get_tick_ms();
+            uint32_t start = cli_bench_counter(&hz);
+            int ret = cmd->handler(argc, argv);
+            uint32_t ticks = cli_bench_counter(NULL) - start;
+            uint32_t elapsed_ms = cli_get_tick_ms() - start_ms;
+            /*
+             * 有高精度计数器（cli_bench_set_counter）时按它计时，不足1毫秒的命令
+             * 也计入预算；超过1秒时32位计数器可能已回绕，改按毫秒时钟
+             */
+            uint64_t elapsed_us = (elapsed_ms < 1000u) ? (uint64_t)ticks * 1000000u / hz
+                                                       : (uint64_t)elapsed_ms * 1000u;
+            /* 处理函数可能修改了限额，按当前窗口扣除 */
+            if (s_limit.cfg.cpu_ms != 0)
+            {
+                s_limit.cpu_tokens -= (int64_t)elapsed_us * s_limit.cfg.window_ms;
+            }
+            cli_metrics_observe(&s_metrics.duration, (uint32_t)(elapsed_us / 1000u));
+            cli_metrics_inc(&s_metrics.commands);
+            if (ret != 0)
+            {
+                cli_metrics_inc(&s_metrics.errors);
+            }
+            /* 带标记时返回码在结束标记中给出 */
+            if (ret != 0 && s_auto.tag[0] == '\0')
+            {
+                cli_puts("Command returned error\r\n");
+            }
+            return ret;
+        }
+    }
+
+    cli_metrics_inc(&s_metrics.unknown);
+    cli_puts("Unknown command: ");
+    cli_puts(argv[0]);
+    cli_newline();
+    return CLI_ERR_NOT_FOUND;
+}
+
+/* 按经过的时间补充令牌 */
+static void cli_limit_refill(void)
+{
+    uint32_t now = cli_get_tick_ms();
+    uint32_t elapsed = now - s_limit.last;
+    int64_t cap;
+
+    s_limit.last = now;
+    if (s_limit.cfg.rate != 0)
+    {
+        cap = (int64_t)s_limit.cfg.burst * 1000;
+        s_limit.cmd_tokens += (int64_t)elapsed * s_limit.cfg.rate;
+        if (s_limit.cmd_tokens > cap)
+        {
+            s_limit.cmd_tokens = cap;
+        }
+    }
+    if (s_limit.cfg.cpu_ms != 0)
+    {
+        cap = (int64_t)s_limit.cfg.cpu_ms * s_limit.cfg.window_ms * 1000;
+        s_limit.cpu_tokens += (int64_t)elapsed * s_limit.cfg.cpu_ms * 1000;
+        if (s_limit.cpu_tokens > cap)
+        {
+            s_limit.cpu_tokens = cap;
+        }
+    }
+}
+
+/* 装满两个桶 */
+static void cli_limit_reset(void)
+{
+    if (s_limit.cfg.rate != 0 && s_limit.cfg.burst == 0)
+    {
+        s_limit.cfg.burst = s_limit.cfg.rate;
+    }
+    if (s_limit.cfg.window_ms == 0)
+    {
+        s_limit.cfg.window_ms = 1000;
+    }
+    s_limit.cmd_tokens = (int64_t)s_limit.cfg.burst * 1000;
+    s_limit.cpu_tokens = (int64_t)s_limit.cfg.cpu_ms * s_limit.cfg.window_ms * 1000;
+    s_limit.last = cli_get_tick_ms();
+}
+
+/* 分派前检查限额：允许时扣除一条命令的令牌，拒绝时输出原因和重试等待时间 */
+static bool cli_limit_admit(void)
+{
+    uint32_t retry;
+
+    if (s_limit.cfg.rate == 0 && s_limit.cfg.cpu_ms == 0)
+    {
+        return true;
+    }
+    cli_limit_refill();
+    if (s_limit.cfg.cpu_ms != 0 && s_limit.cpu_tokens <= 0)
+    {
+        retry = (uint32_t)(-s_limit.cpu_tokens / ((int64_t)s_limit.cfg.cpu_ms * 1000)) + 1u;
+        cli_metrics_inc(&s_metrics.budget_limited);
+        cli_printf("CPU budget exhausted, retry in %u ms" CLI_OUTPUT_NEWLINE, (unsigned int)retry);
+        return false;
+    }
+    if (s_limit.cfg.rate != 0)
+    {
+        if (s_limit.cmd_tokens < 1000)
+        {
+            retry = (uint32_t)((1000 - s_limit.cmd_tokens + s_limit.cfg.rate - 1) / s_limit.cfg.rate);
+            cli_metrics_inc(&s_metrics.rate_limited);
+            cli_printf("Rate limited, retry in %u ms" CLI_OUTPUT_NEWLINE, (unsigned int)retry);
+            return false;
+        }
+        s_limit.cmd_tokens -= 1000;
+    }
+    return true;
+}
+
+cli_error_t cli_set_limits(const cli_limit_t *limits)
+{
+    static const cli_limit_t none = { 0, 0, 0, 0 };
+
+    if (limits == NULL)
+    {
+        limits = &none;
+    }
+    if ((limits->rate != 0 || limits->cpu_ms != 0) && !cli_has_clock())
+    {
+        return CLI_ERR_IO;
+    }
+    s_limit.cfg = *limits;
+    cli_limit_reset();
+    return CLI_SUCCESS;
+}
+
+void cli_get_limits(cli_limit_t *limits)
+{
+    if (limits != NULL)
+    {
+        *limits = s_limit.cfg;
+    }
+}
+
+/* limit 命令 */
+static int cmd_limit(int argc, char **argv)
+{
+    cli_limit_t cfg = s_limit.cfg;
+    uint32_t a;
+    uint32_t b;
+
+    if (argc == 1)
+    {
+        if (cfg.rate != 0)
+        {
+            cli_printf("rate    %u/s, burst %u" CLI_OUTPUT_NEWLINE, (unsigned int)cfg.rate, (unsigned int)cfg.burst);
+        }
+        else
+        {
+            cli_puts("rate    off" CLI_OUTPUT_NEWLINE);
+        }
+        if (cfg.cpu_ms != 0)
+        {
+            cli_printf("cpu     %u ms per %u ms" CLI_OUTPUT_NEWLINE, (unsigned int)cfg.cpu_ms, (unsigned int)cfg.window_ms);
+        }
+        else
+        {
+            cli_puts("cpu     off" CLI_OUTPUT_NEWLINE);
+        }
+        cli_printf("rejected %u rate, %u cpu" CLI_OUTPUT_NEWLINE,
+                   (unsigned int)cli_metrics_read(&s_metrics.rate_limited),
+                   (unsigned int)cli_metrics_read(&s_metrics.budget_limited));
+        return 0;
+    }
+    if (strcmp(argv[1], "off") == 0 && argc == 2)
+    {
+        cli_set_limits(NULL);
+        return 0;
+    }
+    if (strcmp(argv[1], "rate") == 0 && (argc == 3 || argc == 4))
+    {
+        if (cli_arg_u32(CLI_ARG(argv[2]), 0u, 65535u, &a) != CLI_SUCCESS)
+        {
+            cli_arg_report("rate", CLI_ARG(argv[2]));
+            return -1;
+        }
+        b = 0;
+        if (argc == 4 && cli_arg_u32(CLI_ARG(argv[3]), 1u, 65535u, &b) != CLI_SUCCESS)
+        {
+            cli_arg_report("burst", CLI_ARG(argv[3]));
+            return -1;
+        }
+        cfg.rate = (uint16_t)a;
+        cfg.burst = (uint16_t)b;
+    }
+    else if (strcmp(argv[1], "cpu") == 0 && (argc == 3 || argc == 4))
+    {
+        b = 1000u;
+        if (argc == 4 && cli_arg_duration(CLI_ARG(argv[3]), 1u, 60000u, &b) != CLI_SUCCESS)
+        {
+            cli_arg_report("window", CLI_ARG(argv[3]));
+            return -1;
+        }
+        if (cli_arg_duration(CLI_ARG(argv[2]), 0u, b, &a) != CLI_SUCCESS)
+        {
+            cli_arg_report("time", CLI_ARG(argv[2]));
+            return -1;
+        }
+        cfg.cpu_ms = (uint16_t)a;
+        cfg.window_ms = (uint16_t)b;
+    }
+    else
+    {
+        cli_puts("Usage: limit [rate <n/s> [burst]|cpu <time> [window]|off]" CLI_OUTPUT_NEWLINE);
+        return -1;
+    }
+    if (cli_set_limits(&cfg) != CLI_SUCCESS)
+    {
+        cli_puts("No clock for limits" CLI_OUTPUT_NEWLINE);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * 执行一行命令，可用 ; && || 连接多条，按 shell 的规则短路：
+ * 被跳过的命令不改变返回值，如 "a && b || c" 在 a 失败时执行 c。
+ * 返回最后执行的命令的返回值；某条命令接管输入时，其余部分不再执行。
+ */
+static int cli_run_line(char *line)
+{
+    char *argv[CLI_MAX_ARGS + 1];
+    cli_chain_t prev = CLI_CHAIN_SEQ;
+    cli_chain_t op;
+    int ret = 0;
+
+    do
+    {
+        int argc = cli_parse_line(line, argv, CLI_MAX_ARGS, &line, &op);
+        bool run = (prev == CLI_CHAIN_SEQ) ||
+                   (prev == CLI_CHAIN_AND && ret == 0) ||
+                   (prev == CLI_CHAIN_OR && ret != 0);
+
+        if (run && argc > 0)
+        {
+            if (!cli_limit_admit())
+            {
+                ret = CLI_ERR_BUSY;
+                break;
+            }
+            ret = cli_run_command(argc, argv);
+            if (s_input_hook != NULL)
+            {
+                break;
+            }
+        }
+        prev = op;
+    } while (op != CLI_CHAIN_END);
+
+    return ret;
+}
+
 /* 执行命令行 */
 static void cli_execute(void)
 {
-    char *argv[CLI_MAX_ARGS];
-    int argc;
-    int found = 0;
+    char *line = s_cli.line;
+    bool editing = s_editing;
+    int ret;
 #if CLI_HISTORY_SIZE > 0
     char cmd_copy[CLI_MAX_LINE_LENGTH];
     /* 在执行前保存原始命令行（用于历史记录） */
@@ -641,32 +1356,50 @@ static void cli_execute(void)
     cmd_copy[CLI_MAX_LINE_LENGTH - 1] = '\0';
 #endif
 
-    argc = cli_parse_line(s_cli.line, argv, CLI_MAX_ARGS);
+    s_editing = false;
+    if (s_tap != NULL && s_cli.line[0] != '\0')
+    {
+        s_tap(CLI_TAP_INPUT, s_cli.line, strlen(s_cli.line));
+    }
 
-    if (argc > 0)
+    /* "@标记 命令..."：响应以 "@@begin 标记" 开始，"@@end 标记 返回码" 结束 */
+    while (*line == ' ' || *line == '\t')
     {
-        for (int i = 0; i < s_cmd_table.count; i++)
+        line++;
+    }
+    if (*line == '@')
+    {
+        size_t n = strcspn(line + 1, " \t");
+        if (n == 0 || n >= CLI_MAX_TAG_LENGTH)
         {
-            const cli_command_t *cmd = &s_cmd_table.commands[i];
-            /* 同时匹配长名和短名 */
-            if (strcmp(argv[0], cmd->name) == 0 ||
-                (cmd->short_name != NULL && strcmp(argv[0], cmd->short_name) == 0))
-            {
-                found = 1;
-                int ret = cmd->handler(argc, argv);
-                if (ret != 0)
-                {
-                    cli_puts("Command returned error\r\n");
-                }
-                break;
-            }
+            cli_puts("Invalid tag");
+            cli_newline();
+            line = NULL;
+        }
+        else
+        {
+            memcpy(s_auto.tag, line + 1, n);
+            s_auto.tag[n] = '\0';
+            line += 1 + n;
+            cli_printf("@@begin %s" CLI_OUTPUT_NEWLINE, s_auto.tag);
         }
+    }
 
-        if (!found)
+    if (line != NULL)
+    {
+        ret = cli_run_line(line);
+        if (s_auto.tag[0] != '\0')
         {
-            cli_puts("Unknown command: ");
-            cli_puts(argv[0]);
-            cli_newline();
+            if (s_input_hook != NULL)
+            {
+                /* 命令接管了输入（如流输出、文件传输），结束时再输出 */
+                s_auto.pending = true;
+                s_auto.ret = ret;
+            }
+            else
+            {
+                cli_tag_end(ret);
+            }
         }
     }
 
@@ -676,25 +1409,52 @@ static void cli_execute(void)
     memset(s_cli.line, 0, sizeof(s_cli.line));
 
 #if CLI_HISTORY_SIZE > 0
-    /* 如果命令行非空，添加到历史记录 */
-    if (cmd_copy[0] != '\0')
+    /* 如果命令行非空，添加到历史记录（自动化模式不记录） */
+    if (cmd_copy[0] != '\0' && !s_auto.enabled)
     {
         cli_history_add(cmd_copy);
     }
     /* 重置历史浏览状态 */
     s_history.pos = -1;
 #endif
+    s_editing = editing;
 }
 
-/* 解析命令行参数 */
-static int cli_parse_line(char *line, char **argv, int max_args)
+/* 判断 p 处是否为连接符，返回其长度，0表示不是 */
+static size_t cli_chain_op(const char *p, cli_chain_t *op)
+{
+    if (p[0] == ';')
+    {
+        *op = CLI_CHAIN_SEQ;
+        return 1;
+    }
+    if (p[0] == '&' && p[1] == '&')
+    {
+        *op = CLI_CHAIN_AND;
+        return 2;
+    }
+    if (p[0] == '|' && p[1] == '|')
+    {
+        *op = CLI_CHAIN_OR;
+        return 2;
+    }
+    return 0;
+}
+
+/*
+ * 解析命令行参数，遇到引号外的连接符时停止：*op 返回连接符，
+ * *next 指向其后的剩余部分（行尾时 *op 为 CLI_CHAIN_END）。
+ * 超过 max_args 的参数被忽略，argv 至少需要 max_args+1 项。
+ */
+static int cli_parse_line(char *line, char **argv, int max_args, char **next, cli_chain_t *op)
 {
     int argc = 0;
     char *p = line;
     char *start;
-    int in_quote = 0;
+    size_t n = 0;
 
-    while (*p != '\0' && argc < max_args)
+    *op = CLI_CHAIN_END;
+    while (*p != '\0')
     {
         while (*p == ' ' || *p == '\t')
         {
@@ -704,15 +1464,19 @@ static int cli_parse_line(char *line, char **argv, int max_args)
         {
             break;
         }
+        n = cli_chain_op(p, op);
+        if (n != 0)
+        {
+            break;
+        }
 
         start = p;
 
         if (*p == '"')
         {
-            in_quote = 1;
             p++;
             start = p;
-            while (*p != '\0' && (*p != '"' || in_quote))
+            while (*p != '\0' && *p != '"')
             {
                 if (*p == '\\' && *(p+1) == '"')
                 {
@@ -725,26 +1489,40 @@ static int cli_parse_line(char *line, char **argv, int max_args)
                 *p = '\0';
                 p++;
             }
-            in_quote = 0;
         }
         else
         {
             while (*p != '\0' && *p != ' ' && *p != '\t')
             {
+                n = cli_chain_op(p, op);
+                if (n != 0)
+                {
+                    break;
+                }
                 p++;
             }
         }
 
+        if (argc < max_args)
+        {
+            argv[argc++] = start;
+        }
+
+        if (n != 0)
+        {
+            /* 连接符紧跟在参数之后 */
+            *p = '\0';
+            break;
+        }
         if (*p == ' ' || *p == '\t')
         {
             *p = '\0';
             p++;
         }
-
-        argv[argc++] = start;
     }
 
     argv[argc] = NULL;
+    *next = p + n;
     return argc;
 }
 
@@ -760,54 +1538,97 @@ static void cli_vprintf(const char *format, va_list args)
         }
 
         p++;
+        /* 精度：.N 或 .*（目前只作用于浮点转换） */
+        int prec = -1;
+        if (*p == '.')
+        {
+            p++;
+            prec = 0;
+            if (*p == '*')
+            {
+                prec = va_arg(args, int);
+                p++;
+            }
+            else
+            {
+                while (*p >= '0' && *p <= '9')
+                {
+                    prec = prec * 10 + (*p - '0');
+                    p++;
+                }
+            }
+        }
+        /* 长度修饰 l：%ld/%lu/%lx 读取 long，%lf 等与 %f 相同 */
+        int is_long = 0;
+        if (*p == 'l')
+        {
+            is_long = 1;
+            p++;
+        }
         switch (*p)
         {
-            case 'd':
+#if CLI_PRINTF_FLOAT
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
             {
-                int val = va_arg(args, int);
-                if (val < 0)
+                double val = va_arg(args, double);
+                char buf[CLI_FMT_DOUBLE_MAX];
+                size_t n;
+                /* 无精度的 %g 输出最短往返表示；恰为单精度的值（float 实参）按单精度取最短 */
+                if (prec < 0 && (*p == 'g' || *p == 'G') && (double)(float)val == val)
                 {
-                    cli_putchar('-');
-                    val = -val;
+                    n = cli_fmt_float(buf, (float)val);
+                    for (size_t i = 0; *p == 'G' && i < n; i++)
+                    {
+                        if (buf[i] >= 'a' && buf[i] <= 'z')
+                        {
+                            buf[i] = (char)(buf[i] - 'a' + 'A');
+                        }
+                    }
                 }
-                char buf[12];
-                int i = 0;
-                do {
-                    buf[i++] = '0' + (val % 10);
-                    val /= 10;
-                } while (val > 0);
-                while (i > 0)
+                else
                 {
-                    cli_putchar(buf[--i]);
+                    n = cli_fmt_double(buf, val, *p, prec);
                 }
+                cli_write(buf, n);
                 break;
             }
+#endif
 
+            case 'd':
             case 'u':
+            case 'x':
             {
-                unsigned int val = va_arg(args, unsigned int);
-                char buf[12];
+                unsigned long val;
+                unsigned int base = (*p == 'x') ? 16u : 10u;
+                char buf[24];
                 int i = 0;
-                do {
-                    buf[i++] = '0' + (val % 10);
-                    val /= 10;
-                } while (val > 0);
-                while (i > 0)
+                if (*p == 'd')
                 {
-                    cli_putchar(buf[--i]);
+                    long sval = is_long ? va_arg(args, long) : (long)va_arg(args, int);
+                    if (sval < 0)
+                    {
+                        cli_putchar('-');
+                        /* 取反前转为无符号，避免 LONG_MIN 溢出 */
+                        val = 0ul - (unsigned long)sval;
+                    }
+                    else
+                    {
+                        val = (unsigned long)sval;
+                    }
+                }
+                else
+                {
+                    val = is_long ? va_arg(args, unsigned long) : (unsigned long)va_arg(args, unsigned int);
                 }
-                break;
-            }
-
-            case 'x':
-            {
-                unsigned int val = va_arg(args, unsigned int);
-                char buf[12];
-                int i = 0;
                 do {
-                    int digit = val % 16;
-                    buf[i++] = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
-                    val /= 16;
+                    unsigned int digit = (unsigned int)(val % base);
+                    buf[i++] = (char)((digit < 10) ? ('0' + digit) : ('a' + digit - 10));
+                    val /= base;
                 } while (val > 0);
                 while (i > 0)
                 {
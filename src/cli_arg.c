@@ -0,0 +1,617 @@
+/*
+ * @file cli_arg.c
+ * @brief 命令参数解析实现
+ *
+ * 十进制数字串每8个字符用 SWAR 一次校验并转换（乘法合并相邻数位），
+ * 不足8个的尾部逐字符处理。解析失败时记录期望格式和范围，供
+ * cli_arg_report 输出；成功路径不产生额外开销。
+ */
+
+#include <cli_arg.h>
+#include <cli_style.h>
+#include <float.h>
+
+/* 最近一次失败的信息 */
+static struct
+{
+    cli_error_t err;
+    const char *expect;             /* 格式说明 */
+    const char *const *names;       /* 枚举名称表（枚举失败时） */
+    int count;
+    bool is_signed;                 /* min/max 按有符号数显示 */
+    uint64_t min;
+    uint64_t max;
+    const char *unit;               /* 范围的单位后缀 */
+} s_arg_fail;
+
+static cli_error_t arg_fail(cli_error_t err, const char *expect)
+{
+    s_arg_fail.err = err;
+    s_arg_fail.expect = expect;
+    s_arg_fail.names = NULL;
+    s_arg_fail.is_signed = false;
+    s_arg_fail.unit = "";
+    return err;
+}
+
+static cli_error_t arg_fail_range(uint64_t min, uint64_t max, bool is_signed, const char *unit)
+{
+    arg_fail(CLI_ERR_RANGE, NULL);
+    s_arg_fail.min = min;
+    s_arg_fail.max = max;
+    s_arg_fail.is_signed = is_signed;
+    s_arg_fail.unit = unit;
+    return CLI_ERR_RANGE;
+}
+
+/* 读取8个字符，首字符在最低字节 */
+static uint64_t arg_load8(const char *s)
+{
+    uint64_t v;
+    memcpy(&v, s, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/* 8个字符是否全为 '0'..'9' */
+static bool arg_is_digits8(uint64_t v)
+{
+    return ((v & 0xF0F0F0F0F0F0F0F0ull) |
+            (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/* 8个数字字符转换为整数：相邻两位、四位、八位依次合并 */
+static uint32_t arg_swar8(uint64_t v)
+{
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+         (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return (uint32_t)v;
+}
+
+/*
+ * 解析十进制数字，遇到非数字停止，返回消耗的字符数（0表示没有数字）。
+ * 溢出时 *overflow 置位。
+ */
+static size_t arg_dec(const char *s, size_t len, uint64_t *out, bool *overflow)
+{
+    uint64_t v = 0;
+    size_t i = 0;
+
+    while (len - i >= 8)
+    {
+        uint64_t chunk = arg_load8(s + i);
+        uint32_t d;
+        if (!arg_is_digits8(chunk))
+        {
+            break;
+        }
+        d = arg_swar8(chunk);
+        if (v > (UINT64_MAX - d) / 100000000u)
+        {
+            *overflow = true;
+        }
+        v = v * 100000000u + d;
+        i += 8;
+    }
+    while (i < len && s[i] >= '0' && s[i] <= '9')
+    {
+        uint32_t d = (uint32_t)(s[i] - '0');
+        if (v > (UINT64_MAX - d) / 10u)
+        {
+            *overflow = true;
+        }
+        v = v * 10u + d;
+        i++;
+    }
+    *out = v;
+    return i;
+}
+
+/* 解析十六进制数字，返回消耗的字符数 */
+static size_t arg_hex_digits(const char *s, size_t len, uint64_t *out, bool *overflow)
+{
+    uint64_t v = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        char c = s[i];
+        uint32_t d;
+        if (c >= '0' && c <= '9')
+        {
+            d = (uint32_t)(c - '0');
+        }
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        {
+            d = (uint32_t)((c | 0x20) - 'a' + 10);
+        }
+        else
+        {
+            break;
+        }
+        if (v >> 60)
+        {
+            *overflow = true;
+        }
+        v = (v << 4) | d;
+    }
+    *out = v;
+    return i;
+}
+
+static bool arg_has_hex_prefix(const char *s, size_t len)
+{
+    return len > 2 && s[0] == '0' && (s[1] | 0x20) == 'x';
+}
+
+/* 无符号整数（十进制或 0x 十六进制），返回消耗的字符数 */
+static size_t arg_unsigned(const char *s, size_t len, uint64_t *out, bool *overflow)
+{
+    if (arg_has_hex_prefix(s, len))
+    {
+        size_t n = arg_hex_digits(s + 2, len - 2, out, overflow);
+        return (n > 0) ? n + 2 : 0;
+    }
+    return arg_dec(s, len, out, overflow);
+}
+
+/* 忽略大小写比较 (s, len) 与 NUL 结尾的 word */
+static bool arg_equal_nocase(const char *s, size_t len, const char *word)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        if (word[i] == '\0' || (s[i] | 0x20) != word[i])
+        {
+            return false;
+        }
+    }
+    return word[i] == '\0';
+}
+
+cli_error_t cli_arg_u32(const char *s, size_t len, uint32_t min, uint32_t max, uint32_t *out)
+{
+    uint64_t v;
+    bool overflow = false;
+
+    if (s == NULL || len == 0 || arg_unsigned(s, len, &v, &overflow) != len)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "an unsigned integer");
+    }
+    if (overflow || v < min || v > max)
+    {
+        return arg_fail_range(min, max, false, "");
+    }
+    *out = (uint32_t)v;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_u64(const char *s, size_t len, uint64_t min, uint64_t max, uint64_t *out)
+{
+    uint64_t v;
+    bool overflow = false;
+
+    if (s == NULL || len == 0 || arg_unsigned(s, len, &v, &overflow) != len)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "an unsigned integer");
+    }
+    if (overflow || v < min || v > max)
+    {
+        return arg_fail_range(min, max, false, "");
+    }
+    *out = v;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_i64(const char *s, size_t len, int64_t min, int64_t max, int64_t *out)
+{
+    uint64_t mag;
+    bool overflow = false;
+    bool neg = false;
+    size_t i = 0;
+    int64_t v;
+
+    if (s != NULL && len > 0 && (s[0] == '-' || s[0] == '+'))
+    {
+        neg = (s[0] == '-');
+        i = 1;
+    }
+    if (s == NULL || len == i || arg_unsigned(s + i, len - i, &mag, &overflow) != len - i)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "an integer");
+    }
+    if (overflow || mag > (neg ? (uint64_t)INT64_MAX + 1u : (uint64_t)INT64_MAX))
+    {
+        return arg_fail_range((uint64_t)min, (uint64_t)max, true, "");
+    }
+    v = neg ? (int64_t)(0u - mag) : (int64_t)mag;
+    if (v < min || v > max)
+    {
+        return arg_fail_range((uint64_t)min, (uint64_t)max, true, "");
+    }
+    *out = v;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_hex(const char *s, size_t len, uint64_t max, uint64_t *out)
+{
+    uint64_t v;
+    bool overflow = false;
+
+    if (s != NULL && arg_has_hex_prefix(s, len))
+    {
+        s += 2;
+        len -= 2;
+    }
+    if (s == NULL || len == 0 || arg_hex_digits(s, len, &v, &overflow) != len)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "a hex number");
+    }
+    if (overflow || v > max)
+    {
+        return arg_fail_range(0, max, false, "");
+    }
+    *out = v;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_bool(const char *s, size_t len, bool *out)
+{
+    static const char *const on[] = { "on", "true", "yes", "enable", "1" };
+    static const char *const off[] = { "off", "false", "no", "disable", "0" };
+
+    for (size_t i = 0; s != NULL && i < sizeof(on) / sizeof(on[0]); i++)
+    {
+        if (arg_equal_nocase(s, len, on[i]))
+        {
+            *out = true;
+            return CLI_SUCCESS;
+        }
+        if (arg_equal_nocase(s, len, off[i]))
+        {
+            *out = false;
+            return CLI_SUCCESS;
+        }
+    }
+    return arg_fail(CLI_ERR_INVALID_PARAM, "on/off");
+}
+
+cli_error_t cli_arg_enum(const char *s, size_t len, const char *const *names, int count, int *out)
+{
+    int match = -1;
+
+    for (int i = 0; s != NULL && len > 0 && i < count; i++)
+    {
+        if (strncmp(names[i], s, len) != 0)
+        {
+            continue;
+        }
+        if (names[i][len] == '\0')
+        {
+            /* 完全匹配优先 */
+            match = i;
+            break;
+        }
+        if (match >= 0)
+        {
+            /* 前缀不唯一 */
+            match = -2;
+        }
+        else if (match == -1)
+        {
+            match = i;
+        }
+    }
+    if (match < 0)
+    {
+        arg_fail(CLI_ERR_INVALID_PARAM, NULL);
+        s_arg_fail.names = names;
+        s_arg_fail.count = count;
+        return CLI_ERR_INVALID_PARAM;
+    }
+    *out = match;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_size(const char *s, size_t len, uint64_t min, uint64_t max, uint64_t *out)
+{
+    uint64_t v;
+    bool overflow = false;
+    size_t i = 0;
+    unsigned int shift = 0;
+
+    if (s != NULL && len > 0)
+    {
+        i = arg_unsigned(s, len, &v, &overflow);
+    }
+    if (i == 0)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "a size (k/M/G suffix)");
+    }
+    if (i < len)
+    {
+        switch (s[i])
+        {
+            case 'k':
+            case 'K':
+                shift = 10;
+                i++;
+                break;
+            case 'M':
+                shift = 20;
+                i++;
+                break;
+            case 'G':
+                shift = 30;
+                i++;
+                break;
+            default:
+                break;
+        }
+        if (i < len && s[i] == 'B')
+        {
+            i++;
+        }
+    }
+    if (i != len)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "a size (k/M/G suffix)");
+    }
+    if (overflow || (v << shift) >> shift != v || (v << shift) < min || (v << shift) > max)
+    {
+        return arg_fail_range(min, max, false, "");
+    }
+    *out = v << shift;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_arg_duration(const char *s, size_t len, uint32_t min_ms, uint32_t max_ms, uint32_t *out_ms)
+{
+    static const char *const expect = "a duration (ms/s/m/h)";
+    uint64_t whole = 0;
+    uint64_t frac = 0;
+    uint64_t frac_div = 1;
+    uint64_t unit = 1;
+    uint64_t total;
+    bool overflow = false;
+    size_t i = 0;
+    size_t n;
+
+    if (s == NULL || len == 0)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+    i = arg_dec(s, len, &whole, &overflow);
+    if (i < len && s[i] == '.')
+    {
+        i++;
+        /* 小数部分最多取9位，更多位数低于1ms的分辨率 */
+        for (n = 0; i < len && s[i] >= '0' && s[i] <= '9'; i++, n++)
+        {
+            if (n < 9)
+            {
+                frac = frac * 10u + (uint64_t)(s[i] - '0');
+                frac_div *= 10u;
+            }
+        }
+        if (n == 0)
+        {
+            return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+        }
+    }
+    else if (i == 0)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+
+    if (i == len || (len - i == 2 && s[i] == 'm' && s[i + 1] == 's'))
+    {
+        unit = 1;
+    }
+    else if (len - i == 1 && s[i] == 's')
+    {
+        unit = 1000u;
+    }
+    else if (len - i == 1 && s[i] == 'm')
+    {
+        unit = 60000u;
+    }
+    else if (len - i == 1 && s[i] == 'h')
+    {
+        unit = 3600000u;
+    }
+    else
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+
+    total = whole * unit + frac * unit / frac_div;
+    if (overflow || whole > UINT32_MAX || total < min_ms || total > max_ms)
+    {
+        return arg_fail_range(min_ms, max_ms, false, "ms");
+    }
+    *out_ms = (uint32_t)total;
+    return CLI_SUCCESS;
+}
+
+/* 10 的 2^i 次幂，用于按二进制分解缩放 */
+static const double s_arg_pow10[] = { 1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64 };
+
+/* 最多保留的有效数字位数（不超过 uint64 的范围，远多于单精度所需） */
+#define ARG_FLOAT_DIGITS        19
+
+cli_error_t cli_arg_float(const char *s, size_t len, float *out)
+{
+    static const char *const expect = "a decimal number";
+    uint64_t m = 0;
+    int digits = 0;             /* m 中的有效数字位数 */
+    int e10 = 0;                /* 数值 = m * 10^e10 */
+    int exp = 0;
+    bool neg = false;
+    bool any = false;
+    bool exp_neg = false;
+    size_t i = 0;
+    double v;
+    float f;
+
+    if (s == NULL || len == 0)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+    if (s[0] == '-' || s[0] == '+')
+    {
+        neg = (s[0] == '-');
+        i = 1;
+    }
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+    {
+        any = true;
+        if (digits < ARG_FLOAT_DIGITS)
+        {
+            m = m * 10u + (uint64_t)(s[i] - '0');
+            digits += (m != 0);
+        }
+        else
+        {
+            e10++;
+        }
+    }
+    if (i < len && s[i] == '.')
+    {
+        for (i++; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+        {
+            any = true;
+            if (digits < ARG_FLOAT_DIGITS)
+            {
+                m = m * 10u + (uint64_t)(s[i] - '0');
+                digits += (m != 0);
+                e10--;
+            }
+        }
+    }
+    if (!any)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+    if (i < len && (s[i] == 'e' || s[i] == 'E'))
+    {
+        i++;
+        if (i < len && (s[i] == '-' || s[i] == '+'))
+        {
+            exp_neg = (s[i] == '-');
+            i++;
+        }
+        if (i == len)
+        {
+            return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+        }
+        for (; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+        {
+            if (exp < 10000)
+            {
+                exp = exp * 10 + (s[i] - '0');
+            }
+        }
+    }
+    if (i != len)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, expect);
+    }
+
+    /*
+     * 在双精度中缩放：10^22 以内的幂是精确的，更大的幂只带来几个双精度 ulp
+     * 的误差，转换为单精度时结果与正确舍入至多差1个单精度 ulp（仅在恰好
+     * 接近两个单精度值中点时）
+     */
+    e10 += exp_neg ? -exp : exp;
+    v = (double)m;
+    if (m == 0 || e10 < -(ARG_FLOAT_DIGITS + 46))
+    {
+        v = 0.0;                /* 小于单精度最小的非规格化数 */
+    }
+    else if (e10 > 39)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "a number within float range");
+    }
+    else
+    {
+        unsigned int k = (unsigned int)((e10 < 0) ? -e10 : e10);
+        double scale = 1.0;
+        for (unsigned int b = 0; k != 0; b++, k >>= 1)
+        {
+            if (k & 1u)
+            {
+                scale *= s_arg_pow10[b];
+            }
+        }
+        v = (e10 < 0) ? v / scale : v * scale;
+    }
+    f = (float)(neg ? -v : v);
+    if (f > FLT_MAX || f < -FLT_MAX)
+    {
+        return arg_fail(CLI_ERR_INVALID_PARAM, "a number within float range");
+    }
+    *out = f;
+    return CLI_SUCCESS;
+}
+
+/* 输出64位整数 */
+static void arg_put_u64(uint64_t v, bool is_signed)
+{
+    char buf[21];
+    int i = sizeof(buf);
+
+    if (is_signed && (int64_t)v < 0)
+    {
+        cli_putchar('-');
+        v = 0u - v;
+    }
+    do {
+        buf[--i] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v > 0);
+    cli_write(buf + i, sizeof(buf) - (size_t)i);
+}
+
+void cli_arg_report(const char *what, const char *s, size_t len)
+{
+    cli_style(CLI_STYLE_ERROR);
+    cli_puts(what);
+    cli_puts(": '");
+    cli_write(s, len);
+    if (s_arg_fail.err == CLI_ERR_RANGE)
+    {
+        cli_puts("' out of range (");
+        arg_put_u64(s_arg_fail.min, s_arg_fail.is_signed);
+        cli_puts("..");
+        arg_put_u64(s_arg_fail.max, s_arg_fail.is_signed);
+        cli_puts(s_arg_fail.unit);
+        cli_puts(")");
+        cli_style(CLI_STYLE_NORMAL);
+        cli_puts("\r\n");
+        return;
+    }
+    cli_puts("' is not ");
+    if (s_arg_fail.names != NULL)
+    {
+        cli_puts("one of ");
+        for (int i = 0; i < s_arg_fail.count; i++)
+        {
+            if (i > 0)
+            {
+                cli_putchar('|');
+            }
+            cli_puts(s_arg_fail.names[i]);
+        }
+    }
+    else
+    {
+        cli_puts((s_arg_fail.expect != NULL) ? s_arg_fail.expect : "valid");
+    }
+    cli_style(CLI_STYLE_NORMAL);
+    cli_puts("\r\n");
+}
@@ -0,0 +1,622 @@
+/*
+ * @file cli_audit.c
+ * @brief 会话审计记录实现（仅 Linux）
+ *
+ * 环形缓冲区为单生产者（CLI 线程）单消费者（写线程），位置为自由增长的
+ * 64位计数。每条记录为固定头部 + 数据，可跨越缓冲区末尾。连续的输出先追加到
+ * 一条未发布的记录中，由后台轮询或下一条命令行发布，避免逐字符产生记录。
+ * 写线程在缓冲区过半或超时后被唤醒，格式化为文本行后批量写入。
+ */
+
+#define _GNU_SOURCE
+
+#include <cli_audit.h>
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#define AUDIT_REC_INPUT         1u
+#define AUDIT_REC_OUTPUT        2u
+#define AUDIT_REC_MAX           0xFFFFu         /* 单条记录最大数据长度 */
+#define AUDIT_LINE_MAX          1024u           /* 输出行超过此长度时折行 */
+#define AUDIT_OBUF_SIZE         (128u * 1024u)  /* 写线程的批量写缓冲区 */
+#define AUDIT_OBUF_RESERVE      (AUDIT_LINE_MAX * 4u + 128u)  /* 一行格式化后的最大长度 */
+#define AUDIT_SESSION_LEN       32u
+#define AUDIT_PATH_LEN          256u
+
+#if (CLI_AUDIT_RING_SIZE & (CLI_AUDIT_RING_SIZE - 1u)) != 0
+#error "CLI_AUDIT_RING_SIZE must be a power of 2"
+#endif
+
+/* 记录头部 */
+typedef struct
+{
+    uint16_t type;
+    uint16_t len;
+    uint32_t reserved;
+    uint64_t ms;                        /* CLOCK_REALTIME 毫秒 */
+} au_hdr_t;
+
+static struct
+{
+    bool active;
+    int fd;
+    char session[AUDIT_SESSION_LEN];
+    char *ring;
+    pthread_t thread;
+    sem_t wake;
+
+    /* CLI 线程 */
+    uint64_t wpos;                      /* 写入位置（含未发布的输出记录） */
+    uint64_t open;                      /* 未发布输出记录的头部位置 */
+    uint64_t open_ms;
+    uint32_t open_len;
+    bool open_valid;
+
+    /* 两个线程共享 */
+    uint64_t head;                      /* 已发布位置 */
+    uint64_t tail;                      /* 写线程已取走的位置 */
+    int kicked;                         /* 已唤醒写线程，尚未处理 */
+    int stop;
+
+    /* 统计 */
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t written;
+    uint64_t dropped;
+    uint64_t write_errors;
+
+    /* 写线程 */
+    uint64_t dropped_seen;              /* 已在日志中报告的丢弃字节数 */
+    char line[AUDIT_LINE_MAX];          /* 未结束的输出行 */
+    size_t line_len;
+    uint64_t line_ms;
+    char obuf[AUDIT_OBUF_SIZE];
+    size_t olen;
+} s_au = { .fd = -1 };
+
+static int cmd_audit(int argc, char **argv);
+
+const cli_command_t cli_audit_cmd = {
+    .name = "audit",
+    .short_name = NULL,
+    .help = CLI_HELP("Session transcript: audit [start <path> [name] | stop]"),
+    .handler = cmd_audit
+};
+
+static uint64_t au_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* ---------------- CLI 线程 ---------------- */
+
+static size_t au_free(void)
+{
+    return CLI_AUDIT_RING_SIZE - (size_t)(s_au.wpos - __atomic_load_n(&s_au.tail, __ATOMIC_ACQUIRE));
+}
+
+static void au_copy_in(uint64_t pos, const void *data, size_t len)
+{
+    size_t off = (size_t)pos & (CLI_AUDIT_RING_SIZE - 1u);
+    size_t first = CLI_AUDIT_RING_SIZE - off;
+
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(s_au.ring + off, data, first);
+    memcpy(s_au.ring, (const char *)data + first, len - first);
+}
+
+static void au_drop(size_t len)
+{
+    __atomic_fetch_add(&s_au.dropped, len, __ATOMIC_RELAXED);
+}
+
+/* 结束未发布的输出记录并发布所有已写入的数据 */
+static void au_publish(void)
+{
+    if (s_au.open_valid)
+    {
+        au_hdr_t h = { AUDIT_REC_OUTPUT, (uint16_t)s_au.open_len, 0, s_au.open_ms };
+        au_copy_in(s_au.open, &h, sizeof(h));
+        s_au.open_valid = false;
+        s_au.records++;
+    }
+    if (__atomic_load_n(&s_au.head, __ATOMIC_RELAXED) == s_au.wpos)
+    {
+        return;
+    }
+    __atomic_store_n(&s_au.head, s_au.wpos, __ATOMIC_RELEASE);
+
+    /* 过半时提前唤醒写线程，sem_post 不会阻塞 */
+    if (CLI_AUDIT_RING_SIZE - au_free() >= CLI_AUDIT_RING_SIZE / 2u &&
+        !__atomic_exchange_n(&s_au.kicked, 1, __ATOMIC_ACQ_REL))
+    {
+        sem_post(&s_au.wake);
+    }
+}
+
+static void au_tap(cli_tap_dir_t dir, const char *buf, size_t len)
+{
+    if (dir == CLI_TAP_INPUT)
+    {
+        au_hdr_t h = { AUDIT_REC_INPUT, 0, 0, 0 };
+
+        au_publish();
+        if (len > AUDIT_LINE_MAX)
+        {
+            len = AUDIT_LINE_MAX;
+        }
+        if (au_free() < sizeof(h) + len)
+        {
+            au_drop(len);
+            return;
+        }
+        h.len = (uint16_t)len;
+        h.ms = au_now_ms();
+        au_copy_in(s_au.wpos, &h, sizeof(h));
+        au_copy_in(s_au.wpos + sizeof(h), buf, len);
+        s_au.wpos += sizeof(h) + len;
+        s_au.records++;
+        s_au.bytes += len;
+        au_publish();
+        return;
+    }
+
+    while (len > 0)
+    {
+        size_t n;
+
+        if (!s_au.open_valid)
+        {
+            if (au_free() <= sizeof(au_hdr_t))
+            {
+                au_drop(len);
+                return;
+            }
+            s_au.open = s_au.wpos;
+            s_au.open_ms = au_now_ms();
+            s_au.open_len = 0;
+            s_au.open_valid = true;
+            s_au.wpos += sizeof(au_hdr_t);
+        }
+        n = len;
+        if (n > AUDIT_REC_MAX - s_au.open_len)
+        {
+            n = AUDIT_REC_MAX - s_au.open_len;
+        }
+        if (n > au_free())
+        {
+            n = au_free();
+        }
+        if (n == 0)
+        {
+            if (s_au.open_len == AUDIT_REC_MAX)
+            {
+                au_publish();
+                continue;
+            }
+            au_drop(len);
+            return;
+        }
+        au_copy_in(s_au.wpos, buf, n);
+        s_au.wpos += n;
+        s_au.open_len += (uint32_t)n;
+        s_au.bytes += n;
+        buf += n;
+        len -= n;
+    }
+}
+
+/* 每次主循环发布本轮的输出 */
+static void au_poll(void)
+{
+    if (s_au.active)
+    {
+        au_publish();
+    }
+}
+
+/* ---------------- 写线程 ---------------- */
+
+static void au_flush(void)
+{
+    const char *p = s_au.obuf;
+    size_t len = s_au.olen;
+
+    while (len > 0)
+    {
+        ssize_t n = write(s_au.fd, p, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            __atomic_fetch_add(&s_au.write_errors, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        p += n;
+        len -= (size_t)n;
+        __atomic_fetch_add(&s_au.written, (uint64_t)n, __ATOMIC_RELAXED);
+    }
+    s_au.olen = 0;
+}
+
+/* 开始一行：时间戳、会话名和标记 */
+static void au_line_begin(uint64_t ms, char mark)
+{
+    time_t sec = (time_t)(ms / 1000u);
+    struct tm tm;
+
+    /* 每次 write 只含完整的行 */
+    if (AUDIT_OBUF_SIZE - s_au.olen < AUDIT_OBUF_RESERVE)
+    {
+        au_flush();
+    }
+    gmtime_r(&sec, &tm);
+    s_au.olen += strftime(s_au.obuf + s_au.olen, 32, "%Y-%m-%dT%H:%M:%S", &tm);
+    s_au.olen += (size_t)snprintf(s_au.obuf + s_au.olen, AUDIT_OBUF_SIZE - s_au.olen, ".%03uZ %s %c ",
+                                  (unsigned)(ms % 1000u), s_au.session, mark);
+}
+
+/* 追加文本，控制字符写作 \xHH */
+static void au_line_text(const char *p, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)p[i];
+        if ((c < 0x20 && c != '\t') || c == 0x7F || c == '\\')
+        {
+            s_au.obuf[s_au.olen++] = '\\';
+            if (c == '\\')
+            {
+                s_au.obuf[s_au.olen++] = '\\';
+                continue;
+            }
+            s_au.obuf[s_au.olen++] = 'x';
+            s_au.obuf[s_au.olen++] = hex[c >> 4];
+            s_au.obuf[s_au.olen++] = hex[c & 0x0F];
+        }
+        else
+        {
+            s_au.obuf[s_au.olen++] = (char)c;
+        }
+    }
+    s_au.obuf[s_au.olen++] = '\n';
+}
+
+static void au_line_mark(const char *text)
+{
+    au_line_begin(au_now_ms(), '*');
+    au_line_text(text, strlen(text));
+}
+
+/* 输出未结束的输出行 */
+static void au_line_flush(void)
+{
+    if (s_au.line_len > 0)
+    {
+        au_line_begin(s_au.line_ms, '<');
+        au_line_text(s_au.line, s_au.line_len);
+        s_au.line_len = 0;
+    }
+}
+
+/* 输出数据按行切分，'\r' 省略 */
+static void au_output(const char *p, size_t len, uint64_t ms)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (p[i] == '\n')
+        {
+            if (s_au.line_len == 0)
+            {
+                s_au.line_ms = ms;
+            }
+            au_line_begin(s_au.line_ms, '<');
+            au_line_text(s_au.line, s_au.line_len);
+            s_au.line_len = 0;
+            continue;
+        }
+        if (p[i] == '\r')
+        {
+            continue;
+        }
+        if (s_au.line_len == 0)
+        {
+            s_au.line_ms = ms;
+        }
+        s_au.line[s_au.line_len++] = p[i];
+        if (s_au.line_len == AUDIT_LINE_MAX)
+        {
+            au_line_flush();
+        }
+    }
+}
+
+/* 取出所有已发布的记录 */
+static void au_drain(void)
+{
+    uint64_t head = __atomic_load_n(&s_au.head, __ATOMIC_ACQUIRE);
+    uint64_t tail = s_au.tail;
+    uint64_t dropped;
+
+    while (tail != head)
+    {
+        au_hdr_t h;
+        size_t off;
+        size_t first;
+
+        off = (size_t)tail & (CLI_AUDIT_RING_SIZE - 1u);
+        first = CLI_AUDIT_RING_SIZE - off;
+        if (first >= sizeof(h))
+        {
+            memcpy(&h, s_au.ring + off, sizeof(h));
+        }
+        else
+        {
+            memcpy(&h, s_au.ring + off, first);
+            memcpy((char *)&h + first, s_au.ring, sizeof(h) - first);
+        }
+        tail += sizeof(h);
+
+        off = (size_t)tail & (CLI_AUDIT_RING_SIZE - 1u);
+        first = CLI_AUDIT_RING_SIZE - off;
+        if (first > h.len)
+        {
+            first = h.len;
+        }
+        if (h.type == AUDIT_REC_INPUT)
+        {
+            au_line_flush();
+            au_line_begin(h.ms, '>');
+            /* 命令行不超过 CLI_MAX_LINE_LENGTH，借用行缓冲区拼接跨越末尾的部分 */
+            memcpy(s_au.line, s_au.ring + off, first);
+            memcpy(s_au.line + first, s_au.ring, h.len - first);
+            au_line_text(s_au.line, h.len);
+        }
+        else
+        {
+            au_output(s_au.ring + off, first, h.ms);
+            au_output(s_au.ring, h.len - first, h.ms);
+        }
+        tail += h.len;
+        __atomic_store_n(&s_au.tail, tail, __ATOMIC_RELEASE);
+    }
+
+    dropped = __atomic_load_n(&s_au.dropped, __ATOMIC_RELAXED);
+    if (dropped != s_au.dropped_seen)
+    {
+        char text[48];
+        au_line_flush();
+        snprintf(text, sizeof(text), "dropped %llu bytes", (unsigned long long)(dropped - s_au.dropped_seen));
+        au_line_begin(au_now_ms(), '!');
+        au_line_text(text, strlen(text));
+        s_au.dropped_seen = dropped;
+    }
+}
+
+static void *au_writer(void *arg)
+{
+    (void)arg;
+
+    au_line_mark("start");
+    for (;;)
+    {
+        struct timespec ts;
+        int stop;
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)CLI_AUDIT_FLUSH_MS * 1000000L;
+        ts.tv_sec += ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        while (sem_timedwait(&s_au.wake, &ts) != 0 && errno == EINTR)
+        {
+        }
+
+        stop = __atomic_load_n(&s_au.stop, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&s_au.kicked, 0, __ATOMIC_RELEASE);
+        au_drain();
+        if (stop)
+        {
+            break;
+        }
+        au_flush();
+    }
+    au_line_flush();
+    au_line_mark("stop");
+    au_flush();
+    return NULL;
+}
+
+/* ---------------- 接口 ---------------- */
+
+void cli_audit_init(void)
+{
+    cli_poll_register(au_poll);
+}
+
+cli_error_t cli_audit_start(const char *path, const char *session)
+{
+    static bool s_atexit = false;
+    char full[AUDIT_PATH_LEN];
+    size_t o = 0;
+    sigset_t all;
+    sigset_t old;
+    int err;
+
+    if (path == NULL || path[0] == '\0')
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    cli_audit_stop();
+
+    /* "%p" 替换为进程号 */
+    for (const char *p = path; *p != '\0' && o < sizeof(full) - 1; p++)
+    {
+        if (p[0] == '%' && p[1] == 'p')
+        {
+            o += (size_t)snprintf(full + o, sizeof(full) - o, "%d", (int)getpid());
+            p++;
+        }
+        else
+        {
+            full[o++] = *p;
+        }
+    }
+    full[o < sizeof(full) ? o : sizeof(full) - 1] = '\0';
+
+    if (session != NULL && session[0] != '\0')
+    {
+        snprintf(s_au.session, sizeof(s_au.session), "%s", session);
+    }
+    else
+    {
+        snprintf(s_au.session, sizeof(s_au.session), "%d", (int)getpid());
+    }
+
+    s_au.fd = open(full, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0640);
+    if (s_au.fd < 0)
+    {
+        return CLI_ERR_IO;
+    }
+    s_au.ring = malloc(CLI_AUDIT_RING_SIZE);
+    if (s_au.ring == NULL)
+    {
+        close(s_au.fd);
+        s_au.fd = -1;
+        return CLI_ERR_NO_SPACE;
+    }
+    s_au.wpos = 0;
+    s_au.open_valid = false;
+    s_au.head = 0;
+    s_au.tail = 0;
+    s_au.kicked = 0;
+    s_au.stop = 0;
+    s_au.records = 0;
+    s_au.bytes = 0;
+    s_au.written = 0;
+    s_au.dropped = 0;
+    s_au.write_errors = 0;
+    s_au.dropped_seen = 0;
+    s_au.line_len = 0;
+    s_au.olen = 0;
+    sem_init(&s_au.wake, 0, 0);
+
+    /* 写线程不处理信号，信号仍由主线程处理 */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    err = pthread_create(&s_au.thread, NULL, au_writer, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0)
+    {
+        sem_destroy(&s_au.wake);
+        free(s_au.ring);
+        s_au.ring = NULL;
+        close(s_au.fd);
+        s_au.fd = -1;
+        return CLI_ERR_IO;
+    }
+    pthread_setname_np(s_au.thread, "cli-audit");
+
+    s_au.active = true;
+    cli_set_tap(au_tap);
+    if (!s_atexit)
+    {
+        /* 进程退出时写出剩余数据 */
+        atexit(cli_audit_stop);
+        s_atexit = true;
+    }
+    return CLI_SUCCESS;
+}
+
+void cli_audit_stop(void)
+{
+    if (!s_au.active)
+    {
+        return;
+    }
+    cli_set_tap(NULL);
+    au_publish();
+    s_au.active = false;
+    __atomic_store_n(&s_au.stop, 1, __ATOMIC_RELEASE);
+    sem_post(&s_au.wake);
+    pthread_join(s_au.thread, NULL);
+    sem_destroy(&s_au.wake);
+    close(s_au.fd);
+    s_au.fd = -1;
+    free(s_au.ring);
+    s_au.ring = NULL;
+}
+
+void cli_audit_get_stats(cli_audit_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+    stats->active = s_au.active;
+    stats->records = s_au.records;
+    stats->bytes = s_au.bytes;
+    stats->written = __atomic_load_n(&s_au.written, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&s_au.dropped, __ATOMIC_RELAXED);
+    stats->write_errors = __atomic_load_n(&s_au.write_errors, __ATOMIC_RELAXED);
+}
+
+/* audit 命令 */
+static int cmd_audit(int argc, char **argv)
+{
+    const char *sub = (argc > 1) ? argv[1] : "";
+    cli_audit_stats_t st;
+    char text[192];
+
+    if (strcmp(sub, "start") == 0 && argc > 2)
+    {
+        cli_error_t err = cli_audit_start(argv[2], (argc > 3) ? argv[3] : NULL);
+        if (err != CLI_SUCCESS)
+        {
+            cli_printf("audit: cannot open %s\r\n", argv[2]);
+            return -1;
+        }
+        return 0;
+    }
+    if (strcmp(sub, "stop") == 0)
+    {
+        cli_audit_stop();
+        return 0;
+    }
+    if (argc > 1)
+    {
+        cli_puts("Usage: audit [start <path> [name] | stop]\r\n");
+        return -1;
+    }
+
+    cli_audit_get_stats(&st);
+    cli_printf("%s, session %s\r\n", st.active ? "recording" : "stopped",
+               st.active ? s_au.session : "-");
+    /* cli_printf 不支持 %llu，64位计数先格式化 */
+    snprintf(text, sizeof(text), "records %llu, bytes %llu, written %llu, dropped %llu, write errors %llu\r\n",
+             (unsigned long long)st.records, (unsigned long long)st.bytes, (unsigned long long)st.written,
+             (unsigned long long)st.dropped, (unsigned long long)st.write_errors);
+    cli_puts(text);
+    return 0;
+}
+
+#endif /* __linux__ */
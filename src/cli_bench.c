@@ -0,0 +1,307 @@
+/*
+ * @file cli_bench.c
+ * @brief 设备端微基准实现
+ *
+ * 标定：每轮按 n * 目标时长 * 1.2 / 上一轮耗时 推算下一轮的 n（每轮最多
+ * 增长100倍），直到一轮耗时不短于目标时长。计数器按差值计时，允许回绕。
+ */
+
+#include <cli_bench.h>
+#include <cli_arg.h>
+#include <cli_table.h>
+#include <string.h>
+
+/* 单轮迭代次数上限 */
+#define BENCH_MAX_ITERS     (1u << 30)
+
+volatile uint32_t cli_bench_sink;
+
+/* 基准登记表 */
+static struct
+{
+    const char *name;
+    cli_bench_fn_t fn;
+} s_benches[CLI_BENCH_MAX];
+static int s_bench_count = 0;
+
+/* 计时计数器，NULL 时使用毫秒时钟 */
+static uint32_t (*s_counter)(void) = NULL;
+static uint32_t s_counter_hz = 1000u;
+
+static int cmd_bench(int argc, char **argv);
+
+const cli_command_t cli_bench_cmd = {
+    .name = "bench",
+    .short_name = NULL,
+    .help = CLI_HELP("Micro-benchmarks: bench [name|all] [-t time] [-r runs]"),
+    .handler = cmd_bench
+};
+
+cli_error_t cli_bench_register(const char *name, cli_bench_fn_t fn)
+{
+    int i;
+
+    if (name == NULL || name[0] == '\0' || fn == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < s_bench_count; i++)
+    {
+        if (strcmp(s_benches[i].name, name) == 0)
+        {
+            return CLI_ERR_DUPLICATE;
+        }
+    }
+    if (s_bench_count >= CLI_BENCH_MAX)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    s_benches[s_bench_count].name = name;
+    s_benches[s_bench_count].fn = fn;
+    s_bench_count++;
+    return CLI_SUCCESS;
+}
+
+void cli_bench_set_counter(uint32_t (*read)(void), uint32_t hz)
+{
+    if (read == NULL || hz == 0)
+    {
+        s_counter = NULL;
+        s_counter_hz = 1000u;
+    }
+    else
+    {
+        s_counter = read;
+        s_counter_hz = hz;
+    }
+}
+
+uint32_t cli_bench_counter(uint32_t *hz)
+{
+    if (hz != NULL)
+    {
+        *hz = s_counter_hz;
+    }
+    return (s_counter != NULL) ? s_counter() : cli_get_tick_ms();
+}
+
+static uint32_t bench_now(void)
+{
+    return cli_bench_counter(NULL);
+}
+
+/* 计数换算为纳秒：先分出整秒，避免多轮累计的计数乘以 10^9 后溢出 */
+static uint64_t bench_to_ns(uint64_t counts)
+{
+    uint64_t sec = counts / s_counter_hz;
+    uint64_t rem = counts % s_counter_hz;
+    return sec * 1000000000u + rem * 1000000000u / s_counter_hz;
+}
+
+/* 执行 n 次，返回耗时（计数） */
+static uint32_t bench_time(cli_bench_fn_t fn, uint32_t n)
+{
+    uint32_t start = bench_now();
+    fn(n);
+    return bench_now() - start;
+}
+
+static int bench_find(const char *name)
+{
+    int i;
+
+    for (i = 0; i < s_bench_count; i++)
+    {
+        if (strcmp(s_benches[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+cli_error_t cli_bench_run(const char *name, uint32_t target_ms, uint32_t runs, cli_bench_result_t *result)
+{
+    int idx = (name != NULL) ? bench_find(name) : -1;
+    cli_bench_fn_t fn;
+    uint64_t target64;
+    uint32_t target;
+    uint32_t warmup;
+    uint32_t start;
+    uint32_t n = 1;
+    uint32_t t;
+    uint32_t best;
+    uint64_t total = 0;
+
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    if (result == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    /* 端口未提供时钟时无法计时 */
+    if (s_counter == NULL && !cli_has_clock())
+    {
+        return CLI_ERR_IO;
+    }
+    fn = s_benches[idx].fn;
+    if (target_ms == 0)
+    {
+        target_ms = CLI_BENCH_TARGET_MS;
+    }
+    if (runs == 0)
+    {
+        runs = CLI_BENCH_RUNS;
+    }
+    /* 一轮的计数差不能超过计数器回绕周期的一半 */
+    target64 = (uint64_t)target_ms * s_counter_hz / 1000u;
+    target = (target64 > 0x7FFFFFFFu) ? 0x7FFFFFFFu : (target64 == 0 ? 1u : (uint32_t)target64);
+    warmup = (uint32_t)((uint64_t)CLI_BENCH_WARMUP_MS * s_counter_hz / 1000u);
+
+    /* 预热：缓存、分支预测、惰性初始化 */
+    start = bench_now();
+    do
+    {
+        fn(n);
+        if (n < 1024u)
+        {
+            n *= 2u;
+        }
+    } while (bench_now() - start < warmup);
+
+    /* 标定迭代次数 */
+    n = 1;
+    for (;;)
+    {
+        uint64_t next;
+
+        t = bench_time(fn, n);
+        if (t >= target || n >= BENCH_MAX_ITERS)
+        {
+            break;
+        }
+        next = (t == 0) ? (uint64_t)n * 100u : (uint64_t)n * target * 6u / 5u / t;
+        if (next > (uint64_t)n * 100u)
+        {
+            next = (uint64_t)n * 100u;
+        }
+        if (next <= n)
+        {
+            next = (uint64_t)n + 1u;
+        }
+        n = (next > BENCH_MAX_ITERS) ? BENCH_MAX_ITERS : (uint32_t)next;
+    }
+
+    /* 测量：标定的最后一轮计为第一轮 */
+    best = t;
+    total = t;
+    for (uint32_t r = 1; r < runs; r++)
+    {
+        t = bench_time(fn, n);
+        total += t;
+        if (t < best)
+        {
+            best = t;
+        }
+    }
+
+    result->iterations = n;
+    result->runs = runs;
+    result->best_ns = bench_to_ns(best);
+    result->total_ns = bench_to_ns(total);
+    return CLI_SUCCESS;
+}
+
+/* bench 命令 */
+static int cmd_bench(int argc, char **argv)
+{
+    static const cli_table_col_t list_cols[] = {
+        { "name", CLI_COL_STR, 16, 0, 0 },
+    };
+    static const cli_table_col_t cols[] = {
+        { "name",   CLI_COL_STR,   16, 0, 0 },
+        { "iters",  CLI_COL_UINT,  10, CLI_COL_RIGHT, 0 },
+        { "ns/op",  CLI_COL_FLOAT, 10, CLI_COL_RIGHT, 2 },
+        { "ops/s",  CLI_COL_U64,   12, CLI_COL_RIGHT, 0 },
+        { "avg",    CLI_COL_FLOAT, 10, CLI_COL_RIGHT, 2 },
+    };
+    const char *name = NULL;
+    uint32_t target_ms = 0;
+    uint32_t runs = 0;
+    cli_table_t table;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (cli_arg_duration(CLI_ARG(argv[i]), 1u, 60000u, &target_ms) != CLI_SUCCESS)
+            {
+                cli_arg_report("time", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (cli_arg_u32(CLI_ARG(argv[i]), 1u, 100u, &runs) != CLI_SUCCESS)
+            {
+                cli_arg_report("runs", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        else if (name == NULL && argv[i][0] != '-')
+        {
+            name = argv[i];
+        }
+        else
+        {
+            cli_puts("Usage: bench [name|all] [-t time] [-r runs]\r\n");
+            return -1;
+        }
+    }
+
+    if (name == NULL)
+    {
+        cli_table_begin(&table, list_cols, 1);
+        for (i = 0; i < s_bench_count; i++)
+        {
+            cli_table_row(&table, s_benches[i].name);
+        }
+        cli_table_end(&table);
+        return 0;
+    }
+    if (strcmp(name, "all") != 0 && bench_find(name) < 0)
+    {
+        cli_printf("Unknown benchmark: %s\r\n", name);
+        return -1;
+    }
+
+    cli_table_begin(&table, cols, 5);
+    for (i = 0; i < s_bench_count; i++)
+    {
+        cli_bench_result_t res;
+        cli_error_t err;
+
+        if (strcmp(name, "all") != 0 && strcmp(name, s_benches[i].name) != 0)
+        {
+            continue;
+        }
+        err = cli_bench_run(s_benches[i].name, target_ms, runs, &res);
+        if (err != CLI_SUCCESS)
+        {
+            cli_table_end(&table);
+            cli_puts("No clock for timing\r\n");
+            return -1;
+        }
+        cli_table_row(&table, s_benches[i].name, (unsigned int)res.iterations,
+                      (double)res.best_ns / (double)res.iterations,
+                      (res.best_ns != 0) ? (uint64_t)res.iterations * 1000000000u / res.best_ns : (uint64_t)0,
+                      (double)res.total_ns / ((double)res.iterations * (double)res.runs));
+    }
+    cli_table_end(&table);
+    return 0;
+}
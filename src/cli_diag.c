@@ -0,0 +1,419 @@
+/*
+ * @file cli_diag.c
+ * @brief 进程诊断命令实现（仅 Linux）
+ *
+ * /proc 文件通过目录描述符 openat 打开，避免重复解析路径；每个文件读入
+ * 静态缓冲区后就地解析，不经过 stdio。主循环统计由后台轮询维护，
+ * 每次轮询只有一次 clock_gettime（vDSO，不进入内核）。
+ */
+
+#include <cli_diag.h>
+
+#if defined(__linux__)
+
+#include <cli_table.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <malloc.h>
+#include <time.h>
+
+/* 统计窗口长度 */
+#define DIAG_LOOP_WINDOW_NS     1000000000ull
+
+/* /proc 文件读缓冲区 */
+#define DIAG_BUF_SIZE           4096
+
+/* malloc 统计：glibc 2.33 起提供64位字段的 mallinfo2 */
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define DIAG_MALLINFO()         mallinfo2()
+#else
+#define DIAG_MALLINFO()         mallinfo()
+#endif
+
+/* 主循环统计状态 */
+static struct
+{
+    uint64_t last_ns;           /* 上一次轮询时刻 */
+    uint64_t win_start_ns;      /* 当前窗口起点 */
+    uint64_t win_iters;         /* 当前窗口轮询次数 */
+    uint64_t win_max_ns;        /* 当前窗口最大间隔 */
+    cli_diag_loop_stats_t stats;
+} s_loop;
+
+static char s_buf[DIAG_BUF_SIZE];
+
+static int cmd_ps(int argc, char **argv);
+static int cmd_mem(int argc, char **argv);
+static int cmd_fds(int argc, char **argv);
+static int cmd_loop(int argc, char **argv);
+
+const cli_command_t cli_diag_ps_cmd = {
+    .name = "ps",
+    .short_name = NULL,
+    .help = CLI_HELP("List threads with CPU time"),
+    .handler = cmd_ps
+};
+
+const cli_command_t cli_diag_mem_cmd = {
+    .name = "mem",
+    .short_name = NULL,
+    .help = CLI_HELP("Show RSS and malloc statistics"),
+    .handler = cmd_mem
+};
+
+const cli_command_t cli_diag_fds_cmd = {
+    .name = "fds",
+    .short_name = NULL,
+    .help = CLI_HELP("List open file descriptors"),
+    .handler = cmd_fds
+};
+
+const cli_command_t cli_diag_loop_cmd = {
+    .name = "loop",
+    .short_name = NULL,
+    .help = CLI_HELP("Main loop rate and lag: loop [reset]"),
+    .handler = cmd_loop
+};
+
+static uint64_t diag_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* 后台轮询：记录相邻两次调用的间隔，每个窗口结束时更新频率和延迟 */
+static void diag_loop_poll(void)
+{
+    uint64_t now = diag_now_ns();
+
+    if (s_loop.last_ns != 0)
+    {
+        uint64_t gap = now - s_loop.last_ns;
+        if (gap > s_loop.win_max_ns)
+        {
+            s_loop.win_max_ns = gap;
+        }
+    }
+    else
+    {
+        s_loop.win_start_ns = now;
+    }
+    s_loop.last_ns = now;
+    s_loop.win_iters++;
+    s_loop.stats.iterations++;
+
+    if (now - s_loop.win_start_ns >= DIAG_LOOP_WINDOW_NS)
+    {
+        s_loop.stats.rate = (double)s_loop.win_iters * 1e9 / (double)(now - s_loop.win_start_ns);
+        s_loop.stats.lag_us = s_loop.win_max_ns / 1000u;
+        if (s_loop.stats.lag_us > s_loop.stats.worst_us)
+        {
+            s_loop.stats.worst_us = s_loop.stats.lag_us;
+        }
+        s_loop.win_start_ns = now;
+        s_loop.win_iters = 0;
+        s_loop.win_max_ns = 0;
+    }
+}
+
+void cli_diag_init(void)
+{
+    memset(&s_loop, 0, sizeof(s_loop));
+    cli_poll_register(diag_loop_poll);
+}
+
+void cli_diag_get_loop_stats(cli_diag_loop_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = s_loop.stats;
+    }
+}
+
+/* 读取 dir 下的文件到 s_buf 并以 NUL 结尾，返回长度，失败返回 -1 */
+static ssize_t diag_read_at(int dir, const char *path)
+{
+    size_t n = 0;
+    int fd = openat(dir, path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+    /* /proc 文件通常一次读完，读到 0 为止以防内容超过一页 */
+    while (n < sizeof(s_buf) - 1)
+    {
+        ssize_t r = read(fd, s_buf + n, sizeof(s_buf) - 1 - n);
+        if (r <= 0)
+        {
+            break;
+        }
+        n += (size_t)r;
+    }
+    close(fd);
+    s_buf[n] = '\0';
+    return (ssize_t)n;
+}
+
+/* 解析十进制数并跳过其后的空白 */
+static uint64_t diag_parse_u64(const char **p)
+{
+    const char *s = *p;
+    uint64_t v = 0;
+
+    while (*s >= '0' && *s <= '9')
+    {
+        v = v * 10u + (uint64_t)(*s - '0');
+        s++;
+    }
+    while (*s == ' ' || *s == '\t')
+    {
+        s++;
+    }
+    *p = s;
+    return v;
+}
+
+/* 跳过 count 个以空格分隔的字段 */
+static const char *diag_skip_fields(const char *s, int count)
+{
+    while (count-- > 0 && *s != '\0')
+    {
+        while (*s != ' ' && *s != '\0')
+        {
+            s++;
+        }
+        while (*s == ' ')
+        {
+            s++;
+        }
+    }
+    return s;
+}
+
+/* ps 命令 */
+static int cmd_ps(int argc, char **argv)
+{
+    static const cli_table_col_t cols[] = {
+        { "tid",   CLI_COL_INT,   6, CLI_COL_RIGHT, 0 },
+        { "state", CLI_COL_STR,   0, 0, 0 },
+        { "user",  CLI_COL_FLOAT, 8, CLI_COL_RIGHT, 2 },
+        { "sys",   CLI_COL_FLOAT, 8, CLI_COL_RIGHT, 2 },
+        { "cpu",   CLI_COL_INT,   0, CLI_COL_RIGHT, 0 },
+        { "name",  CLI_COL_STR,   0, 0, 0 },
+    };
+    double tick = 1.0 / (double)sysconf(_SC_CLK_TCK);
+    cli_table_t table;
+    struct dirent *e;
+    DIR *dir;
+
+    (void)argc;
+    (void)argv;
+    dir = opendir("/proc/self/task");
+    if (dir == NULL)
+    {
+        cli_puts("Cannot open /proc/self/task\r\n");
+        return -1;
+    }
+    cli_table_begin(&table, cols, 6);
+    while ((e = readdir(dir)) != NULL)
+    {
+        char path[32];
+        size_t len = strlen(e->d_name);
+        const char *name;
+        const char *p;
+        char *end;
+        char state[2];
+        uint64_t utime;
+        uint64_t stime;
+        uint64_t cpu;
+
+        if (e->d_name[0] < '0' || e->d_name[0] > '9' || len + sizeof("/stat") > sizeof(path))
+        {
+            continue;
+        }
+        memcpy(path, e->d_name, len);
+        memcpy(path + len, "/stat", sizeof("/stat"));
+        if (diag_read_at(dirfd(dir), path) <= 0)
+        {
+            continue;
+        }
+
+        /* tid (comm) state ...：comm 可能含空格和括号，以最后一个 ')' 为界 */
+        name = strchr(s_buf, '(');
+        end = strrchr(s_buf, ')');
+        if (name == NULL || end == NULL || end < name || end[1] != ' ')
+        {
+            continue;
+        }
+        *end = '\0';
+        name++;
+        p = end + 2;
+        state[0] = *p;
+        state[1] = '\0';
+        /* 字段编号见 proc(5)：state 为第3个，utime/stime 为第14/15个，processor 为第39个 */
+        p = diag_skip_fields(p, 11);
+        utime = diag_parse_u64(&p);
+        stime = diag_parse_u64(&p);
+        p = diag_skip_fields(p, 23);
+        cpu = diag_parse_u64(&p);
+
+        cli_table_row(&table, (int)strtol(e->d_name, NULL, 10), state,
+                      (double)utime * tick, (double)stime * tick, (int)cpu, name);
+    }
+    closedir(dir);
+    cli_table_end(&table);
+    return 0;
+}
+
+/* 在 /proc/self/status 内容中查找 "key:" 行，返回其数值（kB 转为字节），不存在返回 false */
+static bool diag_status_kb(const char *key, uint64_t *bytes)
+{
+    size_t len = strlen(key);
+    const char *p = s_buf;
+
+    while (p != NULL && *p != '\0')
+    {
+        if (strncmp(p, key, len) == 0 && p[len] == ':')
+        {
+            p += len + 1;
+            while (*p == ' ' || *p == '\t')
+            {
+                p++;
+            }
+            *bytes = diag_parse_u64(&p) * 1024u;
+            return true;
+        }
+        p = strchr(p, '\n');
+        if (p != NULL)
+        {
+            p++;
+        }
+    }
+    return false;
+}
+
+/* mem 命令 */
+static int cmd_mem(int argc, char **argv)
+{
+    static const cli_table_col_t cols[] = {
+        { "item",  CLI_COL_STR, 16, 0, 0 },
+        { "bytes", CLI_COL_U64, 12, CLI_COL_RIGHT, 0 },
+    };
+    /* /proc/self/status 中的键及显示名 */
+    static const char *const keys[][2] = {
+        { "VmSize",  "vm_size" },
+        { "VmRSS",   "rss" },
+        { "VmHWM",   "rss_peak" },
+        { "RssAnon", "rss_anon" },
+        { "RssFile", "rss_file" },
+        { "VmData",  "data" },
+        { "VmSwap",  "swap" },
+    };
+    cli_table_t table;
+    uint64_t v;
+
+    (void)argc;
+    (void)argv;
+    cli_table_begin(&table, cols, 2);
+    if (diag_read_at(AT_FDCWD, "/proc/self/status") > 0)
+    {
+        for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+        {
+            if (diag_status_kb(keys[i][0], &v))
+            {
+                cli_table_row(&table, keys[i][1], v);
+            }
+        }
+    }
+    {
+        /* 所有 arena 的合计 */
+        __typeof__(DIAG_MALLINFO()) mi = DIAG_MALLINFO();
+        cli_table_row(&table, "heap_arena", (uint64_t)mi.arena);
+        cli_table_row(&table, "heap_mmap", (uint64_t)mi.hblkhd);
+        cli_table_row(&table, "heap_used", (uint64_t)mi.uordblks);
+        cli_table_row(&table, "heap_free", (uint64_t)mi.fordblks);
+        cli_table_row(&table, "heap_releasable", (uint64_t)mi.keepcost);
+    }
+    cli_table_end(&table);
+    return 0;
+}
+
+/* fds 命令 */
+static int cmd_fds(int argc, char **argv)
+{
+    static const cli_table_col_t cols[] = {
+        { "fd",     CLI_COL_INT, 4, CLI_COL_RIGHT, 0 },
+        { "target", CLI_COL_STR, 0, 0, 0 },
+    };
+    cli_table_t table;
+    struct dirent *e;
+    DIR *dir;
+
+    (void)argc;
+    (void)argv;
+    dir = opendir("/proc/self/fd");
+    if (dir == NULL)
+    {
+        cli_puts("Cannot open /proc/self/fd\r\n");
+        return -1;
+    }
+    cli_table_begin(&table, cols, 2);
+    while ((e = readdir(dir)) != NULL)
+    {
+        int fd;
+        ssize_t n;
+
+        if (e->d_name[0] < '0' || e->d_name[0] > '9')
+        {
+            continue;
+        }
+        fd = (int)strtol(e->d_name, NULL, 10);
+        if (fd == dirfd(dir))
+        {
+            /* 跳过遍历用的目录本身 */
+            continue;
+        }
+        n = readlinkat(dirfd(dir), e->d_name, s_buf, sizeof(s_buf) - 1);
+        s_buf[(n > 0) ? n : 0] = '\0';
+        cli_table_row(&table, fd, s_buf);
+    }
+    closedir(dir);
+    cli_table_end(&table);
+    return 0;
+}
+
+/* loop 命令 */
+static int cmd_loop(int argc, char **argv)
+{
+    static const cli_table_col_t cols[] = {
+        { "rate",       CLI_COL_FLOAT, 10, CLI_COL_RIGHT, 1 },
+        { "lag_us",     CLI_COL_U64,   8, CLI_COL_RIGHT, 0 },
+        { "worst_us",   CLI_COL_U64,   8, CLI_COL_RIGHT, 0 },
+        { "iterations", CLI_COL_U64,   12, CLI_COL_RIGHT, 0 },
+    };
+    cli_table_t table;
+
+    if (argc >= 2)
+    {
+        if (strcmp(argv[1], "reset") != 0)
+        {
+            cli_puts("Usage: loop [reset]\r\n");
+            return -1;
+        }
+        s_loop.stats.worst_us = 0;
+        return 0;
+    }
+    cli_table_begin(&table, cols, 4);
+    cli_table_row(&table, s_loop.stats.rate, s_loop.stats.lag_us,
+                  s_loop.stats.worst_us, s_loop.stats.iterations);
+    cli_table_end(&table);
+    return 0;
+}
+
+#endif /* __linux__ */
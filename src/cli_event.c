@@ -0,0 +1,462 @@
+/*
+ * @file cli_event.c
+ * @brief 事件发布/订阅实现
+ *
+ * 索引表按事件名开放寻址，每项记录：匹配的订阅者位图（订阅变化时重算）、
+ * 待投递位图、每个订阅者的合并计数和最新值。发布 = 哈希 + 查表 + 置位，
+ * 与订阅者数和模式数无关。
+ */
+
+#include <cli_event.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* 订阅者 */
+typedef struct
+{
+    cli_event_handler_t handler;        /* NULL 表示空闲 */
+    void *ctx;
+    uint32_t last_ms;                   /* 上次投递时刻 */
+} ev_sub_t;
+
+/* 模式 */
+typedef struct
+{
+    char text[CLI_EVENT_NAME_LEN];      /* 空串表示空闲 */
+    uint8_t sub;                        /* 所属订阅者 */
+} ev_pattern_t;
+
+/* 索引表项 */
+typedef struct
+{
+    char name[CLI_EVENT_NAME_LEN];      /* 空串表示空闲 */
+    uint32_t hash;
+    uint32_t match;                     /* 匹配的订阅者 */
+    uint32_t pending;                   /* 有待投递的订阅者 */
+    uint32_t count[CLI_EVENT_MAX_SUBS]; /* 各订阅者合并的发布次数 */
+    char value[CLI_EVENT_VALUE_LEN];    /* 最新值 */
+} ev_name_t;
+
+static struct
+{
+    ev_sub_t subs[CLI_EVENT_MAX_SUBS];
+    ev_pattern_t patterns[CLI_EVENT_MAX_PATTERNS];
+    ev_name_t names[CLI_EVENT_MAX_NAMES];
+    uint32_t pending;                   /* 有待投递事件的订阅者 */
+    cli_event_stats_t stats;
+} s_ev;
+
+static int cmd_subscribe(int argc, char **argv);
+static int cmd_unsubscribe(int argc, char **argv);
+static void ev_session_deliver(const char *name, const char *value, uint32_t count, void *ctx);
+
+const cli_command_t cli_event_subscribe_cmd = {
+    .name = "subscribe",
+    .short_name = NULL,
+    .help = CLI_HELP("Receive events: subscribe [pattern]"),
+    .handler = cmd_subscribe
+};
+
+const cli_command_t cli_event_unsubscribe_cmd = {
+    .name = "unsubscribe",
+    .short_name = NULL,
+    .help = CLI_HELP("Stop receiving events: unsubscribe [pattern]"),
+    .handler = cmd_unsubscribe
+};
+
+/* FNV-1a */
+static uint32_t ev_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s != '\0')
+    {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+/* 通配匹配：'*' 任意长度，'?' 单个字符（回溯到最近的 '*'） */
+static bool ev_match(const char *pat, const char *name)
+{
+    const char *star = NULL;
+    const char *resume = NULL;
+
+    while (*name != '\0')
+    {
+        if (*pat == '*')
+        {
+            star = pat++;
+            resume = name;
+        }
+        else if (*pat == '?' || *pat == *name)
+        {
+            pat++;
+            name++;
+        }
+        else if (star != NULL)
+        {
+            pat = star + 1;
+            name = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (*pat == '*')
+    {
+        pat++;
+    }
+    return *pat == '\0';
+}
+
+/* 计算匹配某事件名的订阅者 */
+static uint32_t ev_match_all(const char *name)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < CLI_EVENT_MAX_PATTERNS; i++)
+    {
+        const ev_pattern_t *p = &s_ev.patterns[i];
+        if (p->text[0] != '\0' && !(mask & (1u << p->sub)) && ev_match(p->text, name))
+        {
+            mask |= 1u << p->sub;
+        }
+    }
+    return mask;
+}
+
+/* 订阅变化后重建索引，取消订阅的待投递事件一并清除 */
+static void ev_reindex(void)
+{
+    s_ev.pending = 0;
+    for (int i = 0; i < CLI_EVENT_MAX_NAMES; i++)
+    {
+        ev_name_t *e = &s_ev.names[i];
+        if (e->name[0] == '\0')
+        {
+            continue;
+        }
+        e->match = ev_match_all(e->name);
+        e->pending &= e->match;
+        for (int k = 0; k < CLI_EVENT_MAX_SUBS; k++)
+        {
+            if (!(e->pending & (1u << k)))
+            {
+                e->count[k] = 0;
+            }
+        }
+        s_ev.pending |= e->pending;
+    }
+}
+
+/* 查找事件名，不存在时登记；表满返回 NULL */
+static ev_name_t *ev_lookup(const char *name)
+{
+    uint32_t h = ev_hash(name);
+    uint32_t i = h & (CLI_EVENT_MAX_NAMES - 1u);
+
+    for (uint32_t n = 0; n < CLI_EVENT_MAX_NAMES; n++)
+    {
+        ev_name_t *e = &s_ev.names[i];
+        if (e->name[0] == '\0')
+        {
+            strncpy(e->name, name, CLI_EVENT_NAME_LEN - 1);
+            e->name[CLI_EVENT_NAME_LEN - 1] = '\0';
+            e->hash = h;
+            e->match = ev_match_all(e->name);
+            s_ev.stats.names++;
+            return e;
+        }
+        if (e->hash == h && strncmp(e->name, name, CLI_EVENT_NAME_LEN - 1) == 0)
+        {
+            return e;
+        }
+        i = (i + 1u) & (CLI_EVENT_MAX_NAMES - 1u);
+    }
+    return NULL;
+}
+
+void cli_event_publish(const char *name, const char *value)
+{
+    ev_name_t *e;
+    uint32_t match;
+
+    if (name == NULL || name[0] == '\0')
+    {
+        return;
+    }
+    s_ev.stats.published++;
+    e = ev_lookup(name);
+    if (e == NULL)
+    {
+        s_ev.stats.dropped++;
+        return;
+    }
+    match = e->match;
+    if (match == 0)
+    {
+        return;
+    }
+
+    /* 最新值覆盖旧值，每个匹配的订阅者计数加一 */
+    if (value == NULL)
+    {
+        value = "";
+    }
+    strncpy(e->value, value, CLI_EVENT_VALUE_LEN - 1);
+    e->value[CLI_EVENT_VALUE_LEN - 1] = '\0';
+    e->pending |= match;
+    s_ev.pending |= match;
+    for (int k = 0; match != 0; k++, match >>= 1)
+    {
+        if (match & 1u)
+        {
+            e->count[k]++;
+        }
+    }
+}
+
+/* 查找订阅者 */
+static int ev_find_sub(cli_event_handler_t handler, void *ctx)
+{
+    for (int k = 0; k < CLI_EVENT_MAX_SUBS; k++)
+    {
+        if (s_ev.subs[k].handler == handler && s_ev.subs[k].ctx == ctx)
+        {
+            return k;
+        }
+    }
+    return -1;
+}
+
+cli_error_t cli_event_subscribe(const char *pattern, cli_event_handler_t handler, void *ctx)
+{
+    int sub;
+    int slot = -1;
+
+    if (pattern == NULL || handler == NULL || pattern[0] == '\0' ||
+        strlen(pattern) >= CLI_EVENT_NAME_LEN)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+
+    sub = ev_find_sub(handler, ctx);
+    for (int i = 0; i < CLI_EVENT_MAX_PATTERNS; i++)
+    {
+        const ev_pattern_t *p = &s_ev.patterns[i];
+        if (p->text[0] == '\0')
+        {
+            if (slot < 0)
+            {
+                slot = i;
+            }
+        }
+        else if (sub >= 0 && p->sub == sub && strcmp(p->text, pattern) == 0)
+        {
+            return CLI_ERR_DUPLICATE;
+        }
+    }
+    if (slot < 0)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    if (sub < 0)
+    {
+        sub = ev_find_sub(NULL, NULL);
+        if (sub < 0)
+        {
+            return CLI_ERR_TABLE_FULL;
+        }
+        s_ev.subs[sub].handler = handler;
+        s_ev.subs[sub].ctx = ctx;
+        s_ev.subs[sub].last_ms = cli_get_tick_ms() - CLI_EVENT_INTERVAL_MS;
+    }
+
+    strcpy(s_ev.patterns[slot].text, pattern);
+    s_ev.patterns[slot].sub = (uint8_t)sub;
+    ev_reindex();
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_event_unsubscribe(const char *pattern, cli_event_handler_t handler, void *ctx)
+{
+    int sub = ev_find_sub(handler, ctx);
+    bool found = false;
+    bool left = false;
+
+    if (handler == NULL || sub < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    for (int i = 0; i < CLI_EVENT_MAX_PATTERNS; i++)
+    {
+        ev_pattern_t *p = &s_ev.patterns[i];
+        if (p->text[0] == '\0' || p->sub != sub)
+        {
+            continue;
+        }
+        if (pattern == NULL || strcmp(p->text, pattern) == 0)
+        {
+            p->text[0] = '\0';
+            found = true;
+        }
+        else
+        {
+            left = true;
+        }
+    }
+    if (!found)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    /* 没有模式的订阅者释放位置 */
+    if (!left)
+    {
+        s_ev.subs[sub].handler = NULL;
+        s_ev.subs[sub].ctx = NULL;
+    }
+    ev_reindex();
+    return CLI_SUCCESS;
+}
+
+void cli_event_get_stats(cli_event_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = s_ev.stats;
+    }
+}
+
+/* 后台投递：到期的订阅者一次取走全部待投递事件 */
+static void ev_poll(void)
+{
+    uint32_t now;
+
+    if (s_ev.pending == 0)
+    {
+        return;
+    }
+    now = cli_get_tick_ms();
+    for (int k = 0; k < CLI_EVENT_MAX_SUBS; k++)
+    {
+        ev_sub_t *sub = &s_ev.subs[k];
+        uint32_t bit = 1u << k;
+
+        if (!(s_ev.pending & bit) || (uint32_t)(now - sub->last_ms) < CLI_EVENT_INTERVAL_MS)
+        {
+            continue;
+        }
+        /* 会话在命令接管输入时（流输出、文件传输）不插入文本 */
+        if (sub->handler == ev_session_deliver && cli_input_is_acquired())
+        {
+            continue;
+        }
+        s_ev.pending &= ~bit;
+        sub->last_ms = now;
+        for (int i = 0; i < CLI_EVENT_MAX_NAMES; i++)
+        {
+            ev_name_t *e = &s_ev.names[i];
+            uint32_t count;
+
+            if (!(e->pending & bit))
+            {
+                continue;
+            }
+            count = e->count[k];
+            e->pending &= ~bit;
+            e->count[k] = 0;
+            s_ev.stats.delivered++;
+            s_ev.stats.coalesced += count - 1u;
+            sub->handler(e->name, e->value, count, sub->ctx);
+        }
+    }
+    cli_async_end();
+}
+
+void cli_event_init(void)
+{
+    memset(&s_ev, 0, sizeof(s_ev));
+    cli_poll_register(ev_poll);
+}
+
+/* 会话订阅者：清除输入行后逐行输出，全部投递完由 ev_poll 重绘输入行 */
+static void ev_session_deliver(const char *name, const char *value, uint32_t count, void *ctx)
+{
+    (void)ctx;
+    cli_async_begin();
+    if (cli_get_automation())
+    {
+        cli_printf("@@event %s %u %s\r\n", name, (unsigned)count, value);
+    }
+    else
+    {
+        cli_printf("[event] %s", name);
+        if (value[0] != '\0')
+        {
+            cli_printf(" = %s", value);
+        }
+        if (count > 1)
+        {
+            cli_printf(" (x%u)", (unsigned)count);
+        }
+        cli_puts("\r\n");
+    }
+}
+
+/* subscribe 命令 */
+static int cmd_subscribe(int argc, char **argv)
+{
+    cli_error_t err;
+    int sub;
+
+    if (argc < 2)
+    {
+        sub = ev_find_sub(ev_session_deliver, NULL);
+        for (int i = 0; sub >= 0 && i < CLI_EVENT_MAX_PATTERNS; i++)
+        {
+            if (s_ev.patterns[i].text[0] != '\0' && s_ev.patterns[i].sub == sub)
+            {
+                cli_printf("%s\r\n", s_ev.patterns[i].text);
+            }
+        }
+        cli_printf("published %u, delivered %u, coalesced %u, dropped %u, names %u/%u\r\n",
+                   (unsigned)s_ev.stats.published, (unsigned)s_ev.stats.delivered,
+                   (unsigned)s_ev.stats.coalesced, (unsigned)s_ev.stats.dropped,
+                   (unsigned)s_ev.stats.names, (unsigned)CLI_EVENT_MAX_NAMES);
+        return 0;
+    }
+
+    err = cli_event_subscribe(argv[1], ev_session_deliver, NULL);
+    if (err == CLI_ERR_DUPLICATE)
+    {
+        cli_printf("Already subscribed: %s\r\n", argv[1]);
+        return 0;
+    }
+    if (err == CLI_ERR_TABLE_FULL)
+    {
+        cli_puts("Too many subscriptions\r\n");
+        return -1;
+    }
+    if (err != CLI_SUCCESS)
+    {
+        cli_printf("Invalid pattern: %s\r\n", argv[1]);
+        return -1;
+    }
+    return 0;
+}
+
+/* unsubscribe 命令 */
+static int cmd_unsubscribe(int argc, char **argv)
+{
+    const char *pattern = (argc > 1) ? argv[1] : NULL;
+
+    if (cli_event_unsubscribe(pattern, ev_session_deliver, NULL) != CLI_SUCCESS)
+    {
+        if (pattern != NULL)
+        {
+            cli_printf("Not subscribed: %s\r\n", pattern);
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,822 @@
+/*
+ * @file cli_fmt.c
+ * @brief 浮点数格式化实现
+ *
+ * 最短表示：Grisu2（Loitsch, "Printing Floating-Point Numbers Quickly and
+ * Accurately with Integers"），只用64位整数运算和一张87项的10的幂缓存表。
+ * 单精度值按单精度的舍入边界生成数字，因此 0.1f 得到 "0.1" 而非
+ * "0.100000001"。
+ *
+ * 指定精度：精度不超过6的 %f 放大为整数后按精确积舍入；最短数字串不超过
+ * 所需位数且所需位数不超过15时（正规数），最短数字串补零即为正确舍入的
+ * 结果（15位十进制间隔大于两个 ulp）；其余情况用大整数按精确值逐位生成，
+ * 恰在中点时舍入到偶数。三种情况都与 libc 的结果一致。
+ */
+
+#include <cli_fmt.h>
+#include <stdint.h>
+#include <string.h>
+
+/* 64位尾数 + 二进制指数：值为 f * 2^e */
+typedef struct
+{
+    uint64_t f;
+    int e;
+} fmt_fp_t;
+
+/* 十进制数字串：值为 0.d[0]d[1]...d[n-1] * 10^dp（%f 最多 17+17 位） */
+typedef struct
+{
+    char d[40];
+    int n;
+    int dp;
+} fmt_dec_t;
+
+/* 大整数（32位字，低位在前），容纳 2^1074 和 2^52 * 10^324 再乘10 */
+#define FMT_BIG_WORDS           40
+
+typedef struct
+{
+    uint32_t w[FMT_BIG_WORDS];
+    int n;                              /* 有效字数 */
+} fmt_big_t;
+
+/* 10^k 的归一化近似，k = -348 + 8 * i */
+static const fmt_fp_t s_cached_pow[] = {
+    { 0xfa8fd5a0081c0288ull, -1220 }, { 0xbaaee17fa23ebf76ull, -1193 }, { 0x8b16fb203055ac76ull, -1166 },
+    { 0xcf42894a5dce35eaull, -1140 }, { 0x9a6bb0aa55653b2dull, -1113 }, { 0xe61acf033d1a45dfull, -1087 },
+    { 0xab70fe17c79ac6caull, -1060 }, { 0xff77b1fcbebcdc4full, -1034 }, { 0xbe5691ef416bd60cull, -1007 },
+    { 0x8dd01fad907ffc3cull, -980 }, { 0xd3515c2831559a83ull, -954 }, { 0x9d71ac8fada6c9b5ull, -927 },
+    { 0xea9c227723ee8bcbull, -901 }, { 0xaecc49914078536dull, -874 }, { 0x823c12795db6ce57ull, -847 },
+    { 0xc21094364dfb5637ull, -821 }, { 0x9096ea6f3848984full, -794 }, { 0xd77485cb25823ac7ull, -768 },
+    { 0xa086cfcd97bf97f4ull, -741 }, { 0xef340a98172aace5ull, -715 }, { 0xb23867fb2a35b28eull, -688 },
+    { 0x84c8d4dfd2c63f3bull, -661 }, { 0xc5dd44271ad3cdbaull, -635 }, { 0x936b9fcebb25c996ull, -608 },
+    { 0xdbac6c247d62a584ull, -582 }, { 0xa3ab66580d5fdaf6ull, -555 }, { 0xf3e2f893dec3f126ull, -529 },
+    { 0xb5b5ada8aaff80b8ull, -502 }, { 0x87625f056c7c4a8bull, -475 }, { 0xc9bcff6034c13053ull, -449 },
+    { 0x964e858c91ba2655ull, -422 }, { 0xdff9772470297ebdull, -396 }, { 0xa6dfbd9fb8e5b88full, -369 },
+    { 0xf8a95fcf88747d94ull, -343 }, { 0xb94470938fa89bcfull, -316 }, { 0x8a08f0f8bf0f156bull, -289 },
+    { 0xcdb02555653131b6ull, -263 }, { 0x993fe2c6d07b7facull, -236 }, { 0xe45c10c42a2b3b06ull, -210 },
+    { 0xaa242499697392d3ull, -183 }, { 0xfd87b5f28300ca0eull, -157 }, { 0xbce5086492111aebull, -130 },
+    { 0x8cbccc096f5088ccull, -103 }, { 0xd1b71758e219652cull, -77 }, { 0x9c40000000000000ull, -50 },
+    { 0xe8d4a51000000000ull, -24 }, { 0xad78ebc5ac620000ull, 3 }, { 0x813f3978f8940984ull, 30 },
+    { 0xc097ce7bc90715b3ull, 56 }, { 0x8f7e32ce7bea5c70ull, 83 }, { 0xd5d238a4abe98068ull, 109 },
+    { 0x9f4f2726179a2245ull, 136 }, { 0xed63a231d4c4fb27ull, 162 }, { 0xb0de65388cc8ada8ull, 189 },
+    { 0x83c7088e1aab65dbull, 216 }, { 0xc45d1df942711d9aull, 242 }, { 0x924d692ca61be758ull, 269 },
+    { 0xda01ee641a708deaull, 295 }, { 0xa26da3999aef774aull, 322 }, { 0xf209787bb47d6b85ull, 348 },
+    { 0xb454e4a179dd1877ull, 375 }, { 0x865b86925b9bc5c2ull, 402 }, { 0xc83553c5c8965d3dull, 428 },
+    { 0x952ab45cfa97a0b3ull, 455 }, { 0xde469fbd99a05fe3ull, 481 }, { 0xa59bc234db398c25ull, 508 },
+    { 0xf6c69a72a3989f5cull, 534 }, { 0xb7dcbf5354e9beceull, 561 }, { 0x88fcf317f22241e2ull, 588 },
+    { 0xcc20ce9bd35c78a5ull, 614 }, { 0x98165af37b2153dfull, 641 }, { 0xe2a0b5dc971f303aull, 667 },
+    { 0xa8d9d1535ce3b396ull, 694 }, { 0xfb9b7cd9a4a7443cull, 720 }, { 0xbb764c4ca7a44410ull, 747 },
+    { 0x8bab8eefb6409c1aull, 774 }, { 0xd01fef10a657842cull, 800 }, { 0x9b10a4e5e9913129ull, 827 },
+    { 0xe7109bfba19c0c9dull, 853 }, { 0xac2820d9623bf429ull, 880 }, { 0x80444b5e7aa7cf85ull, 907 },
+    { 0xbf21e44003acdd2dull, 933 }, { 0x8e679c2f5e44ff8full, 960 }, { 0xd433179d9c8cb841ull, 986 },
+    { 0x9e19db92b4e31ba9ull, 1013 }, { 0xeb96bf6ebadf77d9ull, 1039 }, { 0xaf87023b9bf0ee6bull, 1066 },
+};
+
+static const uint32_t s_pow10_u32[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+static const double s_pow10_fast[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+
+/* 最短数字串补零即为正确舍入结果的最大有效位数 */
+#define FMT_SHORTEST_EXACT      15
+
+/* 定点快速路径的最大精度 */
+#define FMT_FAST_PREC_MAX       6
+
+/* 2^53：定点快速路径中放大后的值必须能精确表示为整数 */
+#define FMT_FAST_LIMIT          9007199254740992.0
+
+static fmt_fp_t fp_normalize(fmt_fp_t x)
+{
+    while ((x.f & 0xFFC0000000000000ull) == 0)
+    {
+        x.f <<= 10;
+        x.e -= 10;
+    }
+    while ((x.f & 0x8000000000000000ull) == 0)
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+/* 64x64 乘法取高64位（四舍五入） */
+static fmt_fp_t fp_mul(fmt_fp_t a, fmt_fp_t b)
+{
+    const uint64_t m32 = 0xFFFFFFFFull;
+    uint64_t ah = a.f >> 32;
+    uint64_t al = a.f & m32;
+    uint64_t bh = b.f >> 32;
+    uint64_t bl = b.f & m32;
+    uint64_t hh = ah * bh;
+    uint64_t lh = al * bh;
+    uint64_t hl = ah * bl;
+    uint64_t ll = al * bl;
+    uint64_t mid = (ll >> 32) + (hl & m32) + (lh & m32) + (1ull << 31);
+    fmt_fp_t r;
+
+    r.f = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+    r.e = a.e + b.e + 64;
+    return r;
+}
+
+/* 选取缓存的10的幂，使乘积的二进制指数落在 [-60, -32]，返回其十进制指数的相反数 */
+static fmt_fp_t fmt_cached_pow(int e, int *k)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    int index;
+
+    if (dk - ik > 0.0)
+    {
+        ik++;
+    }
+    index = (ik >> 3) + 1;
+    *k = -(-348 + index * 8);
+    return s_cached_pow[index];
+}
+
+/* 在保证仍落在舍入区间内的前提下，使末位数字尽量接近真值 */
+static void fmt_grisu_round(char *d, int n, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        d[n - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/* 生成数字：结果为 d * 10^k */
+static void fmt_digit_gen(fmt_fp_t w, fmt_fp_t mp, uint64_t delta, char *d, int *n, int *k)
+{
+    const int shift = -mp.e;
+    const uint64_t one = 1ull << shift;
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    int kappa = 1;
+
+    while (kappa < 10 && p1 >= s_pow10_u32[kappa])
+    {
+        kappa++;
+    }
+
+    *n = 0;
+    while (kappa > 0)
+    {
+        uint32_t div = s_pow10_u32[kappa - 1];
+        uint32_t digit = p1 / div;
+        uint64_t rest;
+
+        p1 %= div;
+        if (digit != 0 || *n != 0)
+        {
+            d[(*n)++] = (char)('0' + digit);
+        }
+        kappa--;
+        rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta)
+        {
+            *k += kappa;
+            fmt_grisu_round(d, *n, delta, rest, (uint64_t)s_pow10_u32[kappa] << shift, wp_w);
+            return;
+        }
+    }
+
+    for (;;)
+    {
+        char digit;
+
+        p2 *= 10;
+        delta *= 10;
+        digit = (char)(p2 >> shift);
+        if (digit != 0 || *n != 0)
+        {
+            d[(*n)++] = (char)('0' + digit);
+        }
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            *k += kappa;
+            fmt_grisu_round(d, *n, delta, p2, one, (-kappa < 10) ? wp_w * s_pow10_u32[-kappa] : 0);
+            return;
+        }
+    }
+}
+
+/*
+ * Grisu2：f * 2^e 为待转换值，lower_closer 表示下一个较小的可表示值距离
+ * 只有上方的一半（尾数为2的幂时）。
+ */
+static void fmt_grisu2(uint64_t f, int e, int lower_closer, fmt_dec_t *x)
+{
+    fmt_fp_t v = { f, e };
+    fmt_fp_t pl = { (f << 1) + 1, e - 1 };
+    fmt_fp_t mi;
+    fmt_fp_t c;
+    fmt_fp_t w;
+    fmt_fp_t wp;
+    fmt_fp_t wm;
+    int k;
+
+    pl = fp_normalize(pl);
+    if (lower_closer)
+    {
+        mi.f = (f << 2) - 1;
+        mi.e = e - 2;
+    }
+    else
+    {
+        mi.f = (f << 1) - 1;
+        mi.e = e - 1;
+    }
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    c = fmt_cached_pow(pl.e, &k);
+    w = fp_mul(fp_normalize(v), c);
+    wp = fp_mul(pl, c);
+    wm = fp_mul(mi, c);
+    wm.f++;
+    wp.f--;
+    fmt_digit_gen(w, wp, wp.f - wm.f, x->d, &x->n, &k);
+    x->dp = x->n + k;
+}
+
+static void fmt_set_zero(fmt_dec_t *x)
+{
+    x->d[0] = '0';
+    x->n = 1;
+    x->dp = 1;
+}
+
+/* 保留前 keep 位数字，up 为真时末位进1，并去掉末尾的0 */
+static void fmt_truncate(fmt_dec_t *x, int keep, int up)
+{
+    x->n = keep;
+    if (up)
+    {
+        int i = keep - 1;
+        while (i >= 0 && x->d[i] == '9')
+        {
+            i--;
+        }
+        if (i < 0)
+        {
+            x->d[0] = '1';
+            x->n = 1;
+            x->dp++;
+        }
+        else
+        {
+            x->d[i]++;
+            x->n = i + 1;
+        }
+    }
+    if (x->n == 0)
+    {
+        fmt_set_zero(x);
+        return;
+    }
+    while (x->n > 1 && x->d[x->n - 1] == '0')
+    {
+        x->n--;
+    }
+}
+
+static void big_set(fmt_big_t *a, uint64_t v)
+{
+    a->w[0] = (uint32_t)v;
+    a->w[1] = (uint32_t)(v >> 32);
+    a->n = (a->w[1] != 0) ? 2 : 1;
+}
+
+static void big_mul_small(fmt_big_t *a, uint32_t m)
+{
+    uint64_t carry = 0;
+    int i;
+
+    for (i = 0; i < a->n; i++)
+    {
+        uint64_t t = (uint64_t)a->w[i] * m + carry;
+        a->w[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    if (carry != 0)
+    {
+        a->w[a->n++] = (uint32_t)carry;
+    }
+}
+
+/* a *= 10^k */
+static void big_mul_pow10(fmt_big_t *a, int k)
+{
+    while (k >= 9)
+    {
+        big_mul_small(a, s_pow10_u32[9]);
+        k -= 9;
+    }
+    if (k > 0)
+    {
+        big_mul_small(a, s_pow10_u32[k]);
+    }
+}
+
+/* a <<= bits */
+static void big_shl(fmt_big_t *a, int bits)
+{
+    int words = bits / 32;
+    int shift = bits % 32;
+    int i;
+
+    if (shift != 0)
+    {
+        uint32_t carry = 0;
+        for (i = 0; i < a->n; i++)
+        {
+            uint32_t t = a->w[i];
+            a->w[i] = (t << shift) | carry;
+            carry = t >> (32 - shift);
+        }
+        if (carry != 0)
+        {
+            a->w[a->n++] = carry;
+        }
+    }
+    if (words != 0)
+    {
+        for (i = a->n - 1; i >= 0; i--)
+        {
+            a->w[i + words] = a->w[i];
+        }
+        for (i = 0; i < words; i++)
+        {
+            a->w[i] = 0;
+        }
+        a->n += words;
+    }
+}
+
+static int big_cmp(const fmt_big_t *a, const fmt_big_t *b)
+{
+    int i;
+
+    if (a->n != b->n)
+    {
+        return (a->n > b->n) ? 1 : -1;
+    }
+    for (i = a->n - 1; i >= 0; i--)
+    {
+        if (a->w[i] != b->w[i])
+        {
+            return (a->w[i] > b->w[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/* a -= b（a >= b） */
+static void big_sub(fmt_big_t *a, const fmt_big_t *b)
+{
+    uint32_t borrow = 0;
+    int i;
+
+    for (i = 0; i < a->n; i++)
+    {
+        uint64_t t = (uint64_t)a->w[i] - (i < b->n ? b->w[i] : 0u) - borrow;
+        a->w[i] = (uint32_t)t;
+        borrow = (uint32_t)(t >> 63);
+    }
+    while (a->n > 1 && a->w[a->n - 1] == 0)
+    {
+        a->n--;
+    }
+}
+
+/*
+ * 按精确值 m * 2^e 生成数字（恰在中点时舍入到偶数），去掉末尾的0：fixed 为0时
+ * 保留 digits 位有效数字，否则保留到小数点后 digits 位。
+ * x->dp 为估计的十进制指数，偏差由比较修正。
+ */
+static void fmt_exact(fmt_dec_t *x, uint64_t m, int e, int digits, int fixed)
+{
+    fmt_big_t r;
+    fmt_big_t s;
+    fmt_big_t t;
+    int k = x->dp;
+    int keep;
+    int i;
+    int c;
+
+    /* v = r / s */
+    big_set(&r, m);
+    big_set(&s, 1);
+    if (e >= 0)
+    {
+        big_shl(&r, e);
+    }
+    else
+    {
+        big_shl(&s, -e);
+    }
+    /* v / 10^k = r / s，调整到 [0.1, 1) */
+    if (k >= 0)
+    {
+        big_mul_pow10(&s, k);
+    }
+    else
+    {
+        big_mul_pow10(&r, -k);
+    }
+    if (big_cmp(&r, &s) >= 0)
+    {
+        big_mul_small(&s, 10);
+        k++;
+    }
+    else
+    {
+        t = r;
+        big_mul_small(&t, 10);
+        if (big_cmp(&t, &s) < 0)
+        {
+            r = t;
+            k--;
+        }
+    }
+    x->dp = k;
+    keep = fixed ? k + digits : digits;
+
+    if (keep < 0)
+    {
+        /* 值小于舍入单位的 1/10 */
+        fmt_set_zero(x);
+        return;
+    }
+    for (i = 0; i < keep; i++)
+    {
+        char digit = '0';
+        big_mul_small(&r, 10);
+        while (big_cmp(&r, &s) >= 0)
+        {
+            big_sub(&r, &s);
+            digit++;
+        }
+        x->d[i] = digit;
+    }
+    x->n = keep;
+
+    /* 余数与 1/2 比较 */
+    t = r;
+    big_shl(&t, 1);
+    c = big_cmp(&t, &s);
+    fmt_truncate(x, keep, (c > 0) || (c == 0 && keep > 0 && ((x->d[keep - 1] - '0') & 1)));
+}
+
+/*
+ * 最短数字串与真值之差不超过半个 ulp，即 v * 2^-53；换算为第 keep 位的单位
+ * 不超过 10^keep * 1.12e-16。表中为该误差按尾部前4位数字计的上界（向上取整
+ * 再加1），尾部离中点 5000 超过此值时按最短数字串舍入与按真值舍入结果相同。
+ */
+static const uint16_t s_near_half[FMT_SHORTEST_EXACT + 1] = {
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 13, 113, 1121
+};
+
+/*
+ * 舍入到 digits 位有效数字（fixed 为真时为小数点后 digits 位）。正规数且所需
+ * 位数不超过15时按最短数字串舍入：位数足够时直接使用，尾部不在中点附近时
+ * 四舍五入；其余情况（含 subnormal，其最短串的相对误差可能很大）按精确值生成。
+ */
+static void fmt_round(fmt_dec_t *x, uint64_t m, int e, int subnormal, int digits, int fixed)
+{
+    int keep = fixed ? x->dp + digits : digits;
+
+    if (x->d[0] == '0')
+    {
+        return;
+    }
+    if (!subnormal && keep <= FMT_SHORTEST_EXACT)
+    {
+        int tail = 0;
+        int i;
+
+        if (x->n <= keep)
+        {
+            return;
+        }
+        if (keep < 0)
+        {
+            /* 值小于舍入单位的 1/10 */
+            fmt_set_zero(x);
+            return;
+        }
+        for (i = keep; i < keep + 4; i++)
+        {
+            tail = tail * 10 + ((i < x->n) ? x->d[i] - '0' : 0);
+        }
+        if (tail + 1 + s_near_half[keep] < 5000 || tail > 5000 + s_near_half[keep])
+        {
+            fmt_truncate(x, keep, tail >= 5000);
+            return;
+        }
+    }
+    fmt_exact(x, m, e, digits, fixed);
+}
+
+/* 定点形式，frac 为小数位数 */
+static size_t fmt_put_fixed(char *out, const fmt_dec_t *x, int frac)
+{
+    size_t n = 0;
+    int i;
+
+    if (x->dp <= 0)
+    {
+        out[n++] = '0';
+    }
+    for (i = 0; i < x->dp; i++)
+    {
+        out[n++] = (i < x->n) ? x->d[i] : '0';
+    }
+    if (frac > 0)
+    {
+        out[n++] = '.';
+        for (i = x->dp; i < x->dp + frac; i++)
+        {
+            out[n++] = (i >= 0 && i < x->n) ? x->d[i] : '0';
+        }
+    }
+    return n;
+}
+
+/* 指数形式，frac 为尾数小数位数 */
+static size_t fmt_put_exp(char *out, const fmt_dec_t *x, int frac, char e)
+{
+    size_t n = 0;
+    int exp10 = (x->d[0] == '0') ? 0 : x->dp - 1;
+    int i;
+
+    out[n++] = x->d[0];
+    if (frac > 0)
+    {
+        out[n++] = '.';
+        for (i = 1; i <= frac; i++)
+        {
+            out[n++] = (i < x->n) ? x->d[i] : '0';
+        }
+    }
+    out[n++] = e;
+    if (exp10 < 0)
+    {
+        out[n++] = '-';
+        exp10 = -exp10;
+    }
+    else
+    {
+        out[n++] = '+';
+    }
+    if (exp10 >= 100)
+    {
+        out[n++] = (char)('0' + exp10 / 100);
+    }
+    out[n++] = (char)('0' + (exp10 / 10) % 10);
+    out[n++] = (char)('0' + exp10 % 10);
+    return n;
+}
+
+/* 最短表示：指数在 [-4, 15) 内用定点，否则用指数形式 */
+static size_t fmt_put_shortest(char *out, const fmt_dec_t *x, char e)
+{
+    int exp10 = x->dp - 1;
+
+    if (exp10 >= -4 && exp10 < 15)
+    {
+        return fmt_put_fixed(out, x, (x->n > x->dp) ? x->n - x->dp : 0);
+    }
+    return fmt_put_exp(out, x, x->n - 1, e);
+}
+
+/*
+ * Dekker 乘法：返回 p = a * b 的舍入误差（精确积 = p + 返回值），
+ * 只用普通双精度运算，不依赖 fma。
+ */
+static double fmt_mul_err(double a, double b, double p)
+{
+    const double split = 134217729.0;   /* 2^27 + 1 */
+    double t = split * a;
+    double ah = t - (t - a);
+    double al = a - ah;
+    double bh;
+    double bl;
+
+    t = split * b;
+    bh = t - (t - b);
+    bl = b - bh;
+    return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+}
+
+/*
+ * 定点快速路径：v * 10^prec 放大为整数后按精确积舍入（四舍六入五成双），
+ * 结果与 libc 一致。
+ */
+static size_t fmt_put_fast(char *out, double v, int prec)
+{
+    char tmp[20];
+    double scaled = v * s_pow10_fast[prec];
+    double lo = fmt_mul_err(v, s_pow10_fast[prec], scaled);
+    uint64_t u = (uint64_t)scaled;
+    double d = (scaled - (double)u) - 0.5;
+    uint64_t ip;
+    uint32_t fp;
+    size_t n = 0;
+    int i = 0;
+
+    /* d 非0时其绝对值不小于 scaled 的1个ulp，大于误差项 */
+    if (d > 0.0 || (d == 0.0 && (lo > 0.0 || (lo == 0.0 && (u & 1u)))))
+    {
+        u++;
+    }
+    ip = u / s_pow10_u32[prec];
+    fp = (uint32_t)(u % s_pow10_u32[prec]);
+    do {
+        tmp[i++] = (char)('0' + ip % 10u);
+        ip /= 10u;
+    } while (ip > 0);
+    while (i > 0)
+    {
+        out[n++] = tmp[--i];
+    }
+    if (prec > 0)
+    {
+        out[n++] = '.';
+        for (i = prec - 1; i >= 0; i--)
+        {
+            out[n + (size_t)i] = (char)('0' + fp % 10u);
+            fp /= 10u;
+        }
+        n += (size_t)prec;
+    }
+    return n;
+}
+
+/* NaN/Inf */
+static size_t fmt_put_special(char *out, int is_nan, int upper)
+{
+    const char *s = is_nan ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+    memcpy(out, s, 3);
+    return 3;
+}
+
+size_t cli_fmt_double(char *out, double v, char conv, int prec)
+{
+    uint64_t bits;
+    uint64_t sig;
+    int biased;
+    int upper = (conv >= 'A' && conv <= 'Z');
+    char e = upper ? 'E' : 'e';
+    fmt_dec_t x;
+    size_t n = 0;
+    uint64_t m;
+    int e2;
+
+    memcpy(&bits, &v, sizeof(bits));
+    biased = (int)((bits >> 52) & 0x7FF);
+    sig = bits & 0x000FFFFFFFFFFFFFull;
+    m = (biased == 0) ? sig : (sig | 0x0010000000000000ull);
+    e2 = (biased == 0) ? -1074 : biased - 1075;
+    if (upper)
+    {
+        conv = (char)(conv - 'A' + 'a');
+    }
+    if (prec > CLI_FMT_PREC_MAX)
+    {
+        prec = CLI_FMT_PREC_MAX;
+    }
+
+    if (bits >> 63)
+    {
+        out[n++] = '-';
+        v = -v;
+    }
+    if (biased == 0x7FF)
+    {
+        n += fmt_put_special(out + n, sig != 0, upper);
+        out[n] = '\0';
+        return n;
+    }
+
+    if (conv == 'f')
+    {
+        if (prec < 0)
+        {
+            prec = 6;
+        }
+        if (prec <= FMT_FAST_PREC_MAX && v * s_pow10_fast[prec] < FMT_FAST_LIMIT)
+        {
+            n += fmt_put_fast(out + n, v, prec);
+            out[n] = '\0';
+            return n;
+        }
+    }
+
+    if (biased == 0 && sig == 0)
+    {
+        fmt_set_zero(&x);
+    }
+    else
+    {
+        fmt_grisu2(m, e2, sig == 0 && biased > 1, &x);
+    }
+
+    if (conv == 'f' && x.dp > CLI_FMT_PREC_MAX)
+    {
+        /* 整数部分过长时改用指数形式，保持输出长度有界 */
+        conv = 'e';
+    }
+
+    switch (conv)
+    {
+        case 'f':
+            fmt_round(&x, m, e2, biased == 0, prec, 1);
+            n += fmt_put_fixed(out + n, &x, prec);
+            break;
+
+        case 'e':
+            if (prec < 0)
+            {
+                prec = 6;
+            }
+            fmt_round(&x, m, e2, biased == 0, prec + 1, 0);
+            n += fmt_put_exp(out + n, &x, prec, e);
+            break;
+
+        default:
+            if (prec < 0)
+            {
+                n += fmt_put_shortest(out + n, &x, e);
+            }
+            else
+            {
+                /* C 的 %g 规则：按精度舍入后指数在 [-4, P) 内用定点，末尾0去掉 */
+                int p = (prec == 0) ? 1 : prec;
+                int exp10;
+
+                fmt_round(&x, m, e2, biased == 0, p, 0);
+                exp10 = x.dp - 1;
+                if (exp10 >= -4 && exp10 < p)
+                {
+                    n += fmt_put_fixed(out + n, &x, (x.n > x.dp) ? x.n - x.dp : 0);
+                }
+                else
+                {
+                    n += fmt_put_exp(out + n, &x, x.n - 1, e);
+                }
+            }
+            break;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+size_t cli_fmt_float(char *out, float v)
+{
+    uint32_t bits;
+    uint32_t sig;
+    int biased;
+    fmt_dec_t x;
+    size_t n = 0;
+
+    memcpy(&bits, &v, sizeof(bits));
+    biased = (int)((bits >> 23) & 0xFF);
+    sig = bits & 0x007FFFFFu;
+
+    if (bits >> 31)
+    {
+        out[n++] = '-';
+    }
+    if (biased == 0xFF)
+    {
+        n += fmt_put_special(out + n, sig != 0, 0);
+        out[n] = '\0';
+        return n;
+    }
+    if (biased == 0 && sig == 0)
+    {
+        fmt_set_zero(&x);
+    }
+    else if (biased == 0)
+    {
+        fmt_grisu2(sig, -149, 0, &x);
+    }
+    else
+    {
+        fmt_grisu2(sig | 0x00800000u, biased - 150, sig == 0 && biased > 1, &x);
+    }
+    n += fmt_put_shortest(out + n, &x, 'e');
+    out[n] = '\0';
+    return n;
+}
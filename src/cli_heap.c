@@ -0,0 +1,435 @@
+/*
+ * @file cli_heap.c
+ * @brief 堆分配分析实现
+ *
+ * 替换函数直接调用 glibc 的 __libc_malloc 等实现，不经过 dlsym。
+ * 两张表都是开放寻址哈希表：键用 CAS 占位，计数用原子加减；
+ * 存活表删除时留下墓碑，探测长度限制为 HEAP_PROBE_MAX，超出即放弃跟踪，
+ * 使每次分配/释放的额外开销有上界。
+ * 更新表的线程先增加 s_heap_busy 再确认采集仍在进行；cli_heap_start 先关闭
+ * 采集，等 s_heap_busy 归零后再清表，清表时不会与其它线程的更新交错。
+ */
+
+#define _GNU_SOURCE
+#include <cli_heap.h>
+
+#if CLI_HEAP_PROFILE
+
+#include <cli_table.h>
+#include <cli_arg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <dlfcn.h>
+#include <sched.h>
+
+#define HEAP_SITE_MASK          (CLI_HEAP_SITES - 1)
+#define HEAP_LIVE_MASK          (CLI_HEAP_LIVE - 1)
+
+/* 单次查找的最大探测次数 */
+#define HEAP_PROBE_MAX          64
+
+/* 存活表键：0 为空，1 为已删除 */
+#define HEAP_KEY_EMPTY          0u
+#define HEAP_KEY_TOMB           1u
+
+/* heap top 默认行数 */
+#define HEAP_TOP_DEFAULT        20
+
+/* glibc 的原始实现 */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+/* 调用点统计 */
+typedef struct
+{
+    uintptr_t ra;               /* 返回地址，0表示空 */
+    uint64_t allocs;            /* 分配次数 */
+    uint64_t tracked;           /* 记入存活表的分配数 */
+    uint64_t frees;             /* 已释放的（被跟踪的）分配数 */
+    uint64_t bytes;             /* 累计分配字节数 */
+    uint64_t live_bytes;        /* 存活字节数 */
+} heap_site_t;
+
+/* 存活分配 */
+typedef struct
+{
+    uintptr_t ptr;
+    size_t size;
+    uint32_t site;              /* s_sites 下标 */
+} heap_live_t;
+
+static bool s_heap_on = false;
+static uint32_t s_heap_busy;    /* 正在更新表的线程数 */
+static uint32_t s_site_count;
+static uint32_t s_site_overflow;
+static uint32_t s_live_overflow;
+static heap_site_t s_sites[CLI_HEAP_SITES];
+static heap_live_t s_live[CLI_HEAP_LIVE];
+static heap_site_t s_rows[CLI_HEAP_SITES];
+
+/* 排序方式 */
+enum
+{
+    HEAP_SORT_ALLOCS,
+    HEAP_SORT_BYTES,
+    HEAP_SORT_LIVE
+};
+static int s_sort;
+
+static int cmd_heap(int argc, char **argv);
+
+const cli_command_t cli_heap_cmd = {
+    .name = "heap",
+    .short_name = NULL,
+    .help = CLI_HELP("Heap profiler: heap start|stop|top [n] [-b|-l]"),
+    .handler = cmd_heap
+};
+
+static uint32_t heap_hash(uintptr_t v)
+{
+    return (uint32_t)(((uint64_t)v * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+/* 查找或插入调用点，表满返回 NULL */
+static heap_site_t *heap_site(uintptr_t ra)
+{
+    uint32_t h = heap_hash(ra);
+
+    for (uint32_t i = 0; i < HEAP_PROBE_MAX; i++)
+    {
+        heap_site_t *s = &s_sites[(h + i) & HEAP_SITE_MASK];
+        uintptr_t key = __atomic_load_n(&s->ra, __ATOMIC_ACQUIRE);
+        if (key == ra)
+        {
+            return s;
+        }
+        if (key == 0)
+        {
+            if (__atomic_compare_exchange_n(&s->ra, &key, ra, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                __atomic_fetch_add(&s_site_count, 1, __ATOMIC_RELAXED);
+                return s;
+            }
+            if (key == ra)
+            {
+                return s;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void heap_track_alloc(void *ptr, size_t size, uintptr_t ra)
+{
+    heap_site_t *s;
+    uint32_t h;
+
+    s = heap_site(ra);
+    if (s == NULL)
+    {
+        __atomic_fetch_add(&s_site_overflow, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_fetch_add(&s->allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->bytes, size, __ATOMIC_RELAXED);
+
+    h = heap_hash((uintptr_t)ptr);
+    for (uint32_t i = 0; i < HEAP_PROBE_MAX; i++)
+    {
+        heap_live_t *l = &s_live[(h + i) & HEAP_LIVE_MASK];
+        uintptr_t key = __atomic_load_n(&l->ptr, __ATOMIC_RELAXED);
+        if ((key == HEAP_KEY_EMPTY || key == HEAP_KEY_TOMB) &&
+            __atomic_compare_exchange_n(&l->ptr, &key, (uintptr_t)ptr, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            /* 同一指针在返回给调用方之前不会被释放，占位后再填值即可 */
+            l->size = size;
+            l->site = (uint32_t)(s - s_sites);
+            __atomic_fetch_add(&s->tracked, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&s->live_bytes, size, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+    __atomic_fetch_add(&s_live_overflow, 1, __ATOMIC_RELAXED);
+}
+
+static void heap_track_free(void *ptr)
+{
+    uint32_t h = heap_hash((uintptr_t)ptr);
+
+    for (uint32_t i = 0; i < HEAP_PROBE_MAX; i++)
+    {
+        heap_live_t *l = &s_live[(h + i) & HEAP_LIVE_MASK];
+        uintptr_t key = __atomic_load_n(&l->ptr, __ATOMIC_ACQUIRE);
+        if (key == (uintptr_t)ptr)
+        {
+            heap_site_t *s = &s_sites[l->site];
+            __atomic_fetch_add(&s->frees, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_sub(&s->live_bytes, l->size, __ATOMIC_RELAXED);
+            __atomic_store_n(&l->ptr, HEAP_KEY_TOMB, __ATOMIC_RELEASE);
+            return;
+        }
+        if (key == HEAP_KEY_EMPTY)
+        {
+            return;
+        }
+    }
+}
+
+/* 进入更新：与 cli_heap_start 的“关闭后等待”配对，两侧均用顺序一致的原子操作 */
+static bool heap_enter(void)
+{
+    __atomic_add_fetch(&s_heap_busy, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_heap_on, __ATOMIC_SEQ_CST))
+    {
+        return true;
+    }
+    __atomic_sub_fetch(&s_heap_busy, 1, __ATOMIC_RELEASE);
+    return false;
+}
+
+static void heap_leave(void)
+{
+    __atomic_sub_fetch(&s_heap_busy, 1, __ATOMIC_RELEASE);
+}
+
+static void heap_on_alloc(void *ptr, size_t size, uintptr_t ra)
+{
+    if (ptr != NULL && heap_enter())
+    {
+        heap_track_alloc(ptr, size, ra);
+        heap_leave();
+    }
+}
+
+/* 必须在真正释放之前调用，否则同一地址可能已被其他线程重新分配 */
+static void heap_on_free(void *ptr)
+{
+    if (heap_enter())
+    {
+        heap_track_free(ptr);
+        heap_leave();
+    }
+}
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    if (__builtin_expect(__atomic_load_n(&s_heap_on, __ATOMIC_RELAXED), 0))
+    {
+        heap_on_alloc(ptr, size, (uintptr_t)__builtin_return_address(0));
+    }
+    return ptr;
+}
+
+void *calloc(size_t count, size_t size)
+{
+    void *ptr = __libc_calloc(count, size);
+    if (__builtin_expect(__atomic_load_n(&s_heap_on, __ATOMIC_RELAXED), 0))
+    {
+        /* 乘积溢出时 calloc 已返回 NULL */
+        heap_on_alloc(ptr, count * size, (uintptr_t)__builtin_return_address(0));
+    }
+    return ptr;
+}
+
+void *realloc(void *old, size_t size)
+{
+    void *ptr;
+
+    if (__builtin_expect(!__atomic_load_n(&s_heap_on, __ATOMIC_RELAXED), 1))
+    {
+        return __libc_realloc(old, size);
+    }
+    /* 按“释放旧块 + 分配新块”计入同一调用点；失败时旧块不再跟踪 */
+    if (old != NULL)
+    {
+        heap_on_free(old);
+    }
+    ptr = __libc_realloc(old, size);
+    heap_on_alloc(ptr, size, (uintptr_t)__builtin_return_address(0));
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    if (__builtin_expect(__atomic_load_n(&s_heap_on, __ATOMIC_RELAXED), 0) && ptr != NULL)
+    {
+        heap_on_free(ptr);
+    }
+    __libc_free(ptr);
+}
+
+void cli_heap_start(void)
+{
+    __atomic_store_n(&s_heap_on, false, __ATOMIC_SEQ_CST);
+    /* 等待已进入的更新完成，之后进入的线程会看到采集已关闭 */
+    while (__atomic_load_n(&s_heap_busy, __ATOMIC_SEQ_CST) != 0)
+    {
+        sched_yield();
+    }
+    memset(s_sites, 0, sizeof(s_sites));
+    memset(s_live, 0, sizeof(s_live));
+    s_site_count = 0;
+    s_site_overflow = 0;
+    s_live_overflow = 0;
+    __atomic_store_n(&s_heap_on, true, __ATOMIC_SEQ_CST);
+}
+
+void cli_heap_stop(void)
+{
+    __atomic_store_n(&s_heap_on, false, __ATOMIC_SEQ_CST);
+}
+
+void cli_heap_get_stats(cli_heap_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        stats->active = __atomic_load_n(&s_heap_on, __ATOMIC_RELAXED);
+        stats->sites = __atomic_load_n(&s_site_count, __ATOMIC_RELAXED);
+        stats->site_overflow = __atomic_load_n(&s_site_overflow, __ATOMIC_RELAXED);
+        stats->live_overflow = __atomic_load_n(&s_live_overflow, __ATOMIC_RELAXED);
+    }
+}
+
+static uint64_t heap_sort_key(const heap_site_t *s)
+{
+    switch (s_sort)
+    {
+        case HEAP_SORT_BYTES:
+            return s->bytes;
+        case HEAP_SORT_LIVE:
+            return s->live_bytes;
+        default:
+            return s->allocs;
+    }
+}
+
+static int heap_cmp(const void *a, const void *b)
+{
+    uint64_t x = heap_sort_key((const heap_site_t *)a);
+    uint64_t y = heap_sort_key((const heap_site_t *)b);
+    return (x < y) - (x > y);
+}
+
+/* heap top */
+static void heap_top(uint32_t limit)
+{
+    static const cli_table_col_t cols[] = {
+        { "allocs", CLI_COL_U64, 8, CLI_COL_RIGHT, 0 },
+        { "frees",  CLI_COL_U64, 8, CLI_COL_RIGHT, 0 },
+        { "bytes",  CLI_COL_U64, 10, CLI_COL_RIGHT, 0 },
+        { "live",   CLI_COL_U64, 6, CLI_COL_RIGHT, 0 },
+        { "live_bytes", CLI_COL_U64, 10, CLI_COL_RIGHT, 0 },
+        { "site",   CLI_COL_STR, 0, 0, 0 },
+    };
+    size_t count = 0;
+    cli_table_t table;
+
+    /* 先复制快照再排序：排序本身可能分配内存 */
+    for (uint32_t i = 0; i < CLI_HEAP_SITES; i++)
+    {
+        if (__atomic_load_n(&s_sites[i].ra, __ATOMIC_ACQUIRE) != 0)
+        {
+            s_rows[count].ra = s_sites[i].ra;
+            s_rows[count].allocs = __atomic_load_n(&s_sites[i].allocs, __ATOMIC_RELAXED);
+            s_rows[count].tracked = __atomic_load_n(&s_sites[i].tracked, __ATOMIC_RELAXED);
+            s_rows[count].frees = __atomic_load_n(&s_sites[i].frees, __ATOMIC_RELAXED);
+            s_rows[count].bytes = __atomic_load_n(&s_sites[i].bytes, __ATOMIC_RELAXED);
+            s_rows[count].live_bytes = __atomic_load_n(&s_sites[i].live_bytes, __ATOMIC_RELAXED);
+            count++;
+        }
+    }
+    qsort(s_rows, count, sizeof(s_rows[0]), heap_cmp);
+
+    cli_table_begin(&table, cols, 6);
+    for (size_t i = 0; i < count && i < limit; i++)
+    {
+        const heap_site_t *s = &s_rows[i];
+        char site[96];
+        Dl_info info;
+
+        /* 返回地址按 符号+偏移 显示，无符号时为 模块+偏移 */
+        if (dladdr((void *)s->ra, &info) == 0)
+        {
+            snprintf(site, sizeof(site), "0x%lx", (unsigned long)s->ra);
+        }
+        else if (info.dli_sname != NULL)
+        {
+            snprintf(site, sizeof(site), "%s+0x%lx", info.dli_sname,
+                     (unsigned long)(s->ra - (uintptr_t)info.dli_saddr));
+        }
+        else
+        {
+            const char *slash = strrchr(info.dli_fname, '/');
+            snprintf(site, sizeof(site), "%s+0x%lx", (slash != NULL) ? slash + 1 : info.dli_fname,
+                     (unsigned long)(s->ra - (uintptr_t)info.dli_fbase));
+        }
+        /* live 只计存活表中的分配，与 live_bytes 一致；未记入的分配不会被减去 */
+        cli_table_row(&table, s->allocs, s->frees, s->bytes, s->tracked - s->frees, s->live_bytes, site);
+    }
+    cli_table_end(&table);
+    if (s_live_overflow != 0 && cli_get_output_mode() == CLI_MODE_TEXT)
+    {
+        cli_printf("%u allocations untracked (live table full): live columns undercount\r\n",
+                   (unsigned int)__atomic_load_n(&s_live_overflow, __ATOMIC_RELAXED));
+    }
+}
+
+/* heap 命令 */
+static int cmd_heap(int argc, char **argv)
+{
+    const char *sub = (argc > 1) ? argv[1] : "";
+
+    if (argc == 1)
+    {
+        cli_heap_stats_t st;
+        cli_heap_get_stats(&st);
+        cli_printf("%s, %u sites, %u site overflow, %u untracked\r\n",
+                   st.active ? "Running" : "Stopped", (unsigned int)st.sites,
+                   (unsigned int)st.site_overflow, (unsigned int)st.live_overflow);
+        return 0;
+    }
+    if (strcmp(sub, "start") == 0)
+    {
+        cli_heap_start();
+        return 0;
+    }
+    if (strcmp(sub, "stop") == 0)
+    {
+        cli_heap_stop();
+        return 0;
+    }
+    if (strcmp(sub, "top") == 0)
+    {
+        uint32_t limit = HEAP_TOP_DEFAULT;
+        s_sort = HEAP_SORT_ALLOCS;
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "-b") == 0)
+            {
+                s_sort = HEAP_SORT_BYTES;
+            }
+            else if (strcmp(argv[i], "-l") == 0)
+            {
+                s_sort = HEAP_SORT_LIVE;
+            }
+            else if (cli_arg_u32(CLI_ARG(argv[i]), 1, CLI_HEAP_SITES, &limit) != CLI_SUCCESS)
+            {
+                cli_arg_report("n", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        heap_top(limit);
+        return 0;
+    }
+
+    cli_puts("Usage: heap start|stop|top [n] [-b|-l]\r\n");
+    return -1;
+}
+
+#endif /* CLI_HEAP_PROFILE */
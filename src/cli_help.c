@@ -0,0 +1,119 @@
+/*
+ * @file cli_help.c
+ * @brief 帮助文本输出实现（压缩表由构建时生成的 cli_help_data.c 提供）
+ */
+
+#include <cli_help.h>
+#include <string.h>
+
+#if CLI_HELP_COMPRESSED
+
+/* 以下由 tools/cli_helpgen 生成 */
+extern const uint8_t cli_help_pairs[][2];       /* 代码 0x80+i 展开为 pairs[i][0], pairs[i][1] */
+extern const uint8_t cli_help_blob[];
+extern const cli_help_entry_t cli_help_index[];
+extern const uint16_t cli_help_count;
+
+static uint32_t help_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s != '\0')
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const cli_help_entry_t *help_find(const char *name)
+{
+    uint32_t h = help_hash(name);
+    uint16_t lo = 0;
+    uint16_t hi = cli_help_count;
+
+    while (lo < hi)
+    {
+        uint16_t mid = (uint16_t)((lo + hi) / 2u);
+        if (cli_help_index[mid].hash < h)
+        {
+            lo = (uint16_t)(mid + 1u);
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo < cli_help_count && cli_help_index[lo].hash == h)
+    {
+        return &cli_help_index[lo];
+    }
+    return NULL;
+}
+
+/* 展开一段压缩文本，每满 CLI_HELP_CHUNK 字节写出一次 */
+static size_t help_decode(const uint8_t *p, uint16_t len)
+{
+    char chunk[CLI_HELP_CHUNK];
+    uint8_t stack[CLI_HELP_MAX_DEPTH];
+    size_t n = 0;
+    size_t total = 0;
+    uint16_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        int sp = 0;
+        stack[sp++] = p[i];
+        while (sp > 0)
+        {
+            uint8_t c = stack[--sp];
+            if (c & 0x80u)
+            {
+                /* 先压右半部分，保证左半部分先展开 */
+                stack[sp++] = cli_help_pairs[c & 0x7Fu][1];
+                stack[sp++] = cli_help_pairs[c & 0x7Fu][0];
+                continue;
+            }
+            chunk[n++] = (char)c;
+            if (n == sizeof(chunk))
+            {
+                cli_write(chunk, n);
+                total += n;
+                n = 0;
+            }
+        }
+    }
+    if (n > 0)
+    {
+        cli_write(chunk, n);
+        total += n;
+    }
+    return total;
+}
+
+#endif /* CLI_HELP_COMPRESSED */
+
+size_t cli_help_write(const cli_command_t *cmd)
+{
+    if (cmd == NULL)
+    {
+        return 0;
+    }
+    if (cmd->help != NULL)
+    {
+        size_t len = strlen(cmd->help);
+        cli_write(cmd->help, len);
+        return len;
+    }
+#if CLI_HELP_COMPRESSED
+    if (cmd->name != NULL)
+    {
+        const cli_help_entry_t *e = help_find(cmd->name);
+        if (e != NULL)
+        {
+            return help_decode(&cli_help_blob[e->offset], e->length);
+        }
+    }
+#endif
+    return 0;
+}
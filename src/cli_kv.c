@@ -0,0 +1,951 @@
+/*
+ * @file cli_kv.c
+ * @brief 日志结构持久化键值存储实现
+ *
+ * 介质布局：每个扇区以扇区头开始，其后顺序追加记录。
+ *   扇区头: magic | erase_count | seq | reserved      (16字节)
+ *   记录:   key_len | flags | val_len | crc32 | key | value | 填充到4字节
+ * 扇区头在擦除后立即写入 magic 和擦除次数，seq 保持 0xFFFFFFFF 表示空闲，
+ * 启用时再写入 seq，因此每个字只编程一次。
+ *
+ * 写入总是追加到当前活动扇区，旧记录由新记录覆盖失效。活动扇区写满时，
+ * 启用擦除次数最少的空闲扇区；空闲扇区只剩一个保留扇区时，先把最旧扇区中
+ * 仍然有效的记录复制到保留扇区再擦除最旧扇区（整理），擦除次数在扇区间
+ * 轮转均衡。
+ *
+ * RAM 中保存 键哈希 -> 记录地址 的开放寻址索引，挂载时按 seq 顺序扫描所有
+ * 扇区重建，之后读取只需一次哈希查找和一次介质读取。
+ */
+
+#include <cli_kv.h>
+#include <cli_var.h>
+#include <cli_arg.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* 最大扇区数 */
+#ifndef CLI_KV_MAX_SECTORS
+#define CLI_KV_MAX_SECTORS      16
+#endif
+
+#define KV_SECTOR_MAGIC         0x564B4C43u     /* "CLKV" */
+#define KV_SECTOR_HDR_SIZE      16u
+#define KV_SEQ_FREE             0xFFFFFFFFu
+
+#define KV_REC_HDR_SIZE         8u
+#define KV_REC_ERASED           0xFF            /* key_len 为 0xFF 表示日志结束 */
+#define KV_REC_FLAG_DELETED     0x01
+
+#define KV_INDEX_SIZE           (CLI_KV_MAX_KEYS * 2)
+#define KV_ADDR_EMPTY           0xFFFFFFFFu
+#define KV_ADDR_DELETED         0xFFFFFFFEu
+
+#define KV_ALIGN4(x)            (((x) + 3u) & ~3u)
+
+/* 扇区头 */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t erase_count;
+    uint32_t seq;
+    uint32_t reserved;
+} kv_sector_hdr_t;
+
+/* 记录头 */
+typedef struct
+{
+    uint8_t  key_len;
+    uint8_t  flags;
+    uint16_t val_len;
+    uint32_t crc;
+} kv_rec_hdr_t;
+
+/* 索引槽 */
+typedef struct
+{
+    uint32_t hash;
+    uint32_t addr;
+} kv_slot_t;
+
+/* 存储状态 */
+static struct
+{
+    const cli_kv_flash_t *flash;
+    uint32_t seq[CLI_KV_MAX_SECTORS];           /* 各扇区序号，KV_SEQ_FREE 为空闲 */
+    uint32_t erase_count[CLI_KV_MAX_SECTORS];   /* 各扇区擦除次数 */
+    uint32_t next_seq;                          /* 下一个启用扇区的序号 */
+    uint32_t active;                            /* 活动扇区 */
+    uint32_t write_off;                         /* 活动扇区内写入偏移 */
+    uint32_t keys;
+    uint32_t records;
+    uint32_t compactions;
+    uint32_t mount_ms;
+    kv_slot_t index[KV_INDEX_SIZE];
+} s_kv;
+
+/* 记录缓冲区（头 + 键 + 值） */
+typedef struct
+{
+    kv_rec_hdr_t hdr;
+    uint8_t data[CLI_KV_MAX_KEY_LEN + CLI_KV_MAX_VALUE_LEN + 3];
+} kv_rec_buf_t;
+
+static int cmd_config(int argc, char **argv);
+
+const cli_command_t cli_kv_config_cmd = {
+    .name = "config",
+    .short_name = NULL,
+    .help = CLI_HELP("Persistent config: config set|get|del|list|save|load|info|bench"),
+    .handler = cmd_config
+};
+
+/* CRC-32 (IEEE 802.3)，半字节查表 */
+static uint32_t kv_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+        0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+        0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+    };
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+/* FNV-1a 哈希 */
+static uint32_t kv_hash(const char *key, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (uint8_t)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t kv_sector_addr(uint32_t sector)
+{
+    return sector * s_kv.flash->sector_size;
+}
+
+/* 记录校验值：覆盖除 crc 外的记录头和数据 */
+static uint32_t kv_rec_crc(const kv_rec_buf_t *rec)
+{
+    uint8_t head[4];
+    uint32_t crc;
+    head[0] = rec->hdr.key_len;
+    head[1] = rec->hdr.flags;
+    head[2] = (uint8_t)rec->hdr.val_len;
+    head[3] = (uint8_t)(rec->hdr.val_len >> 8);
+    crc = kv_crc32(0, head, sizeof(head));
+    return kv_crc32(crc, rec->data, (size_t)rec->hdr.key_len + rec->hdr.val_len);
+}
+
+/* 读取并校验 addr 处的记录；返回记录占用长度，0 表示日志结束，负值表示损坏 */
+static int kv_read_record(uint32_t addr, uint32_t limit, kv_rec_buf_t *rec)
+{
+    size_t data_len;
+    uint32_t total;
+
+    if (addr + KV_REC_HDR_SIZE > limit)
+    {
+        return 0;
+    }
+    if (s_kv.flash->read(s_kv.flash->ctx, addr, &rec->hdr, KV_REC_HDR_SIZE) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    if (rec->hdr.key_len == KV_REC_ERASED)
+    {
+        return 0;
+    }
+    if (rec->hdr.key_len == 0 || rec->hdr.key_len > CLI_KV_MAX_KEY_LEN ||
+        rec->hdr.val_len > CLI_KV_MAX_VALUE_LEN)
+    {
+        return CLI_ERR_IO;
+    }
+    data_len = (size_t)rec->hdr.key_len + rec->hdr.val_len;
+    total = KV_ALIGN4(KV_REC_HDR_SIZE + (uint32_t)data_len);
+    if (addr + total > limit)
+    {
+        return CLI_ERR_IO;
+    }
+    if (s_kv.flash->read(s_kv.flash->ctx, addr + KV_REC_HDR_SIZE, rec->data, data_len) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    if (kv_rec_crc(rec) != rec->hdr.crc)
+    {
+        return CLI_ERR_IO;
+    }
+    return (int)total;
+}
+
+/* 在索引中查找键，返回槽位；不存在时返回 -1，first_free 返回可插入位置 */
+static int kv_index_find(const char *key, size_t key_len, uint32_t hash, int *first_free)
+{
+    uint32_t slot = hash & (KV_INDEX_SIZE - 1);
+    int free_slot = -1;
+
+    for (uint32_t probe = 0; probe < KV_INDEX_SIZE; probe++)
+    {
+        kv_slot_t *e = &s_kv.index[slot];
+        if (e->addr == KV_ADDR_EMPTY)
+        {
+            if (free_slot < 0)
+            {
+                free_slot = (int)slot;
+            }
+            break;
+        }
+        if (e->addr == KV_ADDR_DELETED)
+        {
+            if (free_slot < 0)
+            {
+                free_slot = (int)slot;
+            }
+        }
+        else if (e->hash == hash)
+        {
+            /* 哈希相同时读取介质上的键确认 */
+            kv_rec_hdr_t hdr;
+            char stored[CLI_KV_MAX_KEY_LEN];
+            if (s_kv.flash->read(s_kv.flash->ctx, e->addr, &hdr, KV_REC_HDR_SIZE) == 0 &&
+                hdr.key_len == key_len &&
+                s_kv.flash->read(s_kv.flash->ctx, e->addr + KV_REC_HDR_SIZE, stored, key_len) == 0 &&
+                memcmp(stored, key, key_len) == 0)
+            {
+                return (int)slot;
+            }
+        }
+        slot = (slot + 1) & (KV_INDEX_SIZE - 1);
+    }
+    if (first_free != NULL)
+    {
+        *first_free = free_slot;
+    }
+    return -1;
+}
+
+/* 根据记录更新索引 */
+static cli_error_t kv_index_apply(const kv_rec_buf_t *rec, uint32_t addr)
+{
+    const char *key = (const char *)rec->data;
+    uint32_t hash = kv_hash(key, rec->hdr.key_len);
+    int free_slot = -1;
+    int slot = kv_index_find(key, rec->hdr.key_len, hash, &free_slot);
+
+    if (rec->hdr.flags & KV_REC_FLAG_DELETED)
+    {
+        if (slot >= 0)
+        {
+            s_kv.index[slot].addr = KV_ADDR_DELETED;
+            s_kv.keys--;
+        }
+        return CLI_SUCCESS;
+    }
+    if (slot >= 0)
+    {
+        s_kv.index[slot].addr = addr;
+        return CLI_SUCCESS;
+    }
+    if (free_slot < 0 || s_kv.keys >= CLI_KV_MAX_KEYS)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    s_kv.index[free_slot].hash = hash;
+    s_kv.index[free_slot].addr = addr;
+    s_kv.keys++;
+    return CLI_SUCCESS;
+}
+
+/* 擦除扇区并写入新的扇区头（空闲状态） */
+static cli_error_t kv_format_sector(uint32_t sector, uint32_t erase_count)
+{
+    kv_sector_hdr_t hdr;
+
+    if (s_kv.flash->erase(s_kv.flash->ctx, sector) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    memset(&hdr, 0xFF, sizeof(hdr));
+    hdr.magic = KV_SECTOR_MAGIC;
+    hdr.erase_count = erase_count;
+    if (s_kv.flash->write(s_kv.flash->ctx, kv_sector_addr(sector), &hdr, 8) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    s_kv.seq[sector] = KV_SEQ_FREE;
+    s_kv.erase_count[sector] = erase_count;
+    return CLI_SUCCESS;
+}
+
+/* 选择擦除次数最少的空闲扇区，返回 -1 表示没有 */
+static int kv_pick_free(void)
+{
+    int best = -1;
+    for (uint32_t i = 0; i < s_kv.flash->sector_count; i++)
+    {
+        if (s_kv.seq[i] == KV_SEQ_FREE &&
+            (best < 0 || s_kv.erase_count[i] < s_kv.erase_count[best]))
+        {
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+static uint32_t kv_free_count(void)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < s_kv.flash->sector_count; i++)
+    {
+        if (s_kv.seq[i] == KV_SEQ_FREE)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+/* 启用空闲扇区作为活动扇区 */
+static cli_error_t kv_activate(uint32_t sector)
+{
+    uint32_t seq = s_kv.next_seq;
+    if (s_kv.flash->write(s_kv.flash->ctx, kv_sector_addr(sector) + 8, &seq, sizeof(seq)) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    s_kv.seq[sector] = seq;
+    s_kv.next_seq++;
+    s_kv.active = sector;
+    s_kv.write_off = KV_SECTOR_HDR_SIZE;
+    return CLI_SUCCESS;
+}
+
+/* 在活动扇区追加一条已编码的记录 */
+static cli_error_t kv_write_record(kv_rec_buf_t *rec, uint32_t *addr_out)
+{
+    uint32_t total = KV_ALIGN4(KV_REC_HDR_SIZE + rec->hdr.key_len + rec->hdr.val_len);
+    uint32_t addr;
+
+    if (s_kv.write_off + total > s_kv.flash->sector_size)
+    {
+        return CLI_ERR_NO_SPACE;
+    }
+    /* 填充字节保持擦除状态 */
+    memset(rec->data + rec->hdr.key_len + rec->hdr.val_len, 0xFF,
+           total - KV_REC_HDR_SIZE - rec->hdr.key_len - rec->hdr.val_len);
+    addr = kv_sector_addr(s_kv.active) + s_kv.write_off;
+    if (s_kv.flash->write(s_kv.flash->ctx, addr, rec, total) != 0)
+    {
+        /* 写入失败的区域不再使用 */
+        s_kv.write_off = s_kv.flash->sector_size;
+        return CLI_ERR_IO;
+    }
+    s_kv.write_off += total;
+    *addr_out = addr;
+    return CLI_SUCCESS;
+}
+
+/* 整理：把最旧扇区中的有效记录复制到活动扇区（有空闲扇区时先启用它），再擦除最旧扇区 */
+static cli_error_t kv_compact(void)
+{
+    int oldest = -1;
+    int reserve;
+    uint32_t off = KV_SECTOR_HDR_SIZE;
+    uint32_t base;
+    kv_rec_buf_t rec;
+    cli_error_t err;
+
+    for (uint32_t i = 0; i < s_kv.flash->sector_count; i++)
+    {
+        if (s_kv.seq[i] != KV_SEQ_FREE &&
+            (oldest < 0 || s_kv.seq[i] < s_kv.seq[oldest]))
+        {
+            oldest = (int)i;
+        }
+    }
+    reserve = kv_pick_free();
+    /* 没有保留扇区时不能整理活动扇区自身 */
+    if (oldest < 0 || (reserve < 0 && (uint32_t)oldest == s_kv.active))
+    {
+        return CLI_ERR_NO_SPACE;
+    }
+
+    if (reserve >= 0)
+    {
+        err = kv_activate((uint32_t)reserve);
+        if (err != CLI_SUCCESS)
+        {
+            return err;
+        }
+    }
+
+    base = kv_sector_addr((uint32_t)oldest);
+    for (;;)
+    {
+        int len = kv_read_record(base + off, base + s_kv.flash->sector_size, &rec);
+        if (len <= 0)
+        {
+            break;
+        }
+        if (!(rec.hdr.flags & KV_REC_FLAG_DELETED))
+        {
+            uint32_t hash = kv_hash((const char *)rec.data, rec.hdr.key_len);
+            int slot = kv_index_find((const char *)rec.data, rec.hdr.key_len, hash, NULL);
+            if (slot >= 0 && s_kv.index[slot].addr == base + off)
+            {
+                uint32_t new_addr;
+                err = kv_write_record(&rec, &new_addr);
+                if (err != CLI_SUCCESS)
+                {
+                    return err;
+                }
+                s_kv.index[slot].addr = new_addr;
+            }
+        }
+        off += (uint32_t)len;
+    }
+
+    s_kv.compactions++;
+    return kv_format_sector((uint32_t)oldest, s_kv.erase_count[oldest] + 1);
+}
+
+/* 活动扇区写满后切换到下一个扇区 */
+static cli_error_t kv_advance(void)
+{
+    int sector;
+
+    /* 始终保留一个空闲扇区用于整理 */
+    if (kv_free_count() <= 1)
+    {
+        return kv_compact();
+    }
+    sector = kv_pick_free();
+    if (sector < 0)
+    {
+        return CLI_ERR_NO_SPACE;
+    }
+    return kv_activate((uint32_t)sector);
+}
+
+/* 编码并追加记录，必要时切换扇区或整理 */
+static cli_error_t kv_append(const char *key, const void *value, size_t len, uint8_t flags)
+{
+    kv_rec_buf_t rec;
+    size_t key_len;
+    uint32_t addr;
+    cli_error_t err = CLI_ERR_NO_SPACE;
+
+    if (s_kv.flash == NULL)
+    {
+        return CLI_ERR_IO;
+    }
+    if (key == NULL || (value == NULL && len > 0))
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > CLI_KV_MAX_KEY_LEN || len > CLI_KV_MAX_VALUE_LEN)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+
+    /* 新键在写入介质前检查索引容量 */
+    if (!(flags & KV_REC_FLAG_DELETED) && s_kv.keys >= CLI_KV_MAX_KEYS &&
+        kv_index_find(key, key_len, kv_hash(key, key_len), NULL) < 0)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+
+    rec.hdr.key_len = (uint8_t)key_len;
+    rec.hdr.flags = flags;
+    rec.hdr.val_len = (uint16_t)len;
+    memcpy(rec.data, key, key_len);
+    if (len > 0)
+    {
+        memcpy(rec.data + key_len, value, len);
+    }
+    rec.hdr.crc = kv_rec_crc(&rec);
+
+    /* 每个扇区最多尝试一次切换，整理无法腾出空间时返回空间不足 */
+    for (uint32_t tries = 0; tries <= s_kv.flash->sector_count; tries++)
+    {
+        err = kv_write_record(&rec, &addr);
+        if (err != CLI_ERR_NO_SPACE)
+        {
+            break;
+        }
+        err = kv_advance();
+        if (err != CLI_SUCCESS)
+        {
+            break;
+        }
+        err = CLI_ERR_NO_SPACE;
+    }
+    if (err != CLI_SUCCESS)
+    {
+        return err;
+    }
+    return kv_index_apply(&rec, addr);
+}
+
+/* 扫描一个扇区的记录，返回日志结束处的偏移 */
+static uint32_t kv_scan_sector(uint32_t sector)
+{
+    uint32_t base = kv_sector_addr(sector);
+    uint32_t off = KV_SECTOR_HDR_SIZE;
+    kv_rec_buf_t rec;
+
+    for (;;)
+    {
+        int len = kv_read_record(base + off, base + s_kv.flash->sector_size, &rec);
+        if (len == 0)
+        {
+            return off;
+        }
+        if (len < 0)
+        {
+            /* 掉电导致的残缺记录：其后不再写入 */
+            return s_kv.flash->sector_size;
+        }
+        kv_index_apply(&rec, base + off);
+        s_kv.records++;
+        off += (uint32_t)len;
+    }
+}
+
+/* 挂载 */
+cli_error_t cli_kv_mount(const cli_kv_flash_t *flash)
+{
+    uint32_t start = cli_get_tick_ms();
+    uint32_t order[CLI_KV_MAX_SECTORS];
+    uint32_t used = 0;
+    cli_error_t err;
+
+    if (flash == NULL || flash->read == NULL || flash->write == NULL || flash->erase == NULL ||
+        flash->sector_count < 2 || flash->sector_count > CLI_KV_MAX_SECTORS ||
+        flash->sector_size < 256 || (flash->sector_size & 3u) != 0)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+
+    memset(&s_kv, 0, sizeof(s_kv));
+    memset(s_kv.index, 0xFF, sizeof(s_kv.index));
+    s_kv.flash = flash;
+    s_kv.next_seq = 1;
+
+    /* 读取扇区头，未格式化的扇区立即格式化为空闲 */
+    for (uint32_t i = 0; i < flash->sector_count; i++)
+    {
+        kv_sector_hdr_t hdr;
+        if (flash->read(flash->ctx, kv_sector_addr(i), &hdr, sizeof(hdr)) != 0)
+        {
+            s_kv.flash = NULL;
+            return CLI_ERR_IO;
+        }
+        if (hdr.magic != KV_SECTOR_MAGIC)
+        {
+            err = kv_format_sector(i, 0);
+            if (err != CLI_SUCCESS)
+            {
+                s_kv.flash = NULL;
+                return err;
+            }
+            continue;
+        }
+        s_kv.seq[i] = hdr.seq;
+        s_kv.erase_count[i] = hdr.erase_count;
+        if (hdr.seq != KV_SEQ_FREE)
+        {
+            /* 按 seq 插入排序 */
+            uint32_t j = used++;
+            while (j > 0 && s_kv.seq[order[j - 1]] > hdr.seq)
+            {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+            if (hdr.seq >= s_kv.next_seq)
+            {
+                s_kv.next_seq = hdr.seq + 1;
+            }
+        }
+    }
+
+    /* 按写入顺序重放日志 */
+    for (uint32_t i = 0; i < used; i++)
+    {
+        s_kv.active = order[i];
+        s_kv.write_off = kv_scan_sector(order[i]);
+    }
+
+    if (used == 0)
+    {
+        err = kv_activate((uint32_t)kv_pick_free());
+    }
+    else if (kv_free_count() == 0)
+    {
+        /* 整理过程中掉电：继续把最旧扇区整理到活动扇区 */
+        err = kv_compact();
+    }
+    else
+    {
+        err = CLI_SUCCESS;
+    }
+    if (err != CLI_SUCCESS)
+    {
+        s_kv.flash = NULL;
+        return err;
+    }
+
+    s_kv.mount_ms = cli_get_tick_ms() - start;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_kv_set(const char *key, const void *value, size_t len)
+{
+    return kv_append(key, value, len, 0);
+}
+
+cli_error_t cli_kv_delete(const char *key)
+{
+    if (s_kv.flash == NULL || key == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    if (kv_index_find(key, strlen(key), kv_hash(key, strlen(key)), NULL) < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    return kv_append(key, NULL, 0, KV_REC_FLAG_DELETED);
+}
+
+int cli_kv_get(const char *key, void *buf, size_t size)
+{
+    size_t key_len;
+    int slot;
+    kv_rec_buf_t rec;
+    uint32_t addr;
+    uint32_t limit;
+    size_t n;
+
+    if (s_kv.flash == NULL || key == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > CLI_KV_MAX_KEY_LEN)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    slot = kv_index_find(key, key_len, kv_hash(key, key_len), NULL);
+    if (slot < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    addr = s_kv.index[slot].addr;
+    limit = addr - addr % s_kv.flash->sector_size + s_kv.flash->sector_size;
+    if (kv_read_record(addr, limit, &rec) <= 0)
+    {
+        return CLI_ERR_IO;
+    }
+    n = rec.hdr.val_len;
+    if (buf != NULL)
+    {
+        memcpy(buf, rec.data + rec.hdr.key_len, (n < size) ? n : size);
+    }
+    return (int)n;
+}
+
+int cli_kv_iterate(int pos, char *key, size_t key_size)
+{
+    if (s_kv.flash == NULL || pos < 0 || key == NULL || key_size == 0)
+    {
+        return -1;
+    }
+    for (; pos < KV_INDEX_SIZE; pos++)
+    {
+        kv_rec_hdr_t hdr;
+        uint32_t addr = s_kv.index[pos].addr;
+        size_t n;
+        if (addr == KV_ADDR_EMPTY || addr == KV_ADDR_DELETED)
+        {
+            continue;
+        }
+        if (s_kv.flash->read(s_kv.flash->ctx, addr, &hdr, KV_REC_HDR_SIZE) != 0)
+        {
+            continue;
+        }
+        n = (hdr.key_len < key_size - 1) ? hdr.key_len : key_size - 1;
+        if (s_kv.flash->read(s_kv.flash->ctx, addr + KV_REC_HDR_SIZE, key, n) != 0)
+        {
+            continue;
+        }
+        key[n] = '\0';
+        return pos + 1;
+    }
+    return -1;
+}
+
+void cli_kv_get_stats(cli_kv_stats_t *stats)
+{
+    uint32_t used = 0;
+
+    if (stats == NULL)
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (s_kv.flash == NULL)
+    {
+        return;
+    }
+    stats->keys = s_kv.keys;
+    stats->records = s_kv.records;
+    stats->compactions = s_kv.compactions;
+    stats->mount_ms = s_kv.mount_ms;
+    stats->bytes_total = s_kv.flash->sector_size * s_kv.flash->sector_count;
+    stats->min_erase = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < s_kv.flash->sector_count; i++)
+    {
+        if (s_kv.seq[i] != KV_SEQ_FREE)
+        {
+            used += (i == s_kv.active) ? s_kv.write_off : s_kv.flash->sector_size;
+        }
+        if (s_kv.erase_count[i] > stats->max_erase)
+        {
+            stats->max_erase = s_kv.erase_count[i];
+        }
+        if (s_kv.erase_count[i] < stats->min_erase)
+        {
+            stats->min_erase = s_kv.erase_count[i];
+        }
+    }
+    stats->bytes_used = used;
+}
+
+/* 将存储中的值恢复到持久化变量 */
+int cli_kv_load_vars(void)
+{
+    int restored = 0;
+    int count = cli_var_get_count();
+
+    for (int i = 0; i < count; i++)
+    {
+        const cli_var_t *var = cli_var_get_dsc(i);
+        char text[CLI_VAR_TEXT_MAX];
+        cli_var_value_t value;
+        int n;
+
+        if (!(var->flags & CLI_VAR_FLAG_PERSIST))
+        {
+            continue;
+        }
+        n = cli_kv_get(var->name, text, sizeof(text) - 1);
+        if (n < 0 || n >= (int)sizeof(text))
+        {
+            continue;
+        }
+        text[n] = '\0';
+        if (cli_var_parse(var, text, &value) == CLI_SUCCESS &&
+            cli_var_store(var, value) == CLI_SUCCESS)
+        {
+            restored++;
+        }
+    }
+    return restored;
+}
+
+/* 保存持久化变量，仅写入与存储不同的值以减少磨损；返回写入数量或错误码 */
+static int kv_save_vars(void)
+{
+    int written = 0;
+    int count = cli_var_get_count();
+
+    for (int i = 0; i < count; i++)
+    {
+        const cli_var_t *var = cli_var_get_dsc(i);
+        char text[CLI_VAR_TEXT_MAX];
+        char stored[CLI_VAR_TEXT_MAX];
+        size_t len;
+        int n;
+        cli_error_t err;
+
+        if (!(var->flags & CLI_VAR_FLAG_PERSIST))
+        {
+            continue;
+        }
+        len = cli_var_format(var, cli_var_load(var), text, sizeof(text));
+        n = cli_kv_get(var->name, stored, sizeof(stored));
+        if (n == (int)len && memcmp(stored, text, len) == 0)
+        {
+            continue;
+        }
+        err = cli_kv_set(var->name, text, len);
+        if (err != CLI_SUCCESS)
+        {
+            return err;
+        }
+        written++;
+    }
+    return written;
+}
+
+/* 输出错误原因 */
+static int kv_report(cli_error_t err)
+{
+    switch (err)
+    {
+        case CLI_SUCCESS:
+            return 0;
+        case CLI_ERR_NOT_FOUND:
+            cli_puts("Key not found\r\n");
+            break;
+        case CLI_ERR_NO_SPACE:
+        case CLI_ERR_TABLE_FULL:
+            cli_puts("Store full\r\n");
+            break;
+        case CLI_ERR_INVALID_PARAM:
+            cli_puts("Invalid key or value length\r\n");
+            break;
+        default:
+            cli_puts("Store I/O error\r\n");
+            break;
+    }
+    return -1;
+}
+
+/* config 命令 */
+static int cmd_config(int argc, char **argv)
+{
+    const char *sub = (argc > 1) ? argv[1] : "";
+
+    if (s_kv.flash == NULL)
+    {
+        cli_puts("Config store not mounted\r\n");
+        return -1;
+    }
+
+    if (strcmp(sub, "set") == 0 && argc == 4)
+    {
+        const cli_var_t *var = cli_var_find(argv[2]);
+        cli_var_value_t value;
+        /* 同名持久化变量同时更新 */
+        if (var != NULL && (var->flags & CLI_VAR_FLAG_PERSIST))
+        {
+            cli_error_t err = cli_var_parse(var, argv[3], &value);
+            if (err == CLI_SUCCESS)
+            {
+                err = cli_var_store(var, value);
+            }
+            if (err != CLI_SUCCESS)
+            {
+                cli_printf("Invalid value for %s\r\n", var->name);
+                return -1;
+            }
+        }
+        return kv_report(cli_kv_set(argv[2], argv[3], strlen(argv[3])));
+    }
+    else if (strcmp(sub, "get") == 0 && argc == 3)
+    {
+        char value[CLI_KV_MAX_VALUE_LEN + 1];
+        int n = cli_kv_get(argv[2], value, CLI_KV_MAX_VALUE_LEN);
+        if (n < 0)
+        {
+            return kv_report((cli_error_t)n);
+        }
+        value[n] = '\0';
+        cli_printf("%s = %s\r\n", argv[2], value);
+        return 0;
+    }
+    else if (strcmp(sub, "del") == 0 && argc == 3)
+    {
+        return kv_report(cli_kv_delete(argv[2]));
+    }
+    else if (strcmp(sub, "list") == 0)
+    {
+        char key[CLI_KV_MAX_KEY_LEN + 1];
+        char value[CLI_KV_MAX_VALUE_LEN + 1];
+        int pos = 0;
+        while ((pos = cli_kv_iterate(pos, key, sizeof(key))) >= 0)
+        {
+            int n = cli_kv_get(key, value, CLI_KV_MAX_VALUE_LEN);
+            if (n >= 0)
+            {
+                value[n] = '\0';
+                cli_printf("  %s = %s\r\n", key, value);
+            }
+        }
+        return 0;
+    }
+    else if (strcmp(sub, "save") == 0)
+    {
+        int n = kv_save_vars();
+        if (n < 0)
+        {
+            return kv_report((cli_error_t)n);
+        }
+        cli_printf("%d value(s) written\r\n", n);
+        return 0;
+    }
+    else if (strcmp(sub, "load") == 0)
+    {
+        cli_printf("%d value(s) restored\r\n", cli_kv_load_vars());
+        return 0;
+    }
+    else if (strcmp(sub, "info") == 0)
+    {
+        cli_kv_stats_t st;
+        cli_kv_get_stats(&st);
+        cli_printf("keys: %u/%u, used: %u/%u bytes\r\n",
+                   (unsigned int)st.keys, (unsigned int)CLI_KV_MAX_KEYS,
+                   (unsigned int)st.bytes_used, (unsigned int)st.bytes_total);
+        cli_printf("erase count: %u..%u, compactions: %u\r\n",
+                   (unsigned int)st.min_erase, (unsigned int)st.max_erase,
+                   (unsigned int)st.compactions);
+        cli_printf("mount: %u records in %u ms\r\n",
+                   (unsigned int)st.records, (unsigned int)st.mount_ms);
+        return 0;
+    }
+    else if (strcmp(sub, "bench") == 0)
+    {
+        const cli_kv_flash_t *flash = s_kv.flash;
+        uint32_t rounds = 100u;
+        uint32_t start;
+        uint32_t elapsed;
+        cli_kv_stats_t st;
+
+        if (argc > 2 && cli_arg_u32(CLI_ARG(argv[2]), 1, 100000u, &rounds) != CLI_SUCCESS)
+        {
+            cli_arg_report("rounds", CLI_ARG(argv[2]));
+            return -1;
+        }
+        start = cli_get_tick_ms();
+        for (uint32_t i = 0; i < rounds; i++)
+        {
+            cli_error_t err = cli_kv_mount(flash);
+            if (err != CLI_SUCCESS)
+            {
+                return kv_report(err);
+            }
+        }
+        elapsed = cli_get_tick_ms() - start;
+        cli_kv_get_stats(&st);
+        cli_printf("%u mounts, %u records / %u bytes scanned each: %u us/mount\r\n",
+                   (unsigned int)rounds, (unsigned int)st.records, (unsigned int)st.bytes_used,
+                   (unsigned int)((uint64_t)elapsed * 1000u / rounds));
+        return 0;
+    }
+
+    cli_puts("Usage: config set <key> <value> | get <key> | del <key> | list | save | load | info | bench [n]\r\n");
+    return -1;
+}
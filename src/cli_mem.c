@@ -0,0 +1,574 @@
+/*
+ * @file cli_mem.c
+ * @brief 内存查看命令实现
+ *
+ * 所有访问都按指定宽度（1/2/4/8字节）经 volatile 指针进行，适用于外设寄存器。
+ * 十六进制转储使用 SWAR 方式一次把32位值展开为8个字符，整行格式化后再
+ * 积累到输出缓冲区，以 cli_write 成块写出，避免逐字符输出。
+ */
+
+#include <cli_mem.h>
+#include <cli_z.h>
+#include <cli_arg.h>
+#include <cli_table.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* 转储输出缓冲区大小 */
+#ifndef CLI_MEM_OUT_BUF
+#define CLI_MEM_OUT_BUF         1024
+#endif
+
+/* 每行字节数 */
+#define MEM_ROW_BYTES           16
+
+/* mc 最多列出的差异数 */
+#define MEM_MC_MAX_REPORT       8
+
+/* 区域表 */
+static cli_mem_region_t s_regions[CLI_MEM_MAX_REGIONS];
+static int s_region_count = 0;
+
+static int cmd_md(int argc, char **argv);
+static int cmd_mw(int argc, char **argv);
+static int cmd_mf(int argc, char **argv);
+static int cmd_mc(int argc, char **argv);
+
+const cli_command_t cli_mem_md_cmd = {
+    .name = "md",
+    .short_name = NULL,
+    .help = CLI_HELP("Memory display: md [-w 1|2|4|8] [-z] <addr> [len]"),
+    .handler = cmd_md
+};
+
+const cli_command_t cli_mem_mw_cmd = {
+    .name = "mw",
+    .short_name = NULL,
+    .help = CLI_HELP("Memory write: mw [-w 1|2|4|8] <addr> <value>"),
+    .handler = cmd_mw
+};
+
+const cli_command_t cli_mem_mf_cmd = {
+    .name = "mf",
+    .short_name = NULL,
+    .help = CLI_HELP("Memory fill: mf [-w 1|2|4|8] <addr> <len> <value>"),
+    .handler = cmd_mf
+};
+
+const cli_command_t cli_mem_mc_cmd = {
+    .name = "mc",
+    .short_name = NULL,
+    .help = CLI_HELP("Memory compare: mc [-w 1|2|4|8] <addr1> <addr2> <len>"),
+    .handler = cmd_mc
+};
+
+cli_error_t cli_mem_region_register(const char *name, uint64_t base, volatile void *ptr, size_t size, uint8_t flags)
+{
+    if (name == NULL || ptr == NULL || size == 0 || base + size < base)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    for (int i = 0; i < s_region_count; i++)
+    {
+        if (strcmp(s_regions[i].name, name) == 0)
+        {
+            return CLI_ERR_DUPLICATE;
+        }
+    }
+    if (s_region_count >= CLI_MEM_MAX_REGIONS)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    s_regions[s_region_count].name = name;
+    s_regions[s_region_count].base = base;
+    s_regions[s_region_count].ptr = ptr;
+    s_regions[s_region_count].size = size;
+    s_regions[s_region_count].flags = flags;
+    s_region_count++;
+    return CLI_SUCCESS;
+}
+
+/* 查找包含 [addr, addr+len) 的区域 */
+static const cli_mem_region_t* mem_find(uint64_t addr, uint64_t len)
+{
+    for (int i = 0; i < s_region_count; i++)
+    {
+        const cli_mem_region_t *r = &s_regions[i];
+        if (addr >= r->base && len <= r->size && addr - r->base <= r->size - len)
+        {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+/* 设备地址转换为本地指针 */
+static volatile uint8_t* mem_ptr(const cli_mem_region_t *r, uint64_t addr)
+{
+    return (volatile uint8_t *)r->ptr + (size_t)(addr - r->base);
+}
+
+/* 32位值展开为8个十六进制字符（SWAR：一次处理全部8个半字节） */
+static void mem_hex32(char *out, uint32_t x)
+{
+    uint64_t v = x;
+    uint64_t mask;
+
+    /* 每个半字节展开到独立字节，最高半字节位于最高字节 */
+    v = ((v & 0xFFFF0000ull) << 16) | (v & 0x0000FFFFull);
+    v = ((v & 0x0000FF000000FF00ull) << 8) | (v & 0x000000FF000000FFull);
+    v = ((v & 0x00F000F000F000F0ull) << 4) | (v & 0x000F000F000F000Full);
+    /* 大于9的半字节额外加上 'a' - '0' - 10 */
+    mask = ((v + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+    v += 0x3030303030303030ull + mask * 0x27u;
+
+    out[0] = (char)(v >> 56);
+    out[1] = (char)(v >> 48);
+    out[2] = (char)(v >> 40);
+    out[3] = (char)(v >> 32);
+    out[4] = (char)(v >> 24);
+    out[5] = (char)(v >> 16);
+    out[6] = (char)(v >> 8);
+    out[7] = (char)v;
+}
+
+/* 按宽度读取一个单元（本地字节序） */
+static uint64_t mem_load(volatile const uint8_t *p, unsigned int width)
+{
+    switch (width)
+    {
+        case 1:
+            return *p;
+        case 2:
+            return *(volatile const uint16_t *)p;
+        case 4:
+            return *(volatile const uint32_t *)p;
+        default:
+            return *(volatile const uint64_t *)p;
+    }
+}
+
+/* 按宽度写入一个单元 */
+static void mem_store(volatile uint8_t *p, unsigned int width, uint64_t value)
+{
+    switch (width)
+    {
+        case 1:
+            *p = (uint8_t)value;
+            break;
+        case 2:
+            *(volatile uint16_t *)p = (uint16_t)value;
+            break;
+        case 4:
+            *(volatile uint32_t *)p = (uint32_t)value;
+            break;
+        default:
+            *(volatile uint64_t *)p = value;
+            break;
+    }
+}
+
+/* 格式化一个单元的十六进制值 */
+static size_t mem_hex_unit(char *out, uint64_t value, unsigned int width)
+{
+    char tmp[16];
+    mem_hex32(tmp, (uint32_t)(value >> 32));
+    mem_hex32(tmp + 8, (uint32_t)value);
+    memcpy(out, tmp + 16 - width * 2, width * 2);
+    return width * 2;
+}
+
+size_t cli_mem_format_row(char *out, uint64_t addr, const uint8_t *data, size_t len, unsigned int width, int addr_digits)
+{
+    char tmp[16];
+    size_t n = 0;
+    size_t i;
+    size_t row_chars = (MEM_ROW_BYTES / width) * (width * 2 + 1);
+
+    if (len > MEM_ROW_BYTES)
+    {
+        len = MEM_ROW_BYTES;
+    }
+
+    /* 地址 */
+    mem_hex32(tmp, (uint32_t)(addr >> 32));
+    mem_hex32(tmp + 8, (uint32_t)addr);
+    memcpy(out, tmp + 16 - addr_digits, (size_t)addr_digits);
+    n = (size_t)addr_digits;
+    out[n++] = ':';
+
+    if (width == 1)
+    {
+        /* 字节模式：每4字节做一次展开 */
+        for (i = 0; i < len; i += 4)
+        {
+            uint32_t x = 0;
+            size_t k = (len - i < 4) ? len - i : 4;
+            for (size_t j = 0; j < 4; j++)
+            {
+                x = (x << 8) | ((j < k) ? data[i + j] : 0u);
+            }
+            mem_hex32(tmp, x);
+            for (size_t j = 0; j < k; j++)
+            {
+                out[n++] = ' ';
+                out[n++] = tmp[j * 2];
+                out[n++] = tmp[j * 2 + 1];
+            }
+        }
+        i = len * 3;
+    }
+    else
+    {
+        for (i = 0; i + width <= len; i += width)
+        {
+            uint64_t value = 0;
+            memcpy(&value, data + i, width);
+            out[n++] = ' ';
+            n += mem_hex_unit(out + n, value, width);
+        }
+        i = (len / width) * (width * 2 + 1);
+    }
+
+    /* 末行补齐，使 ASCII 列对齐 */
+    while (i < row_chars)
+    {
+        out[n++] = ' ';
+        i++;
+    }
+
+    out[n++] = ' ';
+    out[n++] = ' ';
+    out[n++] = '|';
+    for (i = 0; i < len; i++)
+    {
+        out[n++] = (data[i] >= 0x20 && data[i] <= 0x7E) ? (char)data[i] : '.';
+    }
+    out[n++] = '|';
+    out[n++] = '\r';
+    out[n++] = '\n';
+    return n;
+}
+
+/* 解析 -w/-z 选项并收集位置参数，返回位置参数个数，-1 表示错误 */
+static int mem_parse_args(int argc, char **argv, unsigned int *width, bool *compress, char **pos, int max_pos)
+{
+    int count = 0;
+
+    *width = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (compress != NULL && strcmp(argv[i], "-z") == 0)
+        {
+            *compress = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            uint32_t w = 0;
+            i++;
+            if (cli_arg_u32(CLI_ARG(argv[i]), 1, 8, &w) != CLI_SUCCESS || (w & (w - 1)) != 0)
+            {
+                cli_puts("Width must be 1, 2, 4 or 8\r\n");
+                return -1;
+            }
+            *width = (unsigned int)w;
+        }
+        else
+        {
+            if (count >= max_pos)
+            {
+                return -1;
+            }
+            pos[count++] = argv[i];
+        }
+    }
+    return count;
+}
+
+/* 解析地址（十进制或 0x 十六进制），失败时输出提示 */
+static bool mem_parse_addr(const char *text, uint64_t *addr)
+{
+    if (cli_arg_u64(CLI_ARG(text), 0, UINT64_MAX, addr) != CLI_SUCCESS)
+    {
+        cli_arg_report("address", CLI_ARG(text));
+        return false;
+    }
+    return true;
+}
+
+/* 解析长度，可带 k/M/G 后缀 */
+static bool mem_parse_len(const char *text, uint64_t *len)
+{
+    if (cli_arg_size(CLI_ARG(text), 1, UINT64_MAX, len) != CLI_SUCCESS)
+    {
+        cli_arg_report("length", CLI_ARG(text));
+        return false;
+    }
+    return true;
+}
+
+/* 解析写入值，不能超出访问宽度 */
+static bool mem_parse_value(const char *text, unsigned int width, uint64_t *value)
+{
+    uint64_t max = (width >= 8u) ? UINT64_MAX : ((1ull << (8u * width)) - 1u);
+
+    if (cli_arg_u64(CLI_ARG(text), 0, max, value) != CLI_SUCCESS)
+    {
+        cli_arg_report("value", CLI_ARG(text));
+        return false;
+    }
+    return true;
+}
+
+/* 检查访问范围、对齐和写权限，返回区域 */
+static const cli_mem_region_t* mem_check(uint64_t addr, uint64_t len, unsigned int width, bool write)
+{
+    const cli_mem_region_t *r = mem_find(addr, len);
+    if (r == NULL)
+    {
+        cli_puts("Address range not in any region\r\n");
+        return NULL;
+    }
+    if ((addr % width) != 0 || (len % width) != 0 ||
+        ((uintptr_t)mem_ptr(r, addr) % width) != 0)
+    {
+        cli_puts("Unaligned access\r\n");
+        return NULL;
+    }
+    if (write && (r->flags & CLI_MEM_FLAG_READONLY))
+    {
+        cli_printf("Region %s is read-only\r\n", r->name);
+        return NULL;
+    }
+    return r;
+}
+
+/* 输出区域列表 */
+static void mem_list_regions(void)
+{
+    static const cli_table_col_t cols[] = {
+        { "start",  CLI_COL_HEX, 10, 0, 8 },
+        { "end",    CLI_COL_HEX, 10, 0, 8 },
+        { "size",   CLI_COL_U64, 8, CLI_COL_RIGHT, 0 },
+        { "access", CLI_COL_STR, 0, 0, 0 },
+        { "name",   CLI_COL_STR, 0, 0, 0 },
+    };
+    cli_table_t table;
+
+    cli_table_begin(&table, cols, 5);
+    for (int i = 0; i < s_region_count; i++)
+    {
+        const cli_mem_region_t *r = &s_regions[i];
+        cli_table_row(&table, r->base, r->base + r->size - 1, (uint64_t)r->size,
+                      (r->flags & CLI_MEM_FLAG_READONLY) ? "ro" : "rw", r->name);
+    }
+    cli_table_end(&table);
+}
+
+/* md 命令 */
+static int cmd_md(int argc, char **argv)
+{
+    char *pos[2];
+    unsigned int width;
+    uint64_t addr;
+    uint64_t len = 64;
+    const cli_mem_region_t *r;
+    volatile const uint8_t *src;
+    char out[CLI_MEM_OUT_BUF];
+    size_t used = 0;
+    int addr_digits;
+    bool compress = false;
+    int n = mem_parse_args(argc, argv, &width, &compress, pos, 2);
+
+    if (n == 0)
+    {
+        mem_list_regions();
+        return 0;
+    }
+    if (n < 0)
+    {
+        cli_puts("Usage: md [-w 1|2|4|8] [-z] <addr> [len]\r\n");
+        return -1;
+    }
+    if (!mem_parse_addr(pos[0], &addr) || (n > 1 && !mem_parse_len(pos[1], &len)))
+    {
+        return -1;
+    }
+    len -= len % width;
+    if (len == 0)
+    {
+        len = width;
+    }
+    r = mem_check(addr, len, width, false);
+    if (r == NULL)
+    {
+        return -1;
+    }
+
+    /* -z：经压缩通道输出 */
+    if (compress && cli_z_begin() != CLI_SUCCESS)
+    {
+        compress = false;
+    }
+
+    addr_digits = (r->base + r->size - 1 > 0xFFFFFFFFull) ? 16 : 8;
+    src = mem_ptr(r, addr);
+    for (uint64_t off = 0; off < len; off += MEM_ROW_BYTES)
+    {
+        uint8_t row[MEM_ROW_BYTES];
+        size_t k = (len - off < MEM_ROW_BYTES) ? (size_t)(len - off) : MEM_ROW_BYTES;
+
+        for (size_t i = 0; i < k; i += width)
+        {
+            uint64_t v = mem_load(src + off + i, width);
+            memcpy(row + i, &v, width);
+        }
+        if (used + CLI_MEM_ROW_MAX > sizeof(out))
+        {
+            cli_write(out, used);
+            used = 0;
+        }
+        used += cli_mem_format_row(out + used, addr + off, row, k, width, addr_digits);
+    }
+    cli_write(out, used);
+    if (compress)
+    {
+        cli_z_end();
+    }
+    return 0;
+}
+
+/* mw 命令 */
+static int cmd_mw(int argc, char **argv)
+{
+    char *pos[2];
+    unsigned int width;
+    uint64_t addr;
+    uint64_t value;
+    const cli_mem_region_t *r;
+    int n = mem_parse_args(argc, argv, &width, NULL, pos, 2);
+
+    if (n != 2)
+    {
+        cli_puts("Usage: mw [-w 1|2|4|8] <addr> <value>\r\n");
+        return -1;
+    }
+    if (!mem_parse_addr(pos[0], &addr) || !mem_parse_value(pos[1], width, &value))
+    {
+        return -1;
+    }
+    r = mem_check(addr, width, width, true);
+    if (r == NULL)
+    {
+        return -1;
+    }
+    mem_store(mem_ptr(r, addr), width, value);
+    return 0;
+}
+
+/* mf 命令 */
+static int cmd_mf(int argc, char **argv)
+{
+    char *pos[3];
+    unsigned int width;
+    uint64_t addr;
+    uint64_t len;
+    uint64_t value;
+    const cli_mem_region_t *r;
+    volatile uint8_t *dst;
+    int n = mem_parse_args(argc, argv, &width, NULL, pos, 3);
+
+    if (n != 3)
+    {
+        cli_puts("Usage: mf [-w 1|2|4|8] <addr> <len> <value>\r\n");
+        return -1;
+    }
+    if (!mem_parse_addr(pos[0], &addr) || !mem_parse_len(pos[1], &len) ||
+        !mem_parse_value(pos[2], width, &value))
+    {
+        return -1;
+    }
+    r = mem_check(addr, len, width, true);
+    if (r == NULL)
+    {
+        return -1;
+    }
+    dst = mem_ptr(r, addr);
+    for (uint64_t off = 0; off < len; off += width)
+    {
+        mem_store(dst + off, width, value);
+    }
+    return 0;
+}
+
+/* mc 命令 */
+static int cmd_mc(int argc, char **argv)
+{
+    char *pos[3];
+    unsigned int width;
+    uint64_t a1;
+    uint64_t a2;
+    uint64_t len;
+    const cli_mem_region_t *r1;
+    const cli_mem_region_t *r2;
+    volatile const uint8_t *p1;
+    volatile const uint8_t *p2;
+    uint32_t diffs = 0;
+    int n = mem_parse_args(argc, argv, &width, NULL, pos, 3);
+
+    if (n != 3)
+    {
+        cli_puts("Usage: mc [-w 1|2|4|8] <addr1> <addr2> <len>\r\n");
+        return -1;
+    }
+    if (!mem_parse_addr(pos[0], &a1) || !mem_parse_addr(pos[1], &a2) || !mem_parse_len(pos[2], &len))
+    {
+        return -1;
+    }
+    r1 = mem_check(a1, len, width, false);
+    r2 = (r1 != NULL) ? mem_check(a2, len, width, false) : NULL;
+    if (r2 == NULL)
+    {
+        return -1;
+    }
+
+    p1 = mem_ptr(r1, a1);
+    p2 = mem_ptr(r2, a2);
+    for (uint64_t off = 0; off < len; off += width)
+    {
+        uint64_t v1 = mem_load(p1 + off, width);
+        uint64_t v2 = mem_load(p2 + off, width);
+        if (v1 != v2)
+        {
+            if (diffs < MEM_MC_MAX_REPORT)
+            {
+                char line[80];
+                char tmp[16];
+                size_t k = 0;
+                mem_hex32(tmp, (uint32_t)((a1 + off) >> 32));
+                mem_hex32(tmp + 8, (uint32_t)(a1 + off));
+                memcpy(line, tmp, 16);
+                k = 16;
+                line[k++] = ':';
+                line[k++] = ' ';
+                k += mem_hex_unit(line + k, v1, width);
+                memcpy(line + k, " != ", 4);
+                k += 4;
+                mem_hex32(tmp, (uint32_t)((a2 + off) >> 32));
+                mem_hex32(tmp + 8, (uint32_t)(a2 + off));
+                memcpy(line + k, tmp, 16);
+                k += 16;
+                line[k++] = ':';
+                line[k++] = ' ';
+                k += mem_hex_unit(line + k, v2, width);
+                line[k++] = '\r';
+                line[k++] = '\n';
+                cli_write(line, k);
+            }
+            diffs++;
+        }
+    }
+    cli_printf("%u difference(s) in %u unit(s)\r\n", (unsigned int)diffs, (unsigned int)(len / width));
+    return (diffs == 0) ? 0 : 1;
+}
@@ -0,0 +1,773 @@
+/*
+ * @file cli_metrics.c
+ * @brief 指标登记表和 OpenMetrics 导出实现
+ *
+ * 每个分片是一个值槽数组，按缓存行对齐；指标登记时分配连续的值槽，各分片
+ * 中同一下标为同一个值。直方图的槽依次为各桶（最后一个为 +Inf，非累计）和
+ * 观测值之和，观测次数为各桶之和，因此导出时 _count 与桶总是一致。
+ * 导出时逐槽读取各分片，不暂停更新，不同指标之间不保证是同一时刻的快照。
+ */
+
+#define _GNU_SOURCE
+
+#include <cli_metrics.h>
+#include <cli_arg.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+/* 指标的第一个值槽（base 为槽号+1，0 表示未登记） */
+#define MET_BASE(m)             ((uint16_t)((m)->base - 1u))
+
+#if CLI_METRICS_WIDE
+typedef int64_t met_signed_t;
+#else
+typedef int32_t met_signed_t;
+#endif
+
+/* 值槽分片，对齐到缓存行，不同线程的分片不共享缓存行 */
+typedef struct
+{
+    cli_metric_value_t v[CLI_METRICS_MAX_VALUES];
+}
+#if CLI_METRICS_SHARDS > 1
+__attribute__((aligned(64)))
+#endif
+met_shard_t;
+
+static met_shard_t s_shards[CLI_METRICS_SHARDS];
+
+/* 登记表（只在初始化阶段由主循环修改） */
+static const cli_metric_t *s_metrics[CLI_METRICS_MAX];
+static int s_metric_count = 0;
+static uint16_t s_value_count = 0;
+
+#if CLI_METRICS_SHARDS > 1
+/* 本线程的分片号+1，0 表示尚未分配 */
+static __thread uint8_t s_my_shard;
+static uint32_t s_next_shard;
+
+static met_shard_t *met_shard(void)
+{
+    if (s_my_shard == 0)
+    {
+        uint32_t n = __atomic_fetch_add(&s_next_shard, 1u, __ATOMIC_RELAXED);
+        s_my_shard = (uint8_t)(n % CLI_METRICS_SHARDS + 1u);
+    }
+    return &s_shards[s_my_shard - 1u];
+}
+#else
+#define met_shard()     (&s_shards[0])
+#endif
+
+static int met_cmd(int argc, char **argv);
+
+const cli_command_t cli_metrics_cmd = {
+    .name = "metrics",
+    .short_name = NULL,
+    .help = CLI_HELP("Show metrics (OpenMetrics): metrics [listen [port [addr]]|stop]"),
+    .handler = met_cmd
+};
+
+static bool met_name_valid(const char *name)
+{
+    const char *p = name;
+
+    if (name == NULL || name[0] == '\0' || (name[0] >= '0' && name[0] <= '9'))
+    {
+        return false;
+    }
+    for (; *p != '\0'; p++)
+    {
+        char c = *p;
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_' || c == ':'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 校验、分配值槽并加入登记表 */
+static cli_error_t met_register(cli_metric_t *m, const char *name, const char *help,
+                                cli_metric_type_t type, uint16_t nvalues)
+{
+    int i;
+
+    if (m == NULL || !met_name_valid(name))
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < s_metric_count; i++)
+    {
+        if (s_metrics[i] == m || strcmp(s_metrics[i]->name, name) == 0)
+        {
+            return CLI_ERR_DUPLICATE;
+        }
+    }
+    if (s_metric_count >= CLI_METRICS_MAX || s_value_count + nvalues > CLI_METRICS_MAX_VALUES)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+    m->name = name;
+    m->help = help;
+    m->type = (uint8_t)type;
+    m->base = (uint16_t)(s_value_count + 1u);
+    s_value_count = (uint16_t)(s_value_count + nvalues);
+    s_metrics[s_metric_count++] = m;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_metrics_counter(cli_metric_t *m, const char *name, const char *help)
+{
+    if (m != NULL)
+    {
+        m->bounds = NULL;
+        m->read = NULL;
+        m->nbuckets = 0;
+    }
+    return met_register(m, name, help, CLI_METRIC_COUNTER, 1u);
+}
+
+cli_error_t cli_metrics_gauge(cli_metric_t *m, const char *name, const char *help, cli_metric_read_t read)
+{
+    if (m != NULL)
+    {
+        m->bounds = NULL;
+        m->read = read;
+        m->nbuckets = 0;
+    }
+    return met_register(m, name, help, CLI_METRIC_GAUGE, (read != NULL) ? 0u : 1u);
+}
+
+cli_error_t cli_metrics_histogram(cli_metric_t *m, const char *name, const char *help,
+                                  const uint32_t *bounds, uint8_t nbuckets)
+{
+    uint8_t i;
+
+    if (m == NULL || bounds == NULL || nbuckets == 0 || nbuckets > CLI_METRICS_MAX_BUCKETS)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    for (i = 1; i < nbuckets; i++)
+    {
+        if (bounds[i] <= bounds[i - 1u])
+        {
+            return CLI_ERR_INVALID_PARAM;
+        }
+    }
+    m->bounds = bounds;
+    m->read = NULL;
+    m->nbuckets = nbuckets;
+    /* 各桶、+Inf 桶、观测值之和 */
+    return met_register(m, name, help, CLI_METRIC_HISTOGRAM, (uint16_t)(nbuckets + 2u));
+}
+
+void cli_metrics_add(cli_metric_t *m, uint32_t n)
+{
+    if (m != NULL && m->base != 0 && m->type == CLI_METRIC_COUNTER)
+    {
+        __atomic_fetch_add(&met_shard()->v[MET_BASE(m)], (cli_metric_value_t)n, __ATOMIC_RELAXED);
+    }
+}
+
+void cli_metrics_set(cli_metric_t *m, int32_t value)
+{
+    if (m != NULL && m->base != 0 && m->type == CLI_METRIC_GAUGE && m->read == NULL)
+    {
+        __atomic_store_n(&s_shards[0].v[MET_BASE(m)], (cli_metric_value_t)(met_signed_t)value, __ATOMIC_RELAXED);
+    }
+}
+
+void cli_metrics_gauge_add(cli_metric_t *m, int32_t delta)
+{
+    if (m != NULL && m->base != 0 && m->type == CLI_METRIC_GAUGE && m->read == NULL)
+    {
+        __atomic_fetch_add(&s_shards[0].v[MET_BASE(m)], (cli_metric_value_t)(met_signed_t)delta, __ATOMIC_RELAXED);
+    }
+}
+
+void cli_metrics_observe(cli_metric_t *m, uint32_t value)
+{
+    met_shard_t *shard;
+    uint8_t i = 0;
+
+    if (m == NULL || m->base == 0 || m->type != CLI_METRIC_HISTOGRAM)
+    {
+        return;
+    }
+    while (i < m->nbuckets && value > m->bounds[i])
+    {
+        i++;
+    }
+    shard = met_shard();
+    __atomic_fetch_add(&shard->v[MET_BASE(m) + i], (cli_metric_value_t)1u, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&shard->v[MET_BASE(m) + m->nbuckets + 1u], (cli_metric_value_t)value, __ATOMIC_RELAXED);
+}
+
+/* 各分片中同一值槽之和 */
+static cli_metric_value_t met_sum(uint16_t slot)
+{
+    cli_metric_value_t sum = 0;
+    int s;
+
+    for (s = 0; s < CLI_METRICS_SHARDS; s++)
+    {
+        sum += __atomic_load_n(&s_shards[s].v[slot], __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+cli_metric_value_t cli_metrics_read(const cli_metric_t *m)
+{
+    cli_metric_value_t total = 0;
+    uint8_t i;
+
+    if (m == NULL || m->base == 0)
+    {
+        return 0;
+    }
+    switch (m->type)
+    {
+        case CLI_METRIC_COUNTER:
+            return met_sum(MET_BASE(m));
+        case CLI_METRIC_GAUGE:
+            if (m->read != NULL)
+            {
+                return (cli_metric_value_t)(met_signed_t)m->read();
+            }
+            return __atomic_load_n(&s_shards[0].v[MET_BASE(m)], __ATOMIC_RELAXED);
+        default:
+            for (i = 0; i <= m->nbuckets; i++)
+            {
+                total += met_sum((uint16_t)(MET_BASE(m) + i));
+            }
+            return total;
+    }
+}
+
+/* 无符号十进制，返回长度（buf 至少21字节） */
+static size_t met_fmt_u(char *buf, cli_metric_value_t v)
+{
+    char tmp[20];
+    size_t n = 0;
+    size_t i;
+
+    do
+    {
+        tmp[n++] = (char)('0' + (int)(v % 10u));
+        v /= 10u;
+    } while (v != 0);
+    for (i = 0; i < n; i++)
+    {
+        buf[i] = tmp[n - 1u - i];
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/* 导出上下文 */
+typedef struct
+{
+    cli_metrics_out_t out;
+    void *ctx;
+    const char *nl;
+} met_render_t;
+
+static void met_emit(const met_render_t *r, const char *s)
+{
+    r->out(s, strlen(s), r->ctx);
+}
+
+/* 一行样本：<name><suffix>[{le="<le>"}] <value> */
+static void met_sample(const met_render_t *r, const char *name, const char *suffix,
+                       const char *le, const char *value)
+{
+    met_emit(r, name);
+    met_emit(r, suffix);
+    if (le != NULL)
+    {
+        met_emit(r, "{le=\"");
+        met_emit(r, le);
+        met_emit(r, "\"}");
+    }
+    met_emit(r, " ");
+    met_emit(r, value);
+    met_emit(r, r->nl);
+}
+
+/* HELP 文本中的反斜杠和换行需要转义 */
+static void met_emit_help(const met_render_t *r, const char *help)
+{
+    const char *p = help;
+
+    while (*p != '\0')
+    {
+        size_t n = strcspn(p, "\\\n");
+        if (n > 0)
+        {
+            r->out(p, n, r->ctx);
+            p += n;
+        }
+        if (*p != '\0')
+        {
+            met_emit(r, (*p == '\\') ? "\\\\" : "\\n");
+            p++;
+        }
+    }
+}
+
+static void met_render_one(const met_render_t *r, const cli_metric_t *m)
+{
+    static const char *const type_names[] = { "counter", "gauge", "histogram" };
+    char num[24];
+    char le[12];
+    cli_metric_value_t cum = 0;
+    uint8_t i;
+
+    met_emit(r, "# TYPE ");
+    met_emit(r, m->name);
+    met_emit(r, " ");
+    met_emit(r, type_names[m->type]);
+    met_emit(r, r->nl);
+    if (m->help != NULL && m->help[0] != '\0')
+    {
+        met_emit(r, "# HELP ");
+        met_emit(r, m->name);
+        met_emit(r, " ");
+        met_emit_help(r, m->help);
+        met_emit(r, r->nl);
+    }
+
+    switch (m->type)
+    {
+        case CLI_METRIC_COUNTER:
+            met_fmt_u(num, met_sum(MET_BASE(m)));
+            met_sample(r, m->name, "_total", NULL, num);
+            break;
+        case CLI_METRIC_GAUGE:
+        {
+            met_signed_t v = (met_signed_t)cli_metrics_read(m);
+            if (v < 0)
+            {
+                num[0] = '-';
+                met_fmt_u(num + 1, (cli_metric_value_t)0u - (cli_metric_value_t)v);
+            }
+            else
+            {
+                met_fmt_u(num, (cli_metric_value_t)v);
+            }
+            met_sample(r, m->name, "", NULL, num);
+            break;
+        }
+        default:
+            /* 桶为累计计数 */
+            for (i = 0; i <= m->nbuckets; i++)
+            {
+                cum += met_sum((uint16_t)(MET_BASE(m) + i));
+                met_fmt_u(num, cum);
+                if (i < m->nbuckets)
+                {
+                    met_fmt_u(le, m->bounds[i]);
+                }
+                met_sample(r, m->name, "_bucket", (i < m->nbuckets) ? le : "+Inf", num);
+            }
+            met_fmt_u(num, met_sum((uint16_t)(MET_BASE(m) + m->nbuckets + 1u)));
+            met_sample(r, m->name, "_sum", NULL, num);
+            met_fmt_u(num, cum);
+            met_sample(r, m->name, "_count", NULL, num);
+            break;
+    }
+}
+
+void cli_metrics_render(cli_metrics_out_t out, void *ctx, const char *nl)
+{
+    met_render_t r;
+    int i;
+
+    if (out == NULL)
+    {
+        return;
+    }
+    r.out = out;
+    r.ctx = ctx;
+    r.nl = (nl != NULL) ? nl : "\n";
+    for (i = 0; i < s_metric_count; i++)
+    {
+        met_render_one(&r, s_metrics[i]);
+    }
+    met_emit(&r, "# EOF");
+    met_emit(&r, r.nl);
+}
+
+#if defined(__linux__)
+
+#define MET_REQ_MAX             1024u   /* 请求头超过此长度时不再等待结束 */
+
+static const char s_http_head[] =
+    "HTTP/1.0 200 OK\r\n"
+    "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+/* 抓取客户端 */
+typedef struct
+{
+    int fd;                             /* -1 表示空闲 */
+    uint32_t since;                     /* 连接时刻 */
+    char req[MET_REQ_MAX];
+    size_t req_len;
+    char *out;                          /* 待发送的响应，NULL 表示仍在读请求 */
+    size_t out_len;
+    size_t out_pos;
+} met_client_t;
+
+static struct
+{
+    int fd;                             /* 监听套接字，-1 表示未监听 */
+    bool poll_registered;
+    char addr[INET_ADDRSTRLEN];
+    uint16_t port;
+    uint32_t scrapes;
+    met_client_t clients[CLI_METRICS_CLIENTS];
+} s_listen = { .fd = -1 };
+
+/* 导出到动态缓冲区 */
+typedef struct
+{
+    char *buf;
+    size_t len;
+    size_t cap;
+    bool failed;
+} met_buf_t;
+
+static void met_buf_out(const char *buf, size_t len, void *ctx)
+{
+    met_buf_t *b = (met_buf_t *)ctx;
+
+    if (b->failed)
+    {
+        return;
+    }
+    if (b->len + len > b->cap)
+    {
+        size_t cap = (b->cap != 0) ? b->cap : 4096u;
+        char *p;
+        while (cap < b->len + len)
+        {
+            cap *= 2u;
+        }
+        p = (char *)realloc(b->buf, cap);
+        if (p == NULL)
+        {
+            b->failed = true;
+            return;
+        }
+        b->buf = p;
+        b->cap = cap;
+    }
+    memcpy(b->buf + b->len, buf, len);
+    b->len += len;
+}
+
+static void met_client_close(met_client_t *c)
+{
+    if (c->fd >= 0)
+    {
+        close(c->fd);
+    }
+    free(c->out);
+    c->fd = -1;
+    c->out = NULL;
+}
+
+/* 生成响应：http 为真时加 HTTP 头 */
+static void met_client_respond(met_client_t *c, bool http)
+{
+    met_buf_t b = { NULL, 0, 0, false };
+
+    if (http)
+    {
+        met_buf_out(s_http_head, sizeof(s_http_head) - 1u, &b);
+    }
+    cli_metrics_render(met_buf_out, &b, "\n");
+    if (b.failed)
+    {
+        free(b.buf);
+        met_client_close(c);
+        return;
+    }
+    c->out = b.buf;
+    c->out_len = b.len;
+    c->out_pos = 0;
+    s_listen.scrapes++;
+}
+
+/* 读取请求，判断是 HTTP 还是纯文本客户端 */
+static void met_client_read(met_client_t *c)
+{
+    bool eof = false;
+
+    while (c->req_len < MET_REQ_MAX)
+    {
+        ssize_t n = recv(c->fd, c->req + c->req_len, MET_REQ_MAX - c->req_len, 0);
+        if (n > 0)
+        {
+            c->req_len += (size_t)n;
+        }
+        else if (n == 0)
+        {
+            /* 对端已关闭写方向：按已收到的内容响应 */
+            eof = true;
+            break;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            met_client_close(c);
+            return;
+        }
+    }
+
+    if (c->req_len >= 4u && memcmp(c->req, "GET ", 4u) == 0)
+    {
+        /* 等到请求头结束（或超长）再响应 */
+        if (eof || c->req_len >= MET_REQ_MAX ||
+            memmem(c->req, c->req_len, "\r\n\r\n", 4u) != NULL ||
+            memmem(c->req, c->req_len, "\n\n", 2u) != NULL)
+        {
+            met_client_respond(c, true);
+        }
+    }
+    else if (c->req_len > 0 && memcmp(c->req, "GET ", (c->req_len < 4u) ? c->req_len : 4u) != 0)
+    {
+        met_client_respond(c, false);
+    }
+    else if (eof || cli_get_tick_ms() - c->since >= CLI_METRICS_PLAIN_WAIT_MS)
+    {
+        met_client_respond(c, false);
+    }
+}
+
+static void met_client_write(met_client_t *c)
+{
+    while (c->out_pos < c->out_len)
+    {
+        ssize_t n = send(c->fd, c->out + c->out_pos, c->out_len - c->out_pos, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            c->out_pos += (size_t)n;
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        else
+        {
+            break;
+        }
+    }
+    met_client_close(c);
+}
+
+/* 后台轮询：接受连接、读请求、发送响应；导出在主循环中进行，仪表读取函数无需加锁 */
+static void met_poll(void)
+{
+    int i;
+
+    if (s_listen.fd < 0)
+    {
+        return;
+    }
+    for (;;)
+    {
+        int fd = accept4(s_listen.fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        met_client_t *c = NULL;
+
+        if (fd < 0)
+        {
+            break;
+        }
+        for (i = 0; i < CLI_METRICS_CLIENTS; i++)
+        {
+            if (s_listen.clients[i].fd < 0)
+            {
+                c = &s_listen.clients[i];
+                break;
+            }
+        }
+        if (c == NULL)
+        {
+            /* 客户端已满，拒绝 */
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->since = cli_get_tick_ms();
+        c->req_len = 0;
+        c->out = NULL;
+    }
+
+    for (i = 0; i < CLI_METRICS_CLIENTS; i++)
+    {
+        met_client_t *c = &s_listen.clients[i];
+
+        if (c->fd >= 0 && c->out == NULL)
+        {
+            met_client_read(c);
+        }
+        if (c->fd >= 0 && c->out != NULL)
+        {
+            met_client_write(c);
+        }
+        /* 迟迟不发完请求或不读取响应的客户端不能一直占用槽位 */
+        if (c->fd >= 0 && cli_get_tick_ms() - c->since >= CLI_METRICS_CLIENT_TIMEOUT_MS)
+        {
+            met_client_close(c);
+        }
+    }
+}
+
+cli_error_t cli_metrics_listen(const char *addr, uint16_t port)
+{
+    struct sockaddr_in sa;
+    int one = 1;
+    int fd;
+    int i;
+
+    cli_metrics_stop();
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    if (inet_pton(AF_INET, (addr != NULL) ? addr : "127.0.0.1", &sa.sin_addr) != 1)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    if (!s_listen.poll_registered)
+    {
+        if (cli_poll_register(met_poll) != CLI_SUCCESS)
+        {
+            return CLI_ERR_TABLE_FULL;
+        }
+        s_listen.poll_registered = true;
+        for (i = 0; i < CLI_METRICS_CLIENTS; i++)
+        {
+            s_listen.clients[i].fd = -1;
+        }
+    }
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return CLI_ERR_IO;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 || listen(fd, 8) != 0)
+    {
+        int e = errno;
+        close(fd);
+        errno = e;
+        return CLI_ERR_IO;
+    }
+    inet_ntop(AF_INET, &sa.sin_addr, s_listen.addr, sizeof(s_listen.addr));
+    s_listen.port = port;
+    s_listen.fd = fd;
+    return CLI_SUCCESS;
+}
+
+void cli_metrics_stop(void)
+{
+    int i;
+
+    if (s_listen.fd < 0)
+    {
+        return;
+    }
+    close(s_listen.fd);
+    s_listen.fd = -1;
+    for (i = 0; i < CLI_METRICS_CLIENTS; i++)
+    {
+        met_client_close(&s_listen.clients[i]);
+    }
+}
+
+#endif /* __linux__ */
+
+static void met_cli_out(const char *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    cli_write(buf, len);
+}
+
+/* metrics 命令 */
+static int met_cmd(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+        cli_metrics_render(met_cli_out, NULL, "\r\n");
+        return 0;
+    }
+#if defined(__linux__)
+    if (strcmp(argv[1], "listen") == 0 && argc <= 4)
+    {
+        uint32_t port;
+        cli_error_t err;
+
+        if (argc == 2)
+        {
+            if (s_listen.fd < 0)
+            {
+                cli_puts("Not listening\r\n");
+            }
+            else
+            {
+                cli_printf("Listening on %s:%u, %u scrapes\r\n",
+                           s_listen.addr, (unsigned int)s_listen.port, (unsigned int)s_listen.scrapes);
+            }
+            return 0;
+        }
+        if (cli_arg_u32(CLI_ARG(argv[2]), 1u, 65535u, &port) != CLI_SUCCESS)
+        {
+            cli_arg_report("port", CLI_ARG(argv[2]));
+            return -1;
+        }
+        err = cli_metrics_listen((argc == 4) ? argv[3] : NULL, (uint16_t)port);
+        if (err != CLI_SUCCESS)
+        {
+            cli_printf("Listen failed: %s\r\n", (err == CLI_ERR_INVALID_PARAM) ? "bad address" :
+                       (err == CLI_ERR_TABLE_FULL) ? "poll table full" : strerror(errno));
+            return -1;
+        }
+        cli_printf("Listening on %s:%u\r\n", s_listen.addr, (unsigned int)port);
+        return 0;
+    }
+    if (strcmp(argv[1], "stop") == 0 && argc == 2)
+    {
+        cli_metrics_stop();
+        return 0;
+    }
+    cli_puts("Usage: metrics [listen [port [addr]]|stop]\r\n");
+#else
+    (void)argv;
+    cli_puts("Usage: metrics\r\n");
+#endif
+    return -1;
+}
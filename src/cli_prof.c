@@ -0,0 +1,537 @@
+/*
+ * @file cli_prof.c
+ * @brief 进程内采样分析器实现（仅 Linux）
+ *
+ * 定时器使用 CLOCK_PROCESS_CPUTIME_ID，信号可能投递到任意线程，因此环形
+ * 缓冲区按多生产者设计：每个槽位带序号，生产者用 CAS 占位，满时直接丢弃
+ * 并计数，信号处理函数中不加锁、不分配内存。唯一的消费者是后台轮询。
+ */
+
+#define _GNU_SOURCE
+#include <cli_prof.h>
+
+#if defined(__linux__)
+
+#include <cli_table.h>
+#include <cli_arg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#define PROF_RING_MASK          (CLI_PROF_RING_SIZE - 1)
+#define PROF_TABLE_MASK         (CLI_PROF_TABLE_SIZE - 1)
+
+/* 默认频率取质数附近的值，避免与毫秒周期任务同步 */
+#define PROF_DEFAULT_HZ         999
+#define PROF_MAX_HZ             10000
+
+/* prof top 默认行数 */
+#define PROF_TOP_DEFAULT        20
+
+/* 环形缓冲区槽位：seq == 位置+1 表示已写入，== 位置+环长表示可再次写入 */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t depth;                             /* 有效调用者层数 */
+    uintptr_t pc;
+    uintptr_t stack[CLI_PROF_STACK_DEPTH];
+} prof_slot_t;
+
+/* 计数表项 */
+typedef struct
+{
+    uintptr_t pc;               /* 0表示空 */
+    uintptr_t func;             /* 所属函数起始地址，无符号信息时为 pc */
+    uint32_t self;              /* 位于栈顶的样本数 */
+    uint32_t total;             /* 所属函数首次出现在该地址的样本数 */
+} prof_entry_t;
+
+/* prof top 的输出行：按函数合并后的结果 */
+typedef struct
+{
+    uintptr_t key;              /* 函数起始地址，无符号信息时为 PC */
+    uintptr_t base;             /* 模块加载地址 */
+    const char *name;
+    const char *module;
+    uint32_t self;
+    uint32_t total;
+} prof_row_t;
+
+static struct
+{
+    prof_slot_t slot[CLI_PROF_RING_SIZE];
+    uint32_t head;              /* 生产者位置 */
+    uint32_t tail;              /* 消费者位置 */
+} s_ring;
+
+static struct
+{
+    timer_t timer;
+    bool running;
+    bool stacks;
+    uint32_t hz;
+    uint32_t samples;
+    uint32_t dropped;           /* 信号处理函数中原子递增 */
+    uint32_t overflow;
+} s_prof;
+
+static prof_entry_t s_table[CLI_PROF_TABLE_SIZE];
+static prof_row_t s_rows[CLI_PROF_TABLE_SIZE];
+
+static int cmd_prof(int argc, char **argv);
+
+const cli_command_t cli_prof_cmd = {
+    .name = "prof",
+    .short_name = NULL,
+    .help = CLI_HELP("Sampling profiler: prof start [hz] [-g]|stop|top [n]"),
+    .handler = cmd_prof
+};
+
+/* 被打断处的 PC */
+static uintptr_t prof_context_pc(const ucontext_t *uc)
+{
+#if defined(__x86_64__)
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+    return (uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+    return (uintptr_t)uc->uc_mcontext.pc;
+#elif defined(__arm__)
+    return (uintptr_t)uc->uc_mcontext.arm_pc;
+#else
+    (void)uc;
+    return 0;
+#endif
+}
+
+/* SIGPROF 处理函数：占一个槽位并写入样本 */
+static void prof_signal(int sig, siginfo_t *info, void *context)
+{
+    int saved_errno = errno;
+    uint32_t pos = __atomic_load_n(&s_ring.head, __ATOMIC_RELAXED);
+    prof_slot_t *slot;
+
+    (void)sig;
+    (void)info;
+    for (;;)
+    {
+        int32_t diff;
+        slot = &s_ring.slot[pos & PROF_RING_MASK];
+        diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&s_ring.head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* 消费者落后一整圈 */
+            __atomic_fetch_add(&s_prof.dropped, 1, __ATOMIC_RELAXED);
+            errno = saved_errno;
+            return;
+        }
+        else
+        {
+            pos = __atomic_load_n(&s_ring.head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->pc = prof_context_pc((const ucontext_t *)context);
+    slot->depth = 0;
+    if (s_prof.stacks)
+    {
+        /* 栈中依次为处理函数、信号返回帧、被打断的函数，其后才是调用者 */
+        void *frames[CLI_PROF_STACK_DEPTH + 4];
+        int n = backtrace(frames, CLI_PROF_STACK_DEPTH + 4);
+        int i = 0;
+        while (i < n && i < 4 && (uintptr_t)frames[i] != slot->pc)
+        {
+            i++;
+        }
+        i = (i < n && i < 4) ? i + 1 : 2;
+        for (; i < n && slot->depth < CLI_PROF_STACK_DEPTH; i++)
+        {
+            /* 返回地址减1，落在调用指令所在的函数内 */
+            slot->stack[slot->depth++] = (uintptr_t)frames[i] - 1;
+        }
+    }
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    errno = saved_errno;
+}
+
+/* 计数表查找或插入，表满返回 NULL */
+static prof_entry_t *prof_entry(uintptr_t pc)
+{
+    uint32_t h = (uint32_t)((pc * 0x9E3779B97F4A7C15ull) >> 40);
+
+    for (uint32_t i = 0; i < CLI_PROF_TABLE_SIZE; i++)
+    {
+        prof_entry_t *e = &s_table[(h + i) & PROF_TABLE_MASK];
+        if (e->pc == pc)
+        {
+            return e;
+        }
+        if (e->pc == 0)
+        {
+            Dl_info info;
+            e->pc = pc;
+            e->func = pc;
+            /* 与 prof_collect 的合并条件一致，每个地址只查一次 */
+            if (dladdr((void *)pc, &info) != 0 && info.dli_sname != NULL && info.dli_saddr != NULL)
+            {
+                e->func = (uintptr_t)info.dli_saddr;
+            }
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * 汇总一个样本：栈顶计入 self；total 按函数去重，同一函数在栈中出现多次
+ * （递归或多个调用点）时只计入它第一次出现的地址，按函数合并后即为
+ * 该函数出现在栈中的样本数
+ */
+static void prof_account(const prof_slot_t *slot)
+{
+    uintptr_t seen[CLI_PROF_STACK_DEPTH + 1];
+    uint32_t nseen = 0;
+    prof_entry_t *e = prof_entry(slot->pc);
+
+    s_prof.samples++;
+    if (e == NULL)
+    {
+        s_prof.overflow++;
+        return;
+    }
+    e->self++;
+    e->total++;
+    seen[nseen++] = e->func;
+    for (uint32_t i = 0; i < slot->depth; i++)
+    {
+        bool dup = false;
+        if ((e = prof_entry(slot->stack[i])) == NULL)
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < nseen && !dup; j++)
+        {
+            dup = (seen[j] == e->func);
+        }
+        if (!dup)
+        {
+            e->total++;
+            seen[nseen++] = e->func;
+        }
+    }
+}
+
+/* 后台轮询：取出环形缓冲区中已写入的样本 */
+static void prof_poll(void)
+{
+    for (;;)
+    {
+        prof_slot_t *slot = &s_ring.slot[s_ring.tail & PROF_RING_MASK];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != s_ring.tail + 1)
+        {
+            break;
+        }
+        prof_account(slot);
+        __atomic_store_n(&slot->seq, s_ring.tail + CLI_PROF_RING_SIZE, __ATOMIC_RELEASE);
+        s_ring.tail++;
+    }
+}
+
+void cli_prof_init(void)
+{
+    struct sigaction sa;
+
+    memset(&s_prof, 0, sizeof(s_prof));
+    for (uint32_t i = 0; i < CLI_PROF_RING_SIZE; i++)
+    {
+        s_ring.slot[i].seq = i;
+    }
+    s_ring.head = 0;
+    s_ring.tail = 0;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = prof_signal;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+
+    cli_poll_register(prof_poll);
+}
+
+cli_error_t cli_prof_start(uint32_t hz, bool stacks)
+{
+    struct sigevent sev;
+    struct itimerspec its;
+    void *warmup[1];
+
+    if (hz == 0 || hz > PROF_MAX_HZ)
+    {
+        return CLI_ERR_RANGE;
+    }
+    cli_prof_stop();
+    prof_poll();
+    memset(s_table, 0, sizeof(s_table));
+    s_prof.samples = 0;
+    s_prof.overflow = 0;
+    __atomic_store_n(&s_prof.dropped, 0, __ATOMIC_RELAXED);
+    s_prof.stacks = stacks;
+    if (stacks)
+    {
+        /* 首次调用 backtrace 会加载 libgcc，不能发生在信号处理函数中 */
+        backtrace(warmup, 1);
+    }
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = SIGPROF;
+    if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &sev, &s_prof.timer) != 0)
+    {
+        return CLI_ERR_IO;
+    }
+    its.it_interval.tv_sec = (time_t)(1u / hz);
+    its.it_interval.tv_nsec = (long)((hz > 1) ? 1000000000u / hz : 0);
+    its.it_value = its.it_interval;
+    if (timer_settime(s_prof.timer, 0, &its, NULL) != 0)
+    {
+        timer_delete(s_prof.timer);
+        return CLI_ERR_IO;
+    }
+    s_prof.hz = hz;
+    s_prof.running = true;
+    return CLI_SUCCESS;
+}
+
+void cli_prof_stop(void)
+{
+    if (s_prof.running)
+    {
+        timer_delete(s_prof.timer);
+        s_prof.running = false;
+        prof_poll();
+    }
+}
+
+void cli_prof_get_stats(cli_prof_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        stats->hz = s_prof.running ? s_prof.hz : 0;
+        stats->samples = s_prof.samples;
+        stats->dropped = __atomic_load_n(&s_prof.dropped, __ATOMIC_RELAXED);
+        stats->overflow = s_prof.overflow;
+    }
+}
+
+static int prof_cmp_key(const void *a, const void *b)
+{
+    const prof_row_t *x = (const prof_row_t *)a;
+    const prof_row_t *y = (const prof_row_t *)b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+static int prof_cmp_count(const void *a, const void *b)
+{
+    const prof_row_t *x = (const prof_row_t *)a;
+    const prof_row_t *y = (const prof_row_t *)b;
+    if (x->self != y->self)
+    {
+        return (x->self < y->self) ? 1 : -1;
+    }
+    return (x->total < y->total) - (x->total > y->total);
+}
+
+/* 符号化并按函数合并，返回行数 */
+static size_t prof_collect(void)
+{
+    size_t count = 0;
+    size_t merged = 0;
+
+    for (uint32_t i = 0; i < CLI_PROF_TABLE_SIZE; i++)
+    {
+        const prof_entry_t *e = &s_table[i];
+        prof_row_t *r = &s_rows[count];
+        Dl_info info;
+
+        if (e->pc == 0)
+        {
+            continue;
+        }
+        memset(r, 0, sizeof(*r));
+        r->key = e->pc;
+        r->self = e->self;
+        r->total = e->total;
+        if (dladdr((void *)e->pc, &info) != 0)
+        {
+            r->base = (uintptr_t)info.dli_fbase;
+            r->module = info.dli_fname;
+            if (info.dli_sname != NULL && info.dli_saddr != NULL)
+            {
+                r->key = (uintptr_t)info.dli_saddr;
+                r->name = info.dli_sname;
+            }
+        }
+        count++;
+    }
+
+    qsort(s_rows, count, sizeof(s_rows[0]), prof_cmp_key);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (merged > 0 && s_rows[i].name != NULL && s_rows[merged - 1].key == s_rows[i].key)
+        {
+            s_rows[merged - 1].self += s_rows[i].self;
+            s_rows[merged - 1].total += s_rows[i].total;
+        }
+        else
+        {
+            s_rows[merged++] = s_rows[i];
+        }
+    }
+    qsort(s_rows, merged, sizeof(s_rows[0]), prof_cmp_count);
+    return merged;
+}
+
+/* prof top */
+static void prof_top(uint32_t limit)
+{
+    static const cli_table_col_t cols[] = {
+        { "self",   CLI_COL_UINT,  6, CLI_COL_RIGHT, 0 },
+        { "self%",  CLI_COL_FLOAT, 6, CLI_COL_RIGHT, 1 },
+        { "total%", CLI_COL_FLOAT, 6, CLI_COL_RIGHT, 1 },
+        { "symbol", CLI_COL_STR,   24, 0, 0 },
+        { "module", CLI_COL_STR,   0, 0, 0 },
+    };
+    /* 未附带调用栈时 total 与 self 相同，不显示该列 */
+    static const cli_table_col_t cols_flat[] = {
+        { "self",   CLI_COL_UINT,  6, CLI_COL_RIGHT, 0 },
+        { "self%",  CLI_COL_FLOAT, 6, CLI_COL_RIGHT, 1 },
+        { "symbol", CLI_COL_STR,   24, 0, 0 },
+        { "module", CLI_COL_STR,   0, 0, 0 },
+    };
+    double scale = (s_prof.samples > 0) ? 100.0 / (double)s_prof.samples : 0.0;
+    size_t count = prof_collect();
+    cli_table_t table;
+
+    if (s_prof.stacks)
+    {
+        cli_table_begin(&table, cols, 5);
+    }
+    else
+    {
+        cli_table_begin(&table, cols_flat, 4);
+    }
+    for (size_t i = 0; i < count && i < limit; i++)
+    {
+        const prof_row_t *r = &s_rows[i];
+        const char *module = "?";
+        const char *name = r->name;
+        char addr[24];
+
+        if (r->module != NULL)
+        {
+            const char *slash = strrchr(r->module, '/');
+            module = (slash != NULL) ? slash + 1 : r->module;
+        }
+        if (name == NULL)
+        {
+            /* 无符号信息：显示模块内偏移，可交给 addr2line */
+            snprintf(addr, sizeof(addr), "+0x%lx", (unsigned long)(r->key - r->base));
+            name = addr;
+        }
+        if (s_prof.stacks)
+        {
+            cli_table_row(&table, (unsigned int)r->self, (double)r->self * scale,
+                          (double)r->total * scale, name, module);
+        }
+        else
+        {
+            cli_table_row(&table, (unsigned int)r->self, (double)r->self * scale, name, module);
+        }
+    }
+    cli_table_end(&table);
+}
+
+/* prof 命令 */
+static int cmd_prof(int argc, char **argv)
+{
+    const char *sub = (argc > 1) ? argv[1] : "";
+
+    if (argc == 1)
+    {
+        cli_prof_stats_t st;
+        cli_prof_get_stats(&st);
+        if (st.hz != 0)
+        {
+            cli_printf("Running at %u Hz, ", (unsigned int)st.hz);
+        }
+        else
+        {
+            cli_puts("Stopped, ");
+        }
+        cli_printf("%u samples, %u dropped, %u overflow\r\n",
+                   (unsigned int)st.samples, (unsigned int)st.dropped, (unsigned int)st.overflow);
+        return 0;
+    }
+
+    if (strcmp(sub, "start") == 0)
+    {
+        uint32_t hz = PROF_DEFAULT_HZ;
+        bool stacks = false;
+        cli_error_t err;
+
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "-g") == 0)
+            {
+                stacks = true;
+            }
+            else if (cli_arg_u32(CLI_ARG(argv[i]), 1, PROF_MAX_HZ, &hz) != CLI_SUCCESS)
+            {
+                cli_arg_report("hz", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        err = cli_prof_start(hz, stacks);
+        if (err != CLI_SUCCESS)
+        {
+            cli_puts("Cannot start profiling timer\r\n");
+            return -1;
+        }
+        return 0;
+    }
+    if (strcmp(sub, "stop") == 0)
+    {
+        cli_prof_stop();
+        return 0;
+    }
+    if (strcmp(sub, "top") == 0)
+    {
+        uint32_t limit = PROF_TOP_DEFAULT;
+        if (argc > 2 && cli_arg_u32(CLI_ARG(argv[2]), 1, CLI_PROF_TABLE_SIZE, &limit) != CLI_SUCCESS)
+        {
+            cli_arg_report("n", CLI_ARG(argv[2]));
+            return -1;
+        }
+        prof_poll();
+        prof_top(limit);
+        return 0;
+    }
+
+    cli_puts("Usage: prof start [hz] [-g]|stop|top [n]\r\n");
+    return -1;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,286 @@
+/*
+ * @file cli_stream.c
+ * @brief 遥测流模块实现
+ *
+ * 采样对象为 cli_var 注册表中的变量，由时间轮定时器（cli_timer.h）驱动，命令本身立即返回，不阻塞输入。
+ * 采样时刻按 start + n * 1000 / hz 计算，每次按下一个采样点的绝对时刻重新启动
+ * 定时器，不累积舍入误差；当输出阻塞导致错过采样点时，直接跳到当前时刻并将
+ * 错过的点计入 dropped。
+ */
+
+#include <cli_stream.h>
+#include <cli_var.h>
+#include <cli_arg.h>
+#include <cli_timer.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* 单帧最大长度：同步头(2) + seq + len + 负载 + 校验 */
+#define STREAM_FRAME_MAX    (5 + CLI_STREAM_MAX_SELECT * 4)
+
+/* CSV 单行最大长度 */
+#define STREAM_LINE_MAX     ((CLI_STREAM_MAX_SELECT + 1) * (CLI_VAR_TEXT_MAX + 1) + 2)
+
+/* 当前流状态 */
+static struct
+{
+    bool active;
+    bool csv;                                   /* true: CSV, false: 二进制帧 */
+    uint8_t seq;                                /* 帧序号 */
+    const cli_var_t *select[CLI_STREAM_MAX_SELECT]; /* 选中的变量 */
+    int select_count;
+    uint32_t hz;
+    uint32_t start_ms;                          /* 启动时刻 */
+    uint64_t index;                             /* 下一个采样点序号 */
+    uint32_t limit;                             /* 样本数上限，0表示不限 */
+    cli_stream_stats_t stats;
+} s_stream;
+
+/* 采样定时器（不随 s_stream 清零） */
+static cli_timer_t s_stream_timer;
+
+static int cmd_stream(int argc, char **argv);
+
+const cli_command_t cli_stream_cmd = {
+    .name = "stream",
+    .short_name = NULL,
+    .help = CLI_HELP("Stream variables: stream <var...> [-r hz] [-c] [-n count]"),
+    .handler = cmd_stream
+};
+
+void cli_stream_get_stats(cli_stream_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = s_stream.stats;
+    }
+}
+
+/* 无符号十进制格式化，返回写入长度 */
+static size_t stream_fmt_u32(char *out, uint32_t val)
+{
+    char buf[10];
+    size_t i = 0;
+    size_t n = 0;
+    do {
+        buf[i++] = (char)('0' + val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0)
+    {
+        out[n++] = buf[--i];
+    }
+    return n;
+}
+
+/* 采样所有选中变量并输出一帧/一行 */
+static void stream_emit(uint32_t now)
+{
+    if (s_stream.csv)
+    {
+        char line[STREAM_LINE_MAX];
+        size_t n = stream_fmt_u32(line, now - s_stream.start_ms);
+        for (int i = 0; i < s_stream.select_count; i++)
+        {
+            const cli_var_t *var = s_stream.select[i];
+            line[n++] = ',';
+            n += cli_var_format(var, cli_var_load(var), line + n, CLI_VAR_TEXT_MAX);
+        }
+        line[n++] = '\r';
+        line[n++] = '\n';
+        cli_write(line, n);
+    }
+    else
+    {
+        uint8_t frame[STREAM_FRAME_MAX];
+        size_t n = 4;
+        uint8_t sum = 0;
+        for (int i = 0; i < s_stream.select_count; i++)
+        {
+            const cli_var_t *var = s_stream.select[i];
+            uint32_t raw = cli_var_load(var).u;
+            size_t w = cli_var_type_size(var->type);
+            for (size_t b = 0; b < w; b++)
+            {
+                frame[n++] = (uint8_t)(raw >> (8 * b));
+            }
+        }
+        frame[0] = CLI_STREAM_SYNC0;
+        frame[1] = CLI_STREAM_SYNC1;
+        frame[2] = s_stream.seq++;
+        frame[3] = (uint8_t)(n - 4);
+        for (size_t i = 2; i < n; i++)
+        {
+            sum = (uint8_t)(sum + frame[i]);
+        }
+        frame[n++] = sum;
+        cli_write((const char *)frame, n);
+    }
+    s_stream.stats.samples++;
+}
+
+/* 结束流并输出统计 */
+static void stream_stop(void)
+{
+    s_stream.active = false;
+    cli_timer_cancel(&s_stream_timer);
+    if (!s_stream.csv)
+    {
+        cli_set_binary(0);
+    }
+    cli_printf("\r\nstream stopped: %u samples, %u dropped\r\n",
+               (unsigned int)s_stream.stats.samples,
+               (unsigned int)s_stream.stats.dropped);
+    cli_input_release();
+}
+
+/* 流期间的输入：任意按键结束 */
+static void stream_input(char c)
+{
+    (void)c;
+    if (s_stream.active)
+    {
+        stream_stop();
+    }
+}
+
+/* 按下一个采样点序号启动定时器：第 index 点的时刻为 start + ceil(index * 1000 / hz) */
+static void stream_arm(void)
+{
+    uint64_t ms = (s_stream.index * 1000u + s_stream.hz - 1u) / s_stream.hz;
+    cli_timer_start_at(&s_stream_timer, s_stream.start_ms + (uint32_t)ms);
+}
+
+/* 定时器到期：采样并安排下一个采样点 */
+static void stream_tick(void *ctx)
+{
+    uint32_t now;
+    uint32_t elapsed;
+    uint64_t due_index;
+
+    (void)ctx;
+    if (!s_stream.active)
+    {
+        return;
+    }
+
+    now = cli_get_tick_ms();
+    elapsed = now - s_stream.start_ms;
+    /* 当前时刻应到达的采样点序号 */
+    due_index = (uint64_t)elapsed * s_stream.hz / 1000u;
+    if (due_index < s_stream.index)
+    {
+        stream_arm();
+        return;
+    }
+
+    /* 错过的采样点计为丢弃，只输出最新一个 */
+    if (due_index > s_stream.index)
+    {
+        s_stream.stats.dropped += (uint32_t)(due_index - s_stream.index);
+    }
+    s_stream.index = due_index + 1;
+
+    stream_emit(now);
+
+    if (s_stream.limit != 0 && s_stream.stats.samples >= s_stream.limit)
+    {
+        stream_stop();
+        return;
+    }
+    stream_arm();
+}
+
+void cli_stream_init(void)
+{
+    memset(&s_stream, 0, sizeof(s_stream));
+    cli_timer_init(&s_stream_timer, stream_tick, NULL);
+}
+
+/* stream 命令 */
+static int cmd_stream(int argc, char **argv)
+{
+    uint32_t hz = 10;
+    uint32_t limit = 0;
+    bool csv = false;
+    int count = 0;
+    const cli_var_t *select[CLI_STREAM_MAX_SELECT];
+
+    if (argc < 2)
+    {
+        cli_puts("Usage: stream <var...> [-r hz] [-c] [-n count]\r\n");
+        return -1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (cli_arg_u32(CLI_ARG(argv[i]), 1, CLI_STREAM_MAX_HZ, &hz) != CLI_SUCCESS)
+            {
+                cli_arg_report("rate", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (cli_arg_u32(CLI_ARG(argv[i]), 0, UINT32_MAX, &limit) != CLI_SUCCESS)
+            {
+                cli_arg_report("count", CLI_ARG(argv[i]));
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            csv = true;
+        }
+        else
+        {
+            const cli_var_t *var = cli_var_find(argv[i]);
+            if (var == NULL)
+            {
+                cli_printf("Unknown variable: %s\r\n", argv[i]);
+                return -1;
+            }
+            if (count >= CLI_STREAM_MAX_SELECT)
+            {
+                cli_puts("Too many variables\r\n");
+                return -1;
+            }
+            select[count++] = var;
+        }
+    }
+
+    if (count == 0 || hz == 0 || hz > CLI_STREAM_MAX_HZ)
+    {
+        cli_printf("Invalid arguments (rate 1..%u Hz)\r\n", (unsigned int)CLI_STREAM_MAX_HZ);
+        return -1;
+    }
+    /* 采样由定时器驱动，没有时钟时定时器不会到期 */
+    if (!cli_has_clock())
+    {
+        cli_puts("No clock for sampling\r\n");
+        return -1;
+    }
+
+    memset(&s_stream, 0, sizeof(s_stream));
+    memcpy(s_stream.select, select, sizeof(select[0]) * (size_t)count);
+    s_stream.select_count = count;
+    s_stream.hz = hz;
+    s_stream.csv = csv;
+    s_stream.limit = limit;
+    s_stream.start_ms = cli_get_tick_ms();
+    s_stream.active = true;
+
+    /* 二进制帧需要透明传输 */
+    if (!csv)
+    {
+        cli_set_binary(1);
+    }
+    /* 接管输入，任意按键结束；定时器负责采样 */
+    cli_input_acquire(stream_input);
+    stream_arm();
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * @file cli_style.c
+ * @brief 终端样式（SGR）实现
+ */
+
+#include <cli_style.h>
+
+#if CLI_STYLE_ENABLE
+
+/* 一次切换最多的 SGR 参数个数：复位 + 5个属性 + 前景 + 背景 */
+#define STYLE_MAX_CODES         8
+
+/* 参数列表 */
+typedef struct
+{
+    uint8_t code[STYLE_MAX_CODES];
+    int count;
+} style_codes_t;
+
+static struct
+{
+    cli_style_t cur;            /* 终端当前状态 */
+    cli_style_t want;           /* 期望状态 */
+    bool pending;               /* 已登记延迟输出 */
+    bool enabled;
+} s_style = { { 0, 0, 0 }, { 0, 0, 0 }, false, true };
+
+static bool style_equal(cli_style_t a, cli_style_t b)
+{
+    return a.attr == b.attr && a.fg == b.fg && a.bg == b.bg;
+}
+
+/* 颜色参数：base 为标准色起始码（30/40），默认色为 base + 9，高亮色为 base + 60 */
+static uint8_t style_color_code(uint8_t color, uint8_t base)
+{
+    if (color == CLI_COLOR_DEFAULT || color > CLI_COLOR_BRIGHT_WHITE)
+    {
+        return (uint8_t)(base + 9);
+    }
+    if (color >= CLI_COLOR_BRIGHT_BLACK)
+    {
+        return (uint8_t)(base + 60 + color - CLI_COLOR_BRIGHT_BLACK);
+    }
+    return (uint8_t)(base + color - CLI_COLOR_BLACK);
+}
+
+static void style_add(style_codes_t *c, uint8_t code)
+{
+    c->code[c->count++] = code;
+}
+
+/* 开启属性 */
+static void style_add_on(style_codes_t *c, uint8_t on)
+{
+    static const uint8_t codes[] = { 1, 2, 3, 4, 7 };
+    for (int i = 0; i < 5; i++)
+    {
+        if (on & (1u << i))
+        {
+            style_add(c, codes[i]);
+        }
+    }
+}
+
+/* 差异编码：从 cur 变到 want */
+static void style_diff(style_codes_t *c, cli_style_t cur, cli_style_t want)
+{
+    uint8_t off = (uint8_t)(cur.attr & ~want.attr);
+    uint8_t on = (uint8_t)(want.attr & ~cur.attr);
+
+    c->count = 0;
+    if (off & (CLI_ATTR_BOLD | CLI_ATTR_DIM))
+    {
+        /* 22 同时关闭粗体和暗色，仍需保留的一个要重新打开 */
+        style_add(c, 22);
+        on |= (uint8_t)(want.attr & (CLI_ATTR_BOLD | CLI_ATTR_DIM));
+    }
+    if (off & CLI_ATTR_ITALIC)
+    {
+        style_add(c, 23);
+    }
+    if (off & CLI_ATTR_UNDERLINE)
+    {
+        style_add(c, 24);
+    }
+    if (off & CLI_ATTR_REVERSE)
+    {
+        style_add(c, 27);
+    }
+    style_add_on(c, on);
+    if (cur.fg != want.fg)
+    {
+        style_add(c, style_color_code(want.fg, 30));
+    }
+    if (cur.bg != want.bg)
+    {
+        style_add(c, style_color_code(want.bg, 40));
+    }
+}
+
+/* 复位编码：先复位再设置 want 中的非默认项 */
+static void style_reset(style_codes_t *c, cli_style_t want)
+{
+    c->count = 0;
+    style_add(c, 0);
+    style_add_on(c, want.attr);
+    if (want.fg != CLI_COLOR_DEFAULT)
+    {
+        style_add(c, style_color_code(want.fg, 30));
+    }
+    if (want.bg != CLI_COLOR_DEFAULT)
+    {
+        style_add(c, style_color_code(want.bg, 40));
+    }
+}
+
+/* 序列化为 ESC [ p1;p2... m，单独的复位写作 ESC [ m */
+static size_t style_encode(char *out, const style_codes_t *c)
+{
+    size_t n = 0;
+
+    out[n++] = '\033';
+    out[n++] = '[';
+    for (int i = 0; i < c->count; i++)
+    {
+        uint8_t v = c->code[i];
+        if (i > 0)
+        {
+            out[n++] = ';';
+        }
+        else if (v == 0 && c->count == 1)
+        {
+            break;
+        }
+        if (v >= 100)
+        {
+            out[n++] = (char)('0' + v / 100);
+        }
+        if (v >= 10)
+        {
+            out[n++] = (char)('0' + (v / 10) % 10);
+        }
+        out[n++] = (char)('0' + v % 10);
+    }
+    out[n++] = 'm';
+    return n;
+}
+
+/* 延迟回调：输出文字前生成最短的切换序列 */
+static void style_flush(void)
+{
+    style_codes_t diff;
+    style_codes_t reset;
+    char a[STYLE_MAX_CODES * 4 + 3];
+    char b[STYLE_MAX_CODES * 4 + 3];
+    size_t na;
+    size_t nb;
+
+    s_style.pending = false;
+    if (!s_style.enabled || cli_get_output_mode() != CLI_MODE_TEXT ||
+        cli_get_automation() || style_equal(s_style.cur, s_style.want))
+    {
+        return;
+    }
+    style_diff(&diff, s_style.cur, s_style.want);
+    style_reset(&reset, s_style.want);
+    na = style_encode(a, &diff);
+    nb = style_encode(b, &reset);
+    if (na <= nb)
+    {
+        cli_write(a, na);
+    }
+    else
+    {
+        cli_write(b, nb);
+    }
+    s_style.cur = s_style.want;
+}
+
+void cli_style(cli_style_t style)
+{
+    s_style.want = style;
+    if (!s_style.pending)
+    {
+        s_style.pending = true;
+        cli_defer_output(style_flush);
+    }
+}
+
+void cli_style_enable(bool enable)
+{
+    bool restore = !enable && s_style.enabled && !style_equal(s_style.cur, CLI_STYLE_NORMAL);
+
+    s_style.enabled = enable;
+    if (!enable)
+    {
+        if (restore)
+        {
+            cli_write("\033[m", 3);
+        }
+        s_style.cur = CLI_STYLE_NORMAL;
+    }
+}
+
+void cli_style_forget(void)
+{
+    s_style.cur = CLI_STYLE_NORMAL;
+    s_style.want = CLI_STYLE_NORMAL;
+}
+
+#endif /* CLI_STYLE_ENABLE */
@@ -0,0 +1,382 @@
+/*
+ * @file cli_table.c
+ * @brief 流式表格输出实现
+ *
+ * 每行先格式化到栈上的行缓冲区，行结束时用一次 cli_write 写出；
+ * 行长超过 CLI_TABLE_LINE_MAX 时提前写出已满部分。
+ */
+
+#include <cli_table.h>
+#include <cli_fmt.h>
+#include <cli_arg.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* 行缓冲区 */
+typedef struct
+{
+    char buf[CLI_TABLE_LINE_MAX];
+    size_t n;
+} tbl_line_t;
+
+static int cmd_format(int argc, char **argv);
+
+const cli_command_t cli_table_format_cmd = {
+    .name = "format",
+    .short_name = NULL,
+    .help = CLI_HELP("Output mode for tables: format [text|csv|json]"),
+    .handler = cmd_format
+};
+
+static const char *const s_mode_names[] = { "text", "csv", "json" };
+
+static void tbl_put(tbl_line_t *l, const char *s, size_t len)
+{
+    while (len > 0)
+    {
+        size_t room = sizeof(l->buf) - l->n;
+        size_t k = (len < room) ? len : room;
+        memcpy(l->buf + l->n, s, k);
+        l->n += k;
+        s += k;
+        len -= k;
+        if (l->n == sizeof(l->buf))
+        {
+            cli_write(l->buf, l->n);
+            l->n = 0;
+        }
+    }
+}
+
+static void tbl_putc(tbl_line_t *l, char c)
+{
+    tbl_put(l, &c, 1);
+}
+
+static void tbl_pad(tbl_line_t *l, size_t count)
+{
+    static const char spaces[] = "                ";
+    while (count > 0)
+    {
+        size_t k = (count < sizeof(spaces) - 1) ? count : sizeof(spaces) - 1;
+        tbl_put(l, spaces, k);
+        count -= k;
+    }
+}
+
+/* 行结束：一次写出 */
+static void tbl_end_line(tbl_line_t *l)
+{
+    tbl_put(l, "\r\n", 2);
+    if (l->n > 0)
+    {
+        cli_write(l->buf, l->n);
+        l->n = 0;
+    }
+}
+
+/* 64位无符号数转十进制，返回长度 */
+static size_t tbl_fmt_u64(char *out, uint64_t v)
+{
+    char tmp[20];
+    size_t i = 0;
+    size_t n = 0;
+    do {
+        tmp[i++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v > 0);
+    while (i > 0)
+    {
+        out[n++] = tmp[--i];
+    }
+    return n;
+}
+
+/* 十六进制，至少 digits 位 */
+static size_t tbl_fmt_hex(char *out, uint64_t v, int digits)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t n = 0;
+    int count = 1;
+
+    while (count < 16 && (v >> (count * 4)) != 0)
+    {
+        count++;
+    }
+    if (digits > 16)
+    {
+        digits = 16;
+    }
+    if (count < digits)
+    {
+        count = digits;
+    }
+    out[n++] = '0';
+    out[n++] = 'x';
+    while (count > 0)
+    {
+        count--;
+        out[n++] = hex[(v >> (count * 4)) & 0x0F];
+    }
+    return n;
+}
+
+/* CSV 字段：含逗号、引号或换行时加引号，内部引号加倍 */
+static void tbl_put_csv(tbl_line_t *l, const char *s, size_t len)
+{
+    size_t start = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (s[i] == ',' || s[i] == '"' || s[i] == '\r' || s[i] == '\n')
+        {
+            break;
+        }
+    }
+    if (i == len)
+    {
+        tbl_put(l, s, len);
+        return;
+    }
+    tbl_putc(l, '"');
+    for (i = 0; i < len; i++)
+    {
+        if (s[i] == '"')
+        {
+            tbl_put(l, s + start, i + 1 - start);
+            start = i;
+        }
+    }
+    tbl_put(l, s + start, len - start);
+    tbl_putc(l, '"');
+}
+
+/* JSON 字符串（含引号），控制字符转为 \u00XX */
+static void tbl_put_json_str(tbl_line_t *l, const char *s, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0;
+
+    tbl_putc(l, '"');
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        tbl_put(l, s + start, i - start);
+        start = i + 1;
+        if (c == '"' || c == '\\')
+        {
+            char esc[2] = { '\\', (char)c };
+            tbl_put(l, esc, 2);
+        }
+        else
+        {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+            tbl_put(l, esc, 6);
+        }
+    }
+    tbl_put(l, s + start, len - start);
+    tbl_putc(l, '"');
+}
+
+/* 文本模式单元格：按列宽对齐，最后一列左对齐时不补尾部空格 */
+static void tbl_put_cell(cli_table_t *t, tbl_line_t *l, int col, const char *s, size_t len)
+{
+    size_t width;
+
+    if (len > t->width[col])
+    {
+        t->width[col] = (uint8_t)((len > 255) ? 255 : len);
+    }
+    width = t->width[col];
+    if (col > 0)
+    {
+        tbl_put(l, "  ", 2);
+    }
+    if (t->cols[col].flags & CLI_COL_RIGHT)
+    {
+        tbl_pad(l, width - ((len < width) ? len : width));
+        tbl_put(l, s, len);
+    }
+    else
+    {
+        tbl_put(l, s, len);
+        if (col + 1 < t->ncols && len < width)
+        {
+            tbl_pad(l, width - len);
+        }
+    }
+}
+
+void cli_table_begin(cli_table_t *t, const cli_table_col_t *cols, int ncols)
+{
+    tbl_line_t line;
+
+    if (ncols > CLI_TABLE_MAX_COLS)
+    {
+        ncols = CLI_TABLE_MAX_COLS;
+    }
+    t->cols = cols;
+    t->ncols = (uint8_t)ncols;
+    t->mode = (uint8_t)cli_get_output_mode();
+    t->rows = 0;
+    line.n = 0;
+
+    for (int i = 0; i < ncols; i++)
+    {
+        size_t len = strlen(cols[i].name);
+        t->width[i] = (uint8_t)((cols[i].width > len) ? cols[i].width : ((len > 255) ? 255 : len));
+    }
+    if (t->mode == CLI_MODE_JSON)
+    {
+        return;
+    }
+    for (int i = 0; i < ncols; i++)
+    {
+        if (t->mode == CLI_MODE_CSV)
+        {
+            if (i > 0)
+            {
+                tbl_putc(&line, ',');
+            }
+            tbl_put_csv(&line, cols[i].name, strlen(cols[i].name));
+        }
+        else
+        {
+            tbl_put_cell(t, &line, i, cols[i].name, strlen(cols[i].name));
+        }
+    }
+    tbl_end_line(&line);
+}
+
+void cli_table_row(cli_table_t *t, ...)
+{
+    tbl_line_t line;
+    va_list args;
+
+    line.n = 0;
+    va_start(args, t);
+    if (t->mode == CLI_MODE_JSON)
+    {
+        tbl_putc(&line, '{');
+    }
+    for (int i = 0; i < t->ncols; i++)
+    {
+        const cli_table_col_t *col = &t->cols[i];
+        char cell[CLI_FMT_DOUBLE_MAX];
+        const char *text = cell;
+        size_t len = 0;
+        int quoted = 0;         /* JSON 中按字符串输出 */
+        int null = 0;           /* JSON 中输出 null */
+
+        switch (col->type)
+        {
+            case CLI_COL_STR:
+                text = va_arg(args, const char *);
+                if (text == NULL)
+                {
+                    text = "";
+                }
+                len = strlen(text);
+                quoted = 1;
+                break;
+            case CLI_COL_INT:
+            {
+                int v = va_arg(args, int);
+                if (v < 0)
+                {
+                    cell[len++] = '-';
+                }
+                len += tbl_fmt_u64(cell + len, (v < 0) ? 0u - (uint64_t)(int64_t)v : (uint64_t)v);
+                break;
+            }
+            case CLI_COL_UINT:
+                len = tbl_fmt_u64(cell, va_arg(args, unsigned int));
+                break;
+            case CLI_COL_U64:
+                len = tbl_fmt_u64(cell, va_arg(args, uint64_t));
+                break;
+            case CLI_COL_HEX:
+                len = tbl_fmt_hex(cell, va_arg(args, uint64_t), col->prec);
+                quoted = 1;
+                break;
+            default:
+            {
+                double v = va_arg(args, double);
+                len = cli_fmt_double(cell, v, (col->prec < 0) ? 'g' : 'f', col->prec);
+                null = (v != v || v - v != 0.0);
+                break;
+            }
+        }
+
+        if (t->mode == CLI_MODE_JSON)
+        {
+            if (i > 0)
+            {
+                tbl_putc(&line, ',');
+            }
+            tbl_put_json_str(&line, col->name, strlen(col->name));
+            tbl_putc(&line, ':');
+            if (null)
+            {
+                tbl_put(&line, "null", 4);
+            }
+            else if (quoted)
+            {
+                tbl_put_json_str(&line, text, len);
+            }
+            else
+            {
+                tbl_put(&line, text, len);
+            }
+        }
+        else if (t->mode == CLI_MODE_CSV)
+        {
+            if (i > 0)
+            {
+                tbl_putc(&line, ',');
+            }
+            tbl_put_csv(&line, text, len);
+        }
+        else
+        {
+            tbl_put_cell(t, &line, i, text, len);
+        }
+    }
+    va_end(args);
+    if (t->mode == CLI_MODE_JSON)
+    {
+        tbl_putc(&line, '}');
+    }
+    tbl_end_line(&line);
+    t->rows++;
+}
+
+void cli_table_end(cli_table_t *t)
+{
+    /* 行已逐行写出，这里只复位状态，便于调用方复用 */
+    t->ncols = 0;
+}
+
+/* format 命令 */
+static int cmd_format(int argc, char **argv)
+{
+    int mode;
+
+    if (argc < 2)
+    {
+        cli_printf("%s\r\n", s_mode_names[cli_get_output_mode()]);
+        return 0;
+    }
+    if (cli_arg_enum(CLI_ARG(argv[1]), s_mode_names, 3, &mode) != CLI_SUCCESS)
+    {
+        cli_arg_report("format", CLI_ARG(argv[1]));
+        return -1;
+    }
+    cli_set_output_mode((cli_output_mode_t)mode);
+    return 0;
+}
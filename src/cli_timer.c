@@ -0,0 +1,326 @@
+/*
+ * @file cli_timer.c
+ * @brief 分级时间轮定时器实现
+ *
+ * 第 l 级的槽号取到期时刻的第 [l*BITS, (l+1)*BITS) 位；时钟走到第 l 级的
+ * 槽边界（低 l*BITS 位全为0）时，把该槽的定时器按剩余时间重新插入低级槽。
+ * 每级一个位图记录非空槽，用于跳过空槽和查询最近到期时刻。
+ * 到期的定时器先移入到期链表再逐个回调，回调中取消其它到期定时器也是安全的。
+ */
+
+#include <cli_timer.h>
+
+#if CLI_TIMER_SLOT_BITS > 5 || CLI_TIMER_SLOT_BITS * CLI_TIMER_LEVELS > 31
+#error "CLI_TIMER_SLOT_BITS must be <= 5 and SLOT_BITS * LEVELS <= 31"
+#endif
+
+#define TMR_SLOTS       (1u << CLI_TIMER_SLOT_BITS)
+#define TMR_MASK        (TMR_SLOTS - 1u)
+#define TMR_RANGE       (1u << (CLI_TIMER_SLOT_BITS * CLI_TIMER_LEVELS))
+#define TMR_EXPIRED     (CLI_TIMER_LEVELS * TMR_SLOTS)  /* 到期链表的槽号 */
+#define TMR_IDLE        0xFFFFu
+
+/* 时间轮 */
+static struct
+{
+    cli_timer_t *heads[CLI_TIMER_LEVELS * TMR_SLOTS + 1];
+    uint32_t map[CLI_TIMER_LEVELS];     /* 各级非空槽位图 */
+    uint32_t cur;                       /* 下一个待处理的时刻 */
+    uint32_t count;                     /* 已启动的定时器数 */
+    bool started;
+    bool running;                       /* 正在执行到期回调 */
+} s_wheel;
+
+static void tmr_start_wheel(void)
+{
+    if (!s_wheel.started)
+    {
+        s_wheel.cur = cli_get_tick_ms();
+        s_wheel.started = true;
+    }
+}
+
+/* 从 idx 起（含）循环查找第一个非空槽，返回距离 */
+static uint32_t tmr_first(uint32_t map, uint32_t idx)
+{
+    uint32_t r = map >> idx;
+
+    if (r != 0)
+    {
+        return (uint32_t)__builtin_ctz(r);
+    }
+    return TMR_SLOTS - idx + (uint32_t)__builtin_ctz(map);
+}
+
+static void tmr_link(cli_timer_t *t, uint16_t slot)
+{
+    t->slot = slot;
+    t->prev = NULL;
+    t->next = s_wheel.heads[slot];
+    if (t->next != NULL)
+    {
+        t->next->prev = t;
+    }
+    s_wheel.heads[slot] = t;
+    if (slot < TMR_EXPIRED)
+    {
+        s_wheel.map[slot / TMR_SLOTS] |= 1u << (slot & TMR_MASK);
+    }
+}
+
+static void tmr_unlink(cli_timer_t *t)
+{
+    if (t->prev != NULL)
+    {
+        t->prev->next = t->next;
+    }
+    else
+    {
+        s_wheel.heads[t->slot] = t->next;
+        if (t->next == NULL && t->slot < TMR_EXPIRED)
+        {
+            s_wheel.map[t->slot / TMR_SLOTS] &= ~(1u << (t->slot & TMR_MASK));
+        }
+    }
+    if (t->next != NULL)
+    {
+        t->next->prev = t->prev;
+    }
+    t->next = NULL;
+    t->prev = NULL;
+    t->slot = TMR_IDLE;
+}
+
+/* 按相对 s_wheel.cur 的剩余时间放入对应级的槽 */
+static void tmr_insert(cli_timer_t *t)
+{
+    uint32_t delta = t->expires - s_wheel.cur;
+    uint32_t when;
+    uint32_t level = 0;
+
+    if ((int32_t)delta < 0)
+    {
+        /* 已过期：下一次处理时到期；回调中启动的放到下一时刻，避免0间隔的定时器连续执行 */
+        if (!s_wheel.running)
+        {
+            tmr_link(t, TMR_EXPIRED);
+            return;
+        }
+        delta = 0;
+    }
+    if (delta >= TMR_RANGE)
+    {
+        /* 超出范围：放在最高级最远的槽，轮转到时重新计算 */
+        delta = TMR_RANGE - 1u;
+    }
+    when = s_wheel.cur + delta;
+    while (level + 1u < CLI_TIMER_LEVELS && delta >= (1u << (CLI_TIMER_SLOT_BITS * (level + 1u))))
+    {
+        level++;
+    }
+    tmr_link(t, (uint16_t)(level * TMR_SLOTS + ((when >> (CLI_TIMER_SLOT_BITS * level)) & TMR_MASK)));
+}
+
+void cli_timer_init(cli_timer_t *timer, cli_timer_fn_t fn, void *ctx)
+{
+    if (timer == NULL)
+    {
+        return;
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->expires = 0;
+    timer->slot = TMR_IDLE;
+    timer->fn = fn;
+    timer->ctx = ctx;
+}
+
+void cli_timer_start_at(cli_timer_t *timer, uint32_t expires_ms)
+{
+    if (timer == NULL || timer->fn == NULL)
+    {
+        return;
+    }
+    tmr_start_wheel();
+    cli_timer_cancel(timer);
+    timer->expires = expires_ms;
+    tmr_insert(timer);
+    s_wheel.count++;
+}
+
+void cli_timer_start(cli_timer_t *timer, uint32_t delay_ms)
+{
+    cli_timer_start_at(timer, cli_get_tick_ms() + delay_ms);
+}
+
+void cli_timer_cancel(cli_timer_t *timer)
+{
+    if (timer != NULL && timer->slot != TMR_IDLE)
+    {
+        tmr_unlink(timer);
+        s_wheel.count--;
+    }
+}
+
+bool cli_timer_pending(const cli_timer_t *timer)
+{
+    return timer != NULL && timer->slot != TMR_IDLE;
+}
+
+uint32_t cli_timer_next_expiry(void)
+{
+    uint32_t now;
+    uint32_t best = CLI_TIMER_NEVER;
+    uint32_t level;
+
+    if (s_wheel.count == 0)
+    {
+        return CLI_TIMER_NEVER;
+    }
+    if (s_wheel.heads[TMR_EXPIRED] != NULL)
+    {
+        return 0;
+    }
+    now = cli_get_tick_ms();
+    for (level = 0; level < CLI_TIMER_LEVELS; level++)
+    {
+        uint32_t shift = CLI_TIMER_SLOT_BITS * level;
+        uint32_t idx = (s_wheel.cur >> shift) & TMR_MASK;
+        uint32_t visit = (s_wheel.cur >> shift) << shift;
+        uint32_t map = s_wheel.map[level];
+
+        /* 当前槽已在边界处转出时，其中只可能是绕回一整圈的定时器，最后再找 */
+        if (level > 0 && s_wheel.cur != visit)
+        {
+            idx = (idx + 1u) & TMR_MASK;
+            visit += 1u << shift;
+        }
+        /*
+         * 按转到的先后检查非空槽：槽的转到时刻是其中定时器到期时刻的下界，
+         * 下界已不早于当前结果时停止（超出范围的定时器可能比后面的槽更晚）
+         */
+        while (map != 0)
+        {
+            uint32_t d = tmr_first(map, idx);
+            int32_t lower = (int32_t)(visit + (d << shift) - now);
+            const cli_timer_t *t;
+
+            if (lower > 0 && (uint32_t)lower >= best)
+            {
+                break;
+            }
+            idx = (idx + d) & TMR_MASK;
+            visit += d << shift;
+            for (t = s_wheel.heads[level * TMR_SLOTS + idx]; t != NULL; t = t->next)
+            {
+                int32_t rem = (int32_t)(t->expires - now);
+                uint32_t r = (rem < 0) ? 0u : (uint32_t)rem;
+                if (r < best)
+                {
+                    best = r;
+                }
+            }
+            map &= ~(1u << idx);
+        }
+    }
+    return best;
+}
+
+/* 时钟到达 tick：各级在槽边界处把该槽转入低级（从高到低） */
+static void tmr_cascade(uint32_t tick)
+{
+    uint32_t level;
+
+    for (level = CLI_TIMER_LEVELS - 1u; level > 0; level--)
+    {
+        uint32_t shift = CLI_TIMER_SLOT_BITS * level;
+        uint16_t slot;
+        cli_timer_t *t;
+
+        if ((tick & ((1u << shift) - 1u)) != 0)
+        {
+            continue;
+        }
+        slot = (uint16_t)(level * TMR_SLOTS + ((tick >> shift) & TMR_MASK));
+        while ((t = s_wheel.heads[slot]) != NULL)
+        {
+            tmr_unlink(t);
+            tmr_insert(t);
+        }
+    }
+}
+
+/* 从 from 起可以直接跳过的毫秒数（到下一个非空槽或需要转槽的边界，不超过 now） */
+static uint32_t tmr_skip(uint32_t from, uint32_t now)
+{
+    uint32_t step;
+    uint32_t level = 0;
+    uint32_t span;
+
+    if ((int32_t)(now - from) < 0)
+    {
+        return 0;
+    }
+    if (s_wheel.count == 0)
+    {
+        return now - from + 1u;
+    }
+    while (level + 1u < CLI_TIMER_LEVELS && s_wheel.map[level] == 0)
+    {
+        level++;
+    }
+    span = 1u << (CLI_TIMER_SLOT_BITS * (level > 0 ? level : 1u));
+    step = (span - (from & (span - 1u))) & (span - 1u);
+    if (level == 0 && step != 0)
+    {
+        uint32_t d = tmr_first(s_wheel.map[0], from & TMR_MASK);
+        if (d < step)
+        {
+            step = d;
+        }
+    }
+    if (step > now - from + 1u)
+    {
+        step = now - from + 1u;
+    }
+    return step;
+}
+
+/* 执行到期链表中的回调 */
+static void tmr_run_expired(void)
+{
+    cli_timer_t *t;
+
+    s_wheel.running = true;
+    while ((t = s_wheel.heads[TMR_EXPIRED]) != NULL)
+    {
+        tmr_unlink(t);
+        s_wheel.count--;
+        t->fn(t->ctx);
+    }
+    s_wheel.running = false;
+}
+
+void cli_timer_process(uint32_t now_ms)
+{
+    tmr_start_wheel();
+    tmr_run_expired();
+    s_wheel.cur += tmr_skip(s_wheel.cur, now_ms);
+    while ((int32_t)(now_ms - s_wheel.cur) >= 0)
+    {
+        uint32_t tick = s_wheel.cur;
+        uint16_t slot = (uint16_t)(tick & TMR_MASK);
+        cli_timer_t *t;
+
+        tmr_cascade(tick);
+        while ((t = s_wheel.heads[slot]) != NULL)
+        {
+            tmr_unlink(t);
+            tmr_link(t, TMR_EXPIRED);
+        }
+        /* 回调中重新启动的定时器相对下一时刻插入，最早在下一时刻到期 */
+        s_wheel.cur = tick + 1u;
+        tmr_run_expired();
+        s_wheel.cur += tmr_skip(s_wheel.cur, now_ms);
+    }
+}
@@ -0,0 +1,647 @@
+/*
+ * @file cli_var.c
+ * @brief 变量绑定注册表实现
+ *
+ * 变量按注册顺序存放在静态表中，另建开放寻址哈希索引用于按名称查找。
+ * 不超过机器字宽的变量通过单次 volatile（GCC 下为 __atomic）访问读写，
+ * 处理函数与中断/其他线程并发修改同一变量时不会读到撕裂的值。
+ */
+
+#include <cli_var.h>
+#include <cli_fmt.h>
+#include <cli_arg.h>
+#include <cli_table.h>
+#include <cli_style.h>
+#include <string.h>
+
+/* 哈希索引槽数（2的幂，至少为变量数的2倍） */
+#define VAR_HASH_SIZE       (CLI_MAX_VARS * 2 <= 16 ? 16 : \
+                             CLI_MAX_VARS * 2 <= 32 ? 32 : \
+                             CLI_MAX_VARS * 2 <= 64 ? 64 : \
+                             CLI_MAX_VARS * 2 <= 128 ? 128 : \
+                             CLI_MAX_VARS * 2 <= 256 ? 256 : 512)
+#define VAR_HASH_EMPTY      0xFFFF
+
+/* 原子访问 */
+#if defined(__GNUC__)
+#define VAR_LOAD(p)         __atomic_load_n((p), __ATOMIC_RELAXED)
+#define VAR_STORE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#else
+#define VAR_LOAD(p)         (*(p))
+#define VAR_STORE(p, v)     (*(p) = (v))
+#endif
+
+/* 变量表 */
+static cli_var_t s_vars[CLI_MAX_VARS];
+static int s_var_count = 0;
+
+/* 哈希索引：存放变量表下标 */
+static uint16_t s_var_hash[VAR_HASH_SIZE];
+static bool s_var_hash_ready = false;
+
+static int cmd_get(int argc, char **argv);
+static int cmd_set(int argc, char **argv);
+static int cmd_list(int argc, char **argv);
+
+const cli_command_t cli_var_get_cmd = {
+    .name = "get",
+    .short_name = NULL,
+    .help = CLI_HELP("Read variables: get <name...>"),
+    .handler = cmd_get
+};
+
+const cli_command_t cli_var_set_cmd = {
+    .name = "set",
+    .short_name = NULL,
+    .help = CLI_HELP("Write a variable: set <name> <value>"),
+    .handler = cmd_set
+};
+
+const cli_command_t cli_var_list_cmd = {
+    .name = "list",
+    .short_name = NULL,
+    .help = CLI_HELP("List variables: list [prefix]"),
+    .handler = cmd_list
+};
+
+/* FNV-1a 哈希 */
+static uint32_t var_hash(const char *name)
+{
+    uint32_t h = 2166136261u;
+    while (*name)
+    {
+        h ^= (uint8_t)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* 查找变量表下标，未找到返回-1 */
+static int var_lookup(const char *name)
+{
+    uint32_t slot;
+
+    if (!s_var_hash_ready || name == NULL)
+    {
+        return -1;
+    }
+    slot = var_hash(name) & (VAR_HASH_SIZE - 1);
+    while (s_var_hash[slot] != VAR_HASH_EMPTY)
+    {
+        int idx = s_var_hash[slot];
+        if (strcmp(s_vars[idx].name, name) == 0)
+        {
+            return idx;
+        }
+        slot = (slot + 1) & (VAR_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+/* 注册变量 */
+cli_error_t cli_var_register(const char *name, volatile void *ptr, cli_var_type_t type, uint8_t flags)
+{
+    uint32_t slot;
+    cli_var_t *var;
+
+    if (name == NULL || ptr == NULL || type > CLI_VAR_ENUM)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    if (!s_var_hash_ready)
+    {
+        memset(s_var_hash, 0xFF, sizeof(s_var_hash));
+        s_var_hash_ready = true;
+    }
+    if (var_lookup(name) >= 0)
+    {
+        return CLI_ERR_DUPLICATE;
+    }
+    if (s_var_count >= CLI_MAX_VARS)
+    {
+        return CLI_ERR_TABLE_FULL;
+    }
+
+    var = &s_vars[s_var_count];
+    memset(var, 0, sizeof(*var));
+    var->name = name;
+    var->ptr = ptr;
+    var->type = type;
+    var->flags = flags;
+
+    slot = var_hash(name) & (VAR_HASH_SIZE - 1);
+    while (s_var_hash[slot] != VAR_HASH_EMPTY)
+    {
+        slot = (slot + 1) & (VAR_HASH_SIZE - 1);
+    }
+    s_var_hash[slot] = (uint16_t)s_var_count;
+    s_var_count++;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_var_set_range(const char *name, int32_t min, int32_t max)
+{
+    int idx = var_lookup(name);
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    if (min > max || s_vars[idx].type == CLI_VAR_FLOAT)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    if (s_vars[idx].type == CLI_VAR_UINT32)
+    {
+        /* 负的下限无法用无符号值表示，大于 INT32_MAX 的范围用 cli_var_set_range_u */
+        if (min < 0)
+        {
+            return CLI_ERR_INVALID_PARAM;
+        }
+        s_vars[idx].min.u = (uint32_t)min;
+        s_vars[idx].max.u = (uint32_t)max;
+    }
+    else
+    {
+        s_vars[idx].min.i = min;
+        s_vars[idx].max.i = max;
+    }
+    s_vars[idx].has_range = true;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_var_set_range_u(const char *name, uint32_t min, uint32_t max)
+{
+    int idx = var_lookup(name);
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    if (min > max || s_vars[idx].type != CLI_VAR_UINT32)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    s_vars[idx].min.u = min;
+    s_vars[idx].max.u = max;
+    s_vars[idx].has_range = true;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_var_set_range_f(const char *name, float min, float max)
+{
+    int idx = var_lookup(name);
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    if (!(min <= max) || s_vars[idx].type != CLI_VAR_FLOAT)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    s_vars[idx].min.f = min;
+    s_vars[idx].max.f = max;
+    s_vars[idx].has_range = true;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_var_set_enum(const char *name, const char *const *names, int count)
+{
+    int idx = var_lookup(name);
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    if (names == NULL || count <= 0 || s_vars[idx].type != CLI_VAR_ENUM)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    s_vars[idx].enum_names = names;
+    s_vars[idx].enum_count = count;
+    s_vars[idx].min.i = 0;
+    s_vars[idx].max.i = count - 1;
+    s_vars[idx].has_range = true;
+    return CLI_SUCCESS;
+}
+
+cli_error_t cli_var_set_notify(const char *name, cli_var_notify_t notify)
+{
+    int idx = var_lookup(name);
+    if (idx < 0)
+    {
+        return CLI_ERR_NOT_FOUND;
+    }
+    s_vars[idx].notify = notify;
+    return CLI_SUCCESS;
+}
+
+const cli_var_t* cli_var_find(const char *name)
+{
+    int idx = var_lookup(name);
+    return (idx < 0) ? NULL : &s_vars[idx];
+}
+
+int cli_var_get_count(void)
+{
+    return s_var_count;
+}
+
+const cli_var_t* cli_var_get_dsc(int index)
+{
+    if (index < 0 || index >= s_var_count)
+    {
+        return NULL;
+    }
+    return &s_vars[index];
+}
+
+size_t cli_var_type_size(cli_var_type_t type)
+{
+    switch (type)
+    {
+        case CLI_VAR_INT8:
+        case CLI_VAR_UINT8:
+            return 1;
+        case CLI_VAR_INT16:
+        case CLI_VAR_UINT16:
+            return 2;
+        case CLI_VAR_BOOL:
+            return sizeof(bool);
+        case CLI_VAR_ENUM:
+            return sizeof(int);
+        default:
+            return 4;
+    }
+}
+
+/* 原子读取 */
+cli_var_value_t cli_var_load(const cli_var_t *var)
+{
+    cli_var_value_t v;
+    v.u = 0;
+    switch (var->type)
+    {
+        case CLI_VAR_INT8:
+            v.i = (int8_t)VAR_LOAD((volatile uint8_t *)var->ptr);
+            break;
+        case CLI_VAR_UINT8:
+            v.u = VAR_LOAD((volatile uint8_t *)var->ptr);
+            break;
+        case CLI_VAR_INT16:
+            v.i = (int16_t)VAR_LOAD((volatile uint16_t *)var->ptr);
+            break;
+        case CLI_VAR_UINT16:
+            v.u = VAR_LOAD((volatile uint16_t *)var->ptr);
+            break;
+        case CLI_VAR_BOOL:
+            v.u = VAR_LOAD((volatile bool *)var->ptr) ? 1u : 0u;
+            break;
+        case CLI_VAR_ENUM:
+            v.i = (int32_t)VAR_LOAD((volatile int *)var->ptr);
+            break;
+        default:
+            /* INT32/UINT32/FLOAT 均按32位字读取 */
+            v.u = VAR_LOAD((volatile uint32_t *)var->ptr);
+            break;
+    }
+    return v;
+}
+
+/* 范围检查 */
+static bool var_in_range(const cli_var_t *var, cli_var_value_t value)
+{
+    if (!var->has_range)
+    {
+        return true;
+    }
+    switch (var->type)
+    {
+        case CLI_VAR_FLOAT:
+            return value.f >= var->min.f && value.f <= var->max.f;
+        case CLI_VAR_UINT32:
+            return value.u >= var->min.u && value.u <= var->max.u;
+        default:
+            return value.i >= var->min.i && value.i <= var->max.i;
+    }
+}
+
+/* 类型自身的取值范围 */
+static bool var_fits_type(const cli_var_t *var, cli_var_value_t value)
+{
+    switch (var->type)
+    {
+        case CLI_VAR_INT8:
+            return value.i >= INT8_MIN && value.i <= INT8_MAX;
+        case CLI_VAR_UINT8:
+            return value.u <= UINT8_MAX;
+        case CLI_VAR_INT16:
+            return value.i >= INT16_MIN && value.i <= INT16_MAX;
+        case CLI_VAR_UINT16:
+            return value.u <= UINT16_MAX;
+        case CLI_VAR_BOOL:
+            return value.u <= 1u;
+        case CLI_VAR_FLOAT:
+            return value.f == value.f;
+        default:
+            return true;
+    }
+}
+
+/* 原子写入 */
+cli_error_t cli_var_store(const cli_var_t *var, cli_var_value_t value)
+{
+    if (var == NULL)
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    if (var->flags & CLI_VAR_FLAG_READONLY)
+    {
+        return CLI_ERR_READONLY;
+    }
+    if (!var_fits_type(var, value) || !var_in_range(var, value))
+    {
+        return CLI_ERR_RANGE;
+    }
+
+    switch (var->type)
+    {
+        case CLI_VAR_INT8:
+        case CLI_VAR_UINT8:
+            VAR_STORE((volatile uint8_t *)var->ptr, (uint8_t)value.u);
+            break;
+        case CLI_VAR_INT16:
+        case CLI_VAR_UINT16:
+            VAR_STORE((volatile uint16_t *)var->ptr, (uint16_t)value.u);
+            break;
+        case CLI_VAR_BOOL:
+            VAR_STORE((volatile bool *)var->ptr, value.u != 0u);
+            break;
+        case CLI_VAR_ENUM:
+            VAR_STORE((volatile int *)var->ptr, (int)value.i);
+            break;
+        default:
+            VAR_STORE((volatile uint32_t *)var->ptr, value.u);
+            break;
+    }
+
+    if (var->notify != NULL)
+    {
+        var->notify(var);
+    }
+    return CLI_SUCCESS;
+}
+
+/* 无符号十进制格式化 */
+static size_t var_fmt_u32(char *out, uint32_t val)
+{
+    char buf[10];
+    size_t i = 0;
+    size_t n = 0;
+    do {
+        buf[i++] = (char)('0' + val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0)
+    {
+        out[n++] = buf[--i];
+    }
+    return n;
+}
+
+size_t cli_var_format(const cli_var_t *var, cli_var_value_t value, char *buf, size_t size)
+{
+    char tmp[CLI_VAR_TEXT_MAX];
+    const char *text = tmp;
+    size_t n = 0;
+
+    switch (var->type)
+    {
+        case CLI_VAR_UINT8:
+        case CLI_VAR_UINT16:
+        case CLI_VAR_UINT32:
+            n = var_fmt_u32(tmp, value.u);
+            break;
+        case CLI_VAR_FLOAT:
+            n = cli_fmt_float(tmp, value.f);
+            break;
+        case CLI_VAR_BOOL:
+            text = value.u ? "on" : "off";
+            n = strlen(text);
+            break;
+        case CLI_VAR_ENUM:
+            if (var->enum_names != NULL && value.i >= 0 && value.i < var->enum_count)
+            {
+                text = var->enum_names[value.i];
+                n = strlen(text);
+                break;
+            }
+            /* 超出名称表时按整数显示 */
+            /* fall through */
+        default:
+            if (value.i < 0)
+            {
+                tmp[0] = '-';
+                n = 1 + var_fmt_u32(tmp + 1, (uint32_t)0 - value.u);
+            }
+            else
+            {
+                n = var_fmt_u32(tmp, value.u);
+            }
+            break;
+    }
+
+    if (size == 0)
+    {
+        return 0;
+    }
+    if (n >= size)
+    {
+        n = size - 1;
+    }
+    memcpy(buf, text, n);
+    buf[n] = '\0';
+    return n;
+}
+
+cli_error_t cli_var_parse(const cli_var_t *var, const char *text, cli_var_value_t *value)
+{
+    size_t len;
+    int64_t v = 0;
+    cli_error_t err;
+
+    if (var == NULL || text == NULL || value == NULL || text[0] == '\0')
+    {
+        return CLI_ERR_INVALID_PARAM;
+    }
+    len = strlen(text);
+
+    switch (var->type)
+    {
+        case CLI_VAR_FLOAT:
+            return cli_arg_float(text, len, &value->f);
+        case CLI_VAR_BOOL:
+        {
+            bool on;
+            err = cli_arg_bool(text, len, &on);
+            if (err == CLI_SUCCESS)
+            {
+                value->u = on ? 1u : 0u;
+            }
+            return err;
+        }
+        case CLI_VAR_ENUM:
+        {
+            int index;
+            if (var->enum_names != NULL &&
+                cli_arg_enum(text, len, var->enum_names, var->enum_count, &index) == CLI_SUCCESS)
+            {
+                value->i = index;
+                return CLI_SUCCESS;
+            }
+            err = cli_arg_i64(text, len, INT32_MIN, INT32_MAX, &v);
+            value->i = (int32_t)v;
+            break;
+        }
+        case CLI_VAR_UINT8:
+        case CLI_VAR_UINT16:
+        case CLI_VAR_UINT32:
+            err = cli_arg_i64(text, len, 0, UINT32_MAX, &v);
+            value->u = (uint32_t)v;
+            break;
+        default:
+            err = cli_arg_i64(text, len, INT32_MIN, INT32_MAX, &v);
+            value->i = (int32_t)v;
+            break;
+    }
+    return err;
+}
+
+/* 输出 "name = value" */
+static void var_print(const cli_var_t *var)
+{
+    char text[CLI_VAR_TEXT_MAX];
+    cli_var_format(var, cli_var_load(var), text, sizeof(text));
+    cli_printf("%s = %s\r\n", var->name, text);
+}
+
+/* get 命令 */
+static int cmd_get(int argc, char **argv)
+{
+    int ret = 0;
+
+    if (argc < 2)
+    {
+        cli_puts("Usage: get <name...>\r\n");
+        return -1;
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        const cli_var_t *var = cli_var_find(argv[i]);
+        if (var == NULL)
+        {
+            cli_printf("Unknown variable: %s\r\n", argv[i]);
+            ret = -1;
+            continue;
+        }
+        var_print(var);
+    }
+    return ret;
+}
+
+/* set 命令 */
+static int cmd_set(int argc, char **argv)
+{
+    const cli_var_t *var;
+    cli_var_value_t value;
+    cli_error_t err;
+
+    if (argc != 3)
+    {
+        cli_puts("Usage: set <name> <value>\r\n");
+        return -1;
+    }
+    var = cli_var_find(argv[1]);
+    if (var == NULL)
+    {
+        cli_printf("Unknown variable: %s\r\n", argv[1]);
+        return -1;
+    }
+
+    err = cli_var_parse(var, argv[2], &value);
+    if (err == CLI_SUCCESS)
+    {
+        err = cli_var_store(var, value);
+    }
+
+    switch (err)
+    {
+        case CLI_SUCCESS:
+            var_print(var);
+            return 0;
+        case CLI_ERR_READONLY:
+            cli_style(CLI_STYLE_WARN);
+            cli_printf("%s is read-only", var->name);
+            break;
+        case CLI_ERR_RANGE:
+            cli_style(CLI_STYLE_ERROR);
+            if (var->has_range)
+            {
+                char lo[CLI_VAR_TEXT_MAX];
+                char hi[CLI_VAR_TEXT_MAX];
+                cli_var_format(var, var->min, lo, sizeof(lo));
+                cli_var_format(var, var->max, hi, sizeof(hi));
+                cli_printf("%s out of range [%s, %s]", argv[2], lo, hi);
+            }
+            else
+            {
+                cli_printf("%s out of range", argv[2]);
+            }
+            break;
+        default:
+            cli_style(CLI_STYLE_ERROR);
+            cli_printf("Invalid value: %s", argv[2]);
+            break;
+    }
+    /* 在换行前复位，样式不延续到下一行 */
+    cli_style(CLI_STYLE_NORMAL);
+    cli_puts("\r\n");
+    return -1;
+}
+
+/* 类型名称 */
+static const char* var_type_name(cli_var_type_t type)
+{
+    static const char *const names[] = {
+        "i8", "u8", "i16", "u16", "i32", "u32", "float", "bool", "enum"
+    };
+    return names[type];
+}
+
+/* list 命令 */
+static int cmd_list(int argc, char **argv)
+{
+    static const cli_table_col_t cols[] = {
+        { "name",   CLI_COL_STR, 12, 0, 0 },
+        { "value",  CLI_COL_STR, 10, CLI_COL_RIGHT, 0 },
+        { "type",   CLI_COL_STR, 5, 0, 0 },
+        { "access", CLI_COL_STR, 0, 0, 0 },
+    };
+    const char *prefix = (argc > 1) ? argv[1] : "";
+    size_t prefix_len = strlen(prefix);
+    cli_table_t table;
+
+    cli_table_begin(&table, cols, 4);
+    for (int i = 0; i < s_var_count; i++)
+    {
+        const cli_var_t *var = &s_vars[i];
+        char text[CLI_VAR_TEXT_MAX];
+
+        if (strncmp(var->name, prefix, prefix_len) != 0)
+        {
+            continue;
+        }
+        cli_var_format(var, cli_var_load(var), text, sizeof(text));
+        cli_table_row(&table, var->name, text, var_type_name(var->type),
+                      (var->flags & CLI_VAR_FLAG_READONLY) ? "ro" : "rw");
+    }
+    cli_table_end(&table);
+    return 0;
+}
@@ -0,0 +1,791 @@
+/*
+ * @file cli_ymodem.c
+ * @brief YMODEM 文件传输实现
+ *
+ * 协议由 cli_process_char 逐字节驱动（通过 cli_input_acquire 接管输入），
+ * 超时和重发由时间轮定时器处理（每个字节后按当前状态重新设定最近的期限），
+ * 命令本身立即返回。接收的数据块直接写入存储
+ * 接口，发送时只缓存当前一个块用于重发。
+ */
+
+#include <cli_ymodem.h>
+#include <cli_timer.h>
+#include <string.h>
+
+#define YM_SOH                  0x01
+#define YM_STX                  0x02
+#define YM_EOT                  0x04
+#define YM_ACK                  0x06
+#define YM_NAK                  0x15
+#define YM_CAN                  0x18
+#define YM_CRC                  'C'
+#define YM_PAD                  0x1A
+
+#define YM_BLOCK_128            128u
+#define YM_BLOCK_1K             1024u
+#define YM_PACKET_MAX           (3u + YM_BLOCK_1K + 2u)
+
+/* 超时配置（毫秒） */
+#ifndef CLI_YMODEM_BYTE_TIMEOUT
+#define CLI_YMODEM_BYTE_TIMEOUT     1000u   /* 包内字节间隔 */
+#endif
+#ifndef CLI_YMODEM_PACKET_TIMEOUT
+#define CLI_YMODEM_PACKET_TIMEOUT   10000u  /* 等待数据包/应答 */
+#endif
+#ifndef CLI_YMODEM_START_TIMEOUT
+#define CLI_YMODEM_START_TIMEOUT    60000u  /* 等待对端启动 */
+#endif
+#define YM_C_INTERVAL           1000u       /* 接收方发送 'C' 的间隔 */
+#define YM_MAX_RETRIES          10
+
+/* 传输方向 */
+typedef enum
+{
+    YM_IDLE,
+    YM_RX,
+    YM_TX
+} ym_mode_t;
+
+/* 发送阶段 */
+typedef enum
+{
+    TX_WAIT_C_HDR,              /* 等待 'C' 发送头块 */
+    TX_WAIT_ACK_HDR,            /* 等待头块应答 */
+    TX_WAIT_C_DATA,             /* 等待 'C' 开始数据 */
+    TX_WAIT_ACK_DATA,           /* 等待数据块应答 */
+    TX_WAIT_ACK_EOT,            /* 等待 EOT 应答 */
+    TX_WAIT_C_FIN,              /* 等待 'C' 发送结束块 */
+    TX_WAIT_ACK_FIN             /* 等待结束块应答 */
+} ym_tx_phase_t;
+
+/* 传输状态 */
+static struct
+{
+    const cli_ymodem_storage_t *storage;
+    ym_mode_t mode;
+    uint8_t packet[YM_PACKET_MAX];  /* 接收：正在组装的包；发送：当前待重发的包 */
+    size_t pos;                     /* 接收包已收字节数 */
+    size_t need;                    /* 接收包总字节数 */
+    size_t packet_len;              /* 发送包长度 */
+    uint8_t block;                  /* 期望/当前块号 */
+    bool file_open;
+    bool started;                   /* 对端已响应 */
+    uint32_t file_size;
+    uint32_t file_bytes;            /* 当前文件已传输字节 */
+    uint32_t total_bytes;
+    uint32_t files;
+    uint32_t start_ms;
+    uint32_t last_ms;               /* 最近一次收到数据的时刻 */
+    uint32_t last_tx_ms;            /* 最近一次发送的时刻 */
+    int retries;
+    int can_count;
+    int eot_count;
+    ym_tx_phase_t phase;
+} s_ym;
+
+/* 超时定时器（不随 s_ym 清零） */
+static cli_timer_t s_ym_timer;
+
+static int cmd_rx(int argc, char **argv);
+static int cmd_sx(int argc, char **argv);
+
+const cli_command_t cli_ymodem_rx_cmd = {
+    .name = "rx",
+    .short_name = NULL,
+    .help = CLI_HELP("Receive files via YMODEM"),
+    .handler = cmd_rx
+};
+
+const cli_command_t cli_ymodem_sx_cmd = {
+    .name = "sx",
+    .short_name = NULL,
+    .help = CLI_HELP("Send a file via YMODEM: sx <file>"),
+    .handler = cmd_sx
+};
+
+/* CRC-16/XMODEM (多项式 0x1021) 查表 */
+static const uint16_t s_crc16_table[256] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+static uint16_t ym_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0;
+    while (len--)
+    {
+        crc = (uint16_t)((crc << 8) ^ s_crc16_table[(uint8_t)(crc >> 8) ^ *data++]);
+    }
+    return crc;
+}
+
+static void ym_send_byte(uint8_t c)
+{
+    cli_write((const char *)&c, 1);
+    s_ym.last_tx_ms = cli_get_tick_ms();
+}
+
+/* 结束传输，恢复命令行 */
+static void ym_finish(bool ok, const char *reason)
+{
+    ym_mode_t mode = s_ym.mode;
+
+    if (s_ym.file_open)
+    {
+        s_ym.storage->close(s_ym.storage->ctx, ok);
+        s_ym.file_open = false;
+    }
+    s_ym.mode = YM_IDLE;
+    cli_timer_cancel(&s_ym_timer);
+    cli_set_binary(0);
+    if (ok)
+    {
+        cli_printf("\r\n%s: %u file(s), %u bytes in %u ms\r\n",
+                   (mode == YM_RX) ? "rx" : "sx",
+                   (unsigned int)s_ym.files, (unsigned int)s_ym.total_bytes,
+                   (unsigned int)(cli_get_tick_ms() - s_ym.start_ms));
+    }
+    else
+    {
+        cli_printf("\r\n%s aborted: %s\r\n", (mode == YM_RX) ? "rx" : "sx", reason);
+    }
+    cli_input_release();
+}
+
+/* 中止传输并通知对端 */
+static void ym_abort(const char *reason)
+{
+    static const char cancel[] = { YM_CAN, YM_CAN, YM_CAN, YM_CAN, YM_CAN };
+    cli_write(cancel, sizeof(cancel));
+    ym_finish(false, reason);
+}
+
+/* 连续两个 CAN 表示对端中止 */
+static bool ym_check_cancel(uint8_t c)
+{
+    if (c == YM_CAN)
+    {
+        if (++s_ym.can_count >= 2)
+        {
+            ym_finish(false, "cancelled by peer");
+            return true;
+        }
+    }
+    else
+    {
+        s_ym.can_count = 0;
+    }
+    return false;
+}
+
+/* 解析十进制数 */
+static uint32_t ym_parse_u32(const char *s, const char *end)
+{
+    uint32_t v = 0;
+    while (s < end && *s >= '0' && *s <= '9')
+    {
+        v = v * 10u + (uint32_t)(*s++ - '0');
+    }
+    return v;
+}
+
+/* ---------------- 接收 ---------------- */
+
+/* 处理 0 号块（文件头） */
+static void ym_rx_header(const uint8_t *data, size_t len)
+{
+    const char *name = (const char *)data;
+    size_t name_len = 0;
+
+    while (name_len < len && name[name_len] != '\0')
+    {
+        name_len++;
+    }
+
+    if (name_len == 0)
+    {
+        /* 空文件名：批处理结束 */
+        ym_send_byte(YM_ACK);
+        ym_finish(true, NULL);
+        return;
+    }
+    if (name_len >= len)
+    {
+        ym_abort("bad header");
+        return;
+    }
+    s_ym.file_size = ym_parse_u32(name + name_len + 1, (const char *)data + len);
+    s_ym.file_bytes = 0;
+    if (s_ym.storage->open_write(s_ym.storage->ctx, name, s_ym.file_size) != 0)
+    {
+        ym_abort("cannot open file");
+        return;
+    }
+    s_ym.file_open = true;
+    s_ym.block = 1;
+    s_ym.eot_count = 0;
+    ym_send_byte(YM_ACK);
+    ym_send_byte(YM_CRC);
+}
+
+/* 处理数据块 */
+static void ym_rx_data(uint8_t block, const uint8_t *data, size_t len)
+{
+    if (block == (uint8_t)(s_ym.block - 1))
+    {
+        /* 重复块（应答丢失），仅应答 */
+        ym_send_byte(YM_ACK);
+        return;
+    }
+    if (block != s_ym.block)
+    {
+        ym_abort("block sequence error");
+        return;
+    }
+    /* 已知文件大小时去掉末块填充 */
+    if (s_ym.file_size != 0 && s_ym.file_bytes + len > s_ym.file_size)
+    {
+        len = s_ym.file_size - s_ym.file_bytes;
+    }
+    if (len > 0 && s_ym.storage->write(s_ym.storage->ctx, data, len) != 0)
+    {
+        ym_abort("write failed");
+        return;
+    }
+    s_ym.file_bytes += (uint32_t)len;
+    s_ym.total_bytes += (uint32_t)len;
+    s_ym.block++;
+    s_ym.retries = 0;
+    ym_send_byte(YM_ACK);
+}
+
+/* 一个完整的包已收到 */
+static void ym_rx_packet(void)
+{
+    uint8_t block = s_ym.packet[1];
+    size_t data_len = s_ym.need - 5;
+    const uint8_t *data = &s_ym.packet[3];
+    uint16_t crc = (uint16_t)((s_ym.packet[3 + data_len] << 8) | s_ym.packet[4 + data_len]);
+
+    s_ym.pos = 0;
+    if ((uint8_t)(block ^ s_ym.packet[2]) != 0xFF || ym_crc16(data, data_len) != crc)
+    {
+        if (++s_ym.retries > YM_MAX_RETRIES)
+        {
+            ym_abort("too many errors");
+            return;
+        }
+        ym_send_byte(YM_NAK);
+        return;
+    }
+
+    if (!s_ym.file_open)
+    {
+        if (block != 0)
+        {
+            ym_abort("expected header block");
+            return;
+        }
+        ym_rx_header(data, data_len);
+    }
+    else
+    {
+        ym_rx_data(block, data, data_len);
+    }
+}
+
+/* 接收方向的输入处理 */
+static void ym_rx_input(uint8_t c)
+{
+    s_ym.last_ms = cli_get_tick_ms();
+
+    if (s_ym.pos == 0)
+    {
+        if (ym_check_cancel(c))
+        {
+            return;
+        }
+        switch (c)
+        {
+            case YM_SOH:
+                s_ym.need = 3u + YM_BLOCK_128 + 2u;
+                break;
+            case YM_STX:
+                s_ym.need = 3u + YM_BLOCK_1K + 2u;
+                break;
+            case YM_EOT:
+                if (s_ym.file_open)
+                {
+                    /* 第一个 EOT 回 NAK 确认，第二个回 ACK 结束当前文件 */
+                    if (++s_ym.eot_count < 2)
+                    {
+                        ym_send_byte(YM_NAK);
+                    }
+                    else
+                    {
+                        s_ym.storage->close(s_ym.storage->ctx, true);
+                        s_ym.file_open = false;
+                        s_ym.files++;
+                        ym_send_byte(YM_ACK);
+                        ym_send_byte(YM_CRC);
+                    }
+                }
+                return;
+            default:
+                return;     /* 包间噪声 */
+        }
+        s_ym.started = true;
+    }
+
+    s_ym.packet[s_ym.pos++] = c;
+    if (s_ym.pos == s_ym.need)
+    {
+        ym_rx_packet();
+    }
+}
+
+/* 接收方向的超时处理 */
+static void ym_rx_timeout(uint32_t now)
+{
+    if (s_ym.pos > 0)
+    {
+        if (now - s_ym.last_ms >= CLI_YMODEM_BYTE_TIMEOUT)
+        {
+            /* 包不完整：丢弃并请求重发 */
+            s_ym.pos = 0;
+            if (++s_ym.retries > YM_MAX_RETRIES)
+            {
+                ym_abort("timeout");
+                return;
+            }
+            ym_send_byte(YM_NAK);
+        }
+        return;
+    }
+
+    if (!s_ym.file_open)
+    {
+        /* 等待文件头：周期性发送 'C' */
+        if (now - s_ym.last_ms >= (s_ym.started ? CLI_YMODEM_PACKET_TIMEOUT : CLI_YMODEM_START_TIMEOUT))
+        {
+            ym_abort("timeout");
+        }
+        else if (now - s_ym.last_tx_ms >= YM_C_INTERVAL)
+        {
+            ym_send_byte(YM_CRC);
+        }
+    }
+    else if (now - s_ym.last_ms >= CLI_YMODEM_PACKET_TIMEOUT)
+    {
+        if (++s_ym.retries > YM_MAX_RETRIES)
+        {
+            ym_abort("timeout");
+            return;
+        }
+        s_ym.last_ms = now;
+        ym_send_byte(YM_NAK);
+    }
+}
+
+/* ---------------- 发送 ---------------- */
+
+/* 组装包：头 + 数据（不足部分填充） + CRC */
+static void ym_tx_build(uint8_t block, const uint8_t *data, size_t len, size_t block_size, uint8_t pad)
+{
+    uint16_t crc;
+    s_ym.packet[0] = (block_size == YM_BLOCK_1K) ? YM_STX : YM_SOH;
+    s_ym.packet[1] = block;
+    s_ym.packet[2] = (uint8_t)~block;
+    if (len > 0 && data != &s_ym.packet[3])
+    {
+        memcpy(&s_ym.packet[3], data, len);
+    }
+    memset(&s_ym.packet[3 + len], pad, block_size - len);
+    crc = ym_crc16(&s_ym.packet[3], block_size);
+    s_ym.packet[3 + block_size] = (uint8_t)(crc >> 8);
+    s_ym.packet[4 + block_size] = (uint8_t)crc;
+    s_ym.packet_len = 5 + block_size;
+}
+
+static void ym_tx_send_packet(void)
+{
+    cli_write((const char *)s_ym.packet, s_ym.packet_len);
+    s_ym.last_tx_ms = cli_get_tick_ms();
+}
+
+/* 从存储读取下一块，返回 false 表示文件结束 */
+static bool ym_tx_next_block(void)
+{
+    uint8_t *data = &s_ym.packet[3];
+    size_t len = 0;
+
+    /* 尽量填满 1K 块，存储接口可能一次返回较少数据 */
+    while (len < YM_BLOCK_1K)
+    {
+        int n = s_ym.storage->read(s_ym.storage->ctx, data + len, YM_BLOCK_1K - len);
+        if (n < 0)
+        {
+            ym_abort("read failed");
+            return false;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        len += (size_t)n;
+    }
+    if (len == 0)
+    {
+        return false;
+    }
+    s_ym.block++;
+    ym_tx_build(s_ym.block, data, len, (len > YM_BLOCK_128) ? YM_BLOCK_1K : YM_BLOCK_128, YM_PAD);
+    s_ym.file_bytes += (uint32_t)len;
+    return true;
+}
+
+/* 发送 EOT */
+static void ym_tx_eot(void)
+{
+    s_ym.phase = TX_WAIT_ACK_EOT;
+    ym_send_byte(YM_EOT);
+}
+
+/* 发送方向的输入处理 */
+static void ym_tx_input(uint8_t c)
+{
+    s_ym.last_ms = cli_get_tick_ms();
+    if (ym_check_cancel(c))
+    {
+        return;
+    }
+    if (c != YM_ACK && c != YM_NAK && c != YM_CRC)
+    {
+        return;
+    }
+    s_ym.started = true;
+
+    switch (s_ym.phase)
+    {
+        case TX_WAIT_C_HDR:
+            if (c == YM_CRC)
+            {
+                s_ym.phase = TX_WAIT_ACK_HDR;
+                ym_tx_send_packet();
+            }
+            break;
+
+        case TX_WAIT_ACK_HDR:
+            if (c == YM_ACK)
+            {
+                s_ym.phase = TX_WAIT_C_DATA;
+            }
+            else
+            {
+                ym_tx_send_packet();
+            }
+            break;
+
+        case TX_WAIT_C_DATA:
+            if (c == YM_CRC)
+            {
+                s_ym.retries = 0;
+                if (ym_tx_next_block())
+                {
+                    s_ym.phase = TX_WAIT_ACK_DATA;
+                    ym_tx_send_packet();
+                }
+                else if (s_ym.mode == YM_TX)
+                {
+                    ym_tx_eot();
+                }
+            }
+            break;
+
+        case TX_WAIT_ACK_DATA:
+            if (c == YM_ACK)
+            {
+                s_ym.retries = 0;
+                if (ym_tx_next_block())
+                {
+                    ym_tx_send_packet();
+                }
+                else if (s_ym.mode == YM_TX)
+                {
+                    ym_tx_eot();
+                }
+            }
+            else if (c == YM_NAK)
+            {
+                if (++s_ym.retries > YM_MAX_RETRIES)
+                {
+                    ym_abort("too many errors");
+                    return;
+                }
+                ym_tx_send_packet();
+            }
+            break;
+
+        case TX_WAIT_ACK_EOT:
+            if (c == YM_ACK)
+            {
+                s_ym.storage->close(s_ym.storage->ctx, true);
+                s_ym.file_open = false;
+                s_ym.files++;
+                s_ym.total_bytes += s_ym.file_bytes;
+                s_ym.phase = TX_WAIT_C_FIN;
+            }
+            else if (c == YM_NAK)
+            {
+                ym_send_byte(YM_EOT);
+            }
+            break;
+
+        case TX_WAIT_C_FIN:
+            if (c == YM_CRC)
+            {
+                /* 空文件头表示批处理结束 */
+                ym_tx_build(0, NULL, 0, YM_BLOCK_128, 0);
+                s_ym.phase = TX_WAIT_ACK_FIN;
+                ym_tx_send_packet();
+            }
+            break;
+
+        case TX_WAIT_ACK_FIN:
+            if (c == YM_ACK)
+            {
+                ym_finish(true, NULL);
+            }
+            else if (c == YM_NAK)
+            {
+                ym_tx_send_packet();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* 发送方向的超时处理 */
+static void ym_tx_timeout(uint32_t now)
+{
+    uint32_t limit = s_ym.started ? CLI_YMODEM_PACKET_TIMEOUT : CLI_YMODEM_START_TIMEOUT;
+
+    if (now - s_ym.last_ms < limit)
+    {
+        return;
+    }
+    if (!s_ym.started || ++s_ym.retries > YM_MAX_RETRIES)
+    {
+        ym_abort("timeout");
+        return;
+    }
+    s_ym.last_ms = now;
+    /* 应答超时：重发当前包 */
+    if (s_ym.phase == TX_WAIT_ACK_EOT)
+    {
+        ym_send_byte(YM_EOT);
+    }
+    else if (s_ym.phase == TX_WAIT_ACK_HDR || s_ym.phase == TX_WAIT_ACK_DATA ||
+             s_ym.phase == TX_WAIT_ACK_FIN)
+    {
+        ym_tx_send_packet();
+    }
+}
+
+/* ---------------- 公共部分 ---------------- */
+
+/*
+ * 按当前状态设定最近的超时期限。期限只会因收发而推后，定时器提前到期时
+ * 超时处理函数不做任何事，重新设定即可。
+ */
+static void ym_arm(void)
+{
+    uint32_t due;
+
+    if (s_ym.mode == YM_IDLE)
+    {
+        cli_timer_cancel(&s_ym_timer);
+        return;
+    }
+    if (s_ym.mode == YM_TX)
+    {
+        due = s_ym.last_ms + (s_ym.started ? CLI_YMODEM_PACKET_TIMEOUT : CLI_YMODEM_START_TIMEOUT);
+    }
+    else if (s_ym.pos > 0)
+    {
+        due = s_ym.last_ms + CLI_YMODEM_BYTE_TIMEOUT;
+    }
+    else if (!s_ym.file_open)
+    {
+        /* 等待文件头：启动超时和下一次发送 'C' 中较早者 */
+        due = s_ym.last_ms + (s_ym.started ? CLI_YMODEM_PACKET_TIMEOUT : CLI_YMODEM_START_TIMEOUT);
+        if ((int32_t)(s_ym.last_tx_ms + YM_C_INTERVAL - due) < 0)
+        {
+            due = s_ym.last_tx_ms + YM_C_INTERVAL;
+        }
+    }
+    else
+    {
+        due = s_ym.last_ms + CLI_YMODEM_PACKET_TIMEOUT;
+    }
+    cli_timer_start_at(&s_ym_timer, due);
+}
+
+static void ym_input(char c)
+{
+    if (s_ym.mode == YM_RX)
+    {
+        ym_rx_input((uint8_t)c);
+    }
+    else if (s_ym.mode == YM_TX)
+    {
+        ym_tx_input((uint8_t)c);
+    }
+    ym_arm();
+}
+
+static void ym_timeout(void *ctx)
+{
+    uint32_t now = cli_get_tick_ms();
+
+    (void)ctx;
+    if (s_ym.mode == YM_RX)
+    {
+        ym_rx_timeout(now);
+    }
+    else if (s_ym.mode == YM_TX)
+    {
+        ym_tx_timeout(now);
+    }
+    ym_arm();
+}
+
+void cli_ymodem_init(const cli_ymodem_storage_t *storage)
+{
+    memset(&s_ym, 0, sizeof(s_ym));
+    s_ym.storage = storage;
+    cli_timer_init(&s_ym_timer, ym_timeout, NULL);
+}
+
+/* 进入传输状态 */
+static void ym_begin(ym_mode_t mode)
+{
+    const cli_ymodem_storage_t *storage = s_ym.storage;
+    memset(&s_ym, 0, sizeof(s_ym));
+    s_ym.storage = storage;
+    s_ym.mode = mode;
+    s_ym.start_ms = cli_get_tick_ms();
+    s_ym.last_ms = s_ym.start_ms;
+    cli_set_binary(1);
+    cli_input_acquire(ym_input);
+    ym_arm();
+}
+
+/* rx 命令 */
+static int cmd_rx(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    if (s_ym.storage == NULL || s_ym.storage->open_write == NULL)
+    {
+        cli_puts("No storage for YMODEM\r\n");
+        return -1;
+    }
+    cli_puts("Waiting for YMODEM sender (Ctrl-X x2 to cancel)...\r\n");
+    ym_begin(YM_RX);
+    ym_send_byte(YM_CRC);
+    return 0;
+}
+
+/* sx 命令 */
+static int cmd_sx(int argc, char **argv)
+{
+    uint32_t size = 0;
+    uint8_t header[YM_BLOCK_128];
+    size_t name_len;
+    size_t n;
+    const char *base;
+
+    if (argc != 2)
+    {
+        cli_puts("Usage: sx <file>\r\n");
+        return -1;
+    }
+    if (s_ym.storage == NULL || s_ym.storage->open_read == NULL)
+    {
+        cli_puts("No storage for YMODEM\r\n");
+        return -1;
+    }
+    /* 头块中只发送文件名部分 */
+    base = strrchr(argv[1], '/');
+    base = (base != NULL) ? base + 1 : argv[1];
+    name_len = strlen(base);
+    if (name_len == 0 || name_len >= CLI_YMODEM_NAME_MAX)
+    {
+        cli_puts("Invalid file name\r\n");
+        return -1;
+    }
+    if (s_ym.storage->open_read(s_ym.storage->ctx, argv[1], &size) != 0)
+    {
+        cli_printf("Cannot open %s\r\n", argv[1]);
+        return -1;
+    }
+
+    cli_puts("Waiting for YMODEM receiver (Ctrl-X x2 to cancel)...\r\n");
+    ym_begin(YM_TX);
+    s_ym.file_open = true;
+    s_ym.file_size = size;
+    s_ym.phase = TX_WAIT_C_HDR;
+
+    /* 头块：文件名 \0 十进制大小 */
+    memset(header, 0, sizeof(header));
+    memcpy(header, base, name_len);
+    n = name_len + 1;
+    {
+        char digits[10];
+        size_t k = 0;
+        do {
+            digits[k++] = (char)('0' + size % 10);
+            size /= 10;
+        } while (size > 0);
+        while (k > 0)
+        {
+            header[n++] = (uint8_t)digits[--k];
+        }
+    }
+    ym_tx_build(0, header, sizeof(header), YM_BLOCK_128, 0);
+    return 0;
+}
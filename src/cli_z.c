@@ -0,0 +1,212 @@
+/*
+ * @file cli_z.c
+ * @brief 压缩批量输出通道实现
+ *
+ * 输出先累积到 [历史窗口 | 当前块] 的线性缓冲区，满一块后用3字节哈希查找
+ * 窗口内的最近匹配（贪心，单候选），编码后立即作为一帧发送。缓冲区满时
+ * 把最后 CLI_Z_WINDOW 字节移到开头，哈希表中的位置同步平移。
+ * RAM 占用约 CLI_Z_WINDOW + 2 * CLI_Z_CHUNK + 2^CLI_Z_HASH_BITS * 2 字节。
+ */
+
+#include <cli_z.h>
+#include <string.h>
+
+#define Z_BUF_SIZE              (CLI_Z_WINDOW + CLI_Z_CHUNK)
+#define Z_HASH_SIZE             (1u << CLI_Z_HASH_BITS)
+#define Z_HASH_EMPTY            0xFFFF
+#define Z_OUT_MAX               (CLI_Z_CHUNK + CLI_Z_CHUNK / 128 + 8)
+#define Z_MAX_LITERALS          128
+
+/* 编译期检查配置 */
+typedef char z_window_check[(CLI_Z_WINDOW <= CLI_Z_MAX_OFFSET &&
+                             (CLI_Z_WINDOW & (CLI_Z_WINDOW - 1)) == 0) ? 1 : -1];
+typedef char z_buf_check[(Z_BUF_SIZE < Z_HASH_EMPTY) ? 1 : -1];
+
+/* 压缩状态 */
+static struct
+{
+    int active;
+    uint8_t buf[Z_BUF_SIZE];        /* 历史窗口 + 待压缩数据 */
+    size_t pos;                     /* 已压缩到的位置 */
+    size_t end;                     /* 已填充到的位置 */
+    uint16_t hash[Z_HASH_SIZE];     /* 3字节前缀最近出现的位置 */
+    uint8_t out[Z_OUT_MAX + 2];     /* 帧输出缓冲区（含长度头） */
+    uint32_t start_ms;
+} s_z;
+
+static cli_z_stats_t s_z_stats;
+
+static uint32_t z_hash3(const uint8_t *p)
+{
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (v * 2654435761u) >> (32 - CLI_Z_HASH_BITS);
+}
+
+/* 输出字面字节，返回新的输出位置 */
+static size_t z_emit_literals(uint8_t *out, size_t n, const uint8_t *src, size_t len)
+{
+    while (len > 0)
+    {
+        size_t run = (len > Z_MAX_LITERALS) ? Z_MAX_LITERALS : len;
+        out[n++] = (uint8_t)(run - 1);
+        memcpy(out + n, src, run);
+        n += run;
+        src += run;
+        len -= run;
+    }
+    return n;
+}
+
+/* 输出匹配令牌 */
+static size_t z_emit_match(uint8_t *out, size_t n, size_t offset, size_t len)
+{
+    size_t o = offset - 1;
+    size_t m = len - CLI_Z_MIN_MATCH;
+    if (m >= 15)
+    {
+        out[n++] = (uint8_t)(0x80 | (15u << 3) | (o >> 8));
+        out[n++] = (uint8_t)o;
+        out[n++] = (uint8_t)(m - 15);
+    }
+    else
+    {
+        out[n++] = (uint8_t)(0x80 | (m << 3) | (o >> 8));
+        out[n++] = (uint8_t)o;
+    }
+    return n;
+}
+
+/* 压缩 [pos, end) 并作为一帧发送 */
+static void z_flush_chunk(void)
+{
+    uint8_t *out = s_z.out + 2;
+    size_t n = 0;
+    size_t i = s_z.pos;
+    size_t lit = i;
+    size_t end = s_z.end;
+
+    if (end == i)
+    {
+        return;
+    }
+
+    while (i + CLI_Z_MIN_MATCH <= end)
+    {
+        uint32_t h = z_hash3(&s_z.buf[i]);
+        size_t cand = s_z.hash[h];
+        s_z.hash[h] = (uint16_t)i;
+
+        if (cand != Z_HASH_EMPTY && i - cand <= CLI_Z_WINDOW &&
+            memcmp(&s_z.buf[cand], &s_z.buf[i], CLI_Z_MIN_MATCH) == 0)
+        {
+            size_t len = CLI_Z_MIN_MATCH;
+            while (i + len < end && len < CLI_Z_MAX_MATCH && s_z.buf[cand + len] == s_z.buf[i + len])
+            {
+                len++;
+            }
+            n = z_emit_literals(out, n, &s_z.buf[lit], i - lit);
+            n = z_emit_match(out, n, i - cand, len);
+            /* 匹配末尾再登记一次，提高后续命中率 */
+            if (i + len + CLI_Z_MIN_MATCH <= end && len > CLI_Z_MIN_MATCH)
+            {
+                s_z.hash[z_hash3(&s_z.buf[i + len - 1])] = (uint16_t)(i + len - 1);
+            }
+            i += len;
+            lit = i;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    n = z_emit_literals(out, n, &s_z.buf[lit], end - lit);
+
+    s_z.out[0] = (uint8_t)n;
+    s_z.out[1] = (uint8_t)(n >> 8);
+    cli_write_raw((const char *)s_z.out, n + 2);
+    s_z_stats.bytes_out += (uint32_t)(n + 2);
+    s_z.pos = end;
+
+    /* 缓冲区剩余空间不足一块时平移，只保留窗口 */
+    if (Z_BUF_SIZE - s_z.end < CLI_Z_CHUNK && s_z.end > CLI_Z_WINDOW)
+    {
+        size_t shift = s_z.end - CLI_Z_WINDOW;
+        memmove(s_z.buf, s_z.buf + shift, CLI_Z_WINDOW);
+        for (size_t k = 0; k < Z_HASH_SIZE; k++)
+        {
+            s_z.hash[k] = (s_z.hash[k] == Z_HASH_EMPTY || s_z.hash[k] < shift) ?
+                          Z_HASH_EMPTY : (uint16_t)(s_z.hash[k] - shift);
+        }
+        s_z.pos = CLI_Z_WINDOW;
+        s_z.end = CLI_Z_WINDOW;
+    }
+}
+
+/* 输出过滤器：数据进入压缩缓冲区 */
+static void z_filter(const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        size_t room = CLI_Z_CHUNK - (s_z.end - s_z.pos);
+        size_t n = (len < room) ? len : room;
+        memcpy(&s_z.buf[s_z.end], data, n);
+        s_z.end += n;
+        data += n;
+        len -= n;
+        s_z_stats.bytes_in += (uint32_t)n;
+        if (s_z.end - s_z.pos == CLI_Z_CHUNK)
+        {
+            z_flush_chunk();
+        }
+    }
+}
+
+cli_error_t cli_z_begin(void)
+{
+    if (s_z.active)
+    {
+        return CLI_ERR_DUPLICATE;
+    }
+    s_z.active = 1;
+    s_z.pos = 0;
+    s_z.end = 0;
+    memset(s_z.hash, 0xFF, sizeof(s_z.hash));
+    s_z.start_ms = cli_get_tick_ms();
+
+    cli_set_binary(1);
+    cli_write_raw(CLI_Z_MAGIC, CLI_Z_MAGIC_LEN);
+    s_z_stats.bytes_out += CLI_Z_MAGIC_LEN;
+    cli_set_output_filter(z_filter);
+    return CLI_SUCCESS;
+}
+
+void cli_z_end(void)
+{
+    static const char terminator[2] = { 0, 0 };
+
+    if (!s_z.active)
+    {
+        return;
+    }
+    z_flush_chunk();
+    cli_write_raw(terminator, sizeof(terminator));
+    s_z_stats.bytes_out += sizeof(terminator);
+    cli_set_output_filter(NULL);
+    cli_set_binary(0);
+    s_z.active = 0;
+    s_z_stats.sessions++;
+    s_z_stats.elapsed_ms += cli_get_tick_ms() - s_z.start_ms;
+}
+
+int cli_z_active(void)
+{
+    return s_z.active;
+}
+
+void cli_z_get_stats(cli_z_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = s_z_stats;
+    }
+}
@@ -0,0 +1,950 @@
+/*
+ * @file cli_fanout.c
+ * @brief 主机端批量执行的实现（POSIX）
+ *
+ * 所有端点在一个 poll 循环中推进：非阻塞连接、写入请求、读取直到结束标记，
+ * 同时进行的端点数不超过并发上限。域名解析（getaddrinfo）是阻塞的。
+ */
+
+#define _GNU_SOURCE
+
+#include "cli_fanout.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define FANOUT_TAG              "fanout"
+#define FANOUT_DEF_CONCURRENCY  16u
+#define FANOUT_DEF_TIMEOUT_MS   5000u
+#define FANOUT_READ_CHUNK       4096u
+#define FANOUT_DIFF_CELLS       (4u * 1024u * 1024u)  /* 逐行比较的表格上限 */
+#define FANOUT_DIFF_CONTEXT     2u                    /* 差异前后显示的相同行数 */
+#define FANOUT_KILL_WAIT_MS     500u                  /* exec 端点 SIGTERM 后等待退出的时间 */
+
+/* 进行中的端点 */
+typedef struct
+{
+    int fd;                     /* -1 表示空闲 */
+    pid_t pid;                  /* exec 端点的子进程，否则为 -1 */
+    int connecting;
+    struct addrinfo *ai_list;   /* tcp 端点解析出的地址，连接成功前依次尝试 */
+    struct addrinfo *ai_next;
+    size_t idx;                 /* 对应的结果下标 */
+    uint64_t start_ms;
+    size_t req_pos;             /* 请求已写出的字节数 */
+    char *buf;
+    size_t len;
+    size_t cap;
+} fo_slot_t;
+
+/* 输出中的一行 */
+typedef struct
+{
+    const char *p;
+    size_t len;
+} fo_line_t;
+
+static uint64_t fo_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static void fo_error(cli_fanout_result_t *r, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(r->error, sizeof(r->error), fmt, ap);
+    va_end(ap);
+    r->status = CLI_FANOUT_ERROR;
+}
+
+/* 非阻塞连接，返回0表示已发起（可能仍在进行） */
+static int fo_connect(fo_slot_t *s, int family, const struct sockaddr *addr, socklen_t addrlen,
+                      cli_fanout_result_t *r)
+{
+    s->fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->fd < 0)
+    {
+        fo_error(r, "socket: %s", strerror(errno));
+        return -1;
+    }
+    if (connect(s->fd, addr, addrlen) == 0)
+    {
+        return 0;
+    }
+    if (errno == EINPROGRESS)
+    {
+        s->connecting = 1;
+        return 0;
+    }
+    fo_error(r, "connect: %s", strerror(errno));
+    close(s->fd);
+    s->fd = -1;
+    return -1;
+}
+
+static int fo_open_exec(fo_slot_t *s, const char *cmdline, cli_fanout_result_t *r)
+{
+    int sv[2];
+    pid_t pid;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0)
+    {
+        fo_error(r, "socketpair: %s", strerror(errno));
+        return -1;
+    }
+    pid = fork();
+    if (pid < 0)
+    {
+        fo_error(r, "fork: %s", strerror(errno));
+        close(sv[0]);
+        close(sv[1]);
+        return -1;
+    }
+    if (pid == 0)
+    {
+        int null = open("/dev/null", O_WRONLY);
+        /* 独立进程组，结束时连同 sh 启动的子进程一起终止 */
+        setpgid(0, 0);
+        dup2(sv[1], STDIN_FILENO);
+        dup2(sv[1], STDOUT_FILENO);
+        if (null >= 0)
+        {
+            dup2(null, STDERR_FILENO);
+        }
+        execl("/bin/sh", "sh", "-c", cmdline, (char *)NULL);
+        _exit(127);
+    }
+    /* 父进程也设置一次，避免子进程尚未执行 setpgid 时 fo_close 找不到进程组 */
+    setpgid(pid, pid);
+    close(sv[1]);
+    fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+    s->fd = sv[0];
+    s->pid = pid;
+    return 0;
+}
+
+static int fo_open_unix(fo_slot_t *s, const char *path, cli_fanout_result_t *r)
+{
+    struct sockaddr_un sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(sa.sun_path))
+    {
+        fo_error(r, "socket path too long");
+        return -1;
+    }
+    strcpy(sa.sun_path, path);
+    return fo_connect(s, AF_UNIX, (const struct sockaddr *)&sa, sizeof(sa), r);
+}
+
+/* 依次尝试剩余的地址，直到发起一个连接 */
+static int fo_connect_next(fo_slot_t *s, cli_fanout_result_t *r)
+{
+    while (s->ai_next != NULL)
+    {
+        const struct addrinfo *ai = s->ai_next;
+        s->ai_next = ai->ai_next;
+        if (fo_connect(s, ai->ai_family, ai->ai_addr, ai->ai_addrlen, r) == 0)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int fo_open_tcp(fo_slot_t *s, const char *hostport, cli_fanout_result_t *r)
+{
+    char host[256];
+    const char *colon = strrchr(hostport, ':');
+    size_t hlen;
+    struct addrinfo hints;
+    int err;
+
+    if (colon == NULL || colon == hostport || colon[1] == '\0')
+    {
+        fo_error(r, "expected host:port");
+        return -1;
+    }
+    /* [IPv6]:端口 */
+    hlen = (size_t)(colon - hostport);
+    if (hostport[0] == '[' && hostport[hlen - 1] == ']')
+    {
+        hostport++;
+        hlen -= 2;
+    }
+    if (hlen >= sizeof(host))
+    {
+        fo_error(r, "host name too long");
+        return -1;
+    }
+    memcpy(host, hostport, hlen);
+    host[hlen] = '\0';
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    err = getaddrinfo(host, colon + 1, &hints, &s->ai_list);
+    if (err != 0)
+    {
+        s->ai_list = NULL;
+        fo_error(r, "%s", gai_strerror(err));
+        return -1;
+    }
+    s->ai_next = s->ai_list;
+    if (fo_connect_next(s, r) != 0)
+    {
+        freeaddrinfo(s->ai_list);
+        s->ai_list = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int fo_open(fo_slot_t *s, const char *target, cli_fanout_result_t *r)
+{
+    s->pid = -1;
+    s->connecting = 0;
+    s->ai_list = NULL;
+    s->ai_next = NULL;
+    s->req_pos = 0;
+    s->len = 0;
+    if (strncmp(target, "exec:", 5) == 0)
+    {
+        return fo_open_exec(s, target + 5, r);
+    }
+    if (strncmp(target, "unix:", 5) == 0)
+    {
+        return fo_open_unix(s, target + 5, r);
+    }
+    if (strncmp(target, "tcp:", 4) == 0)
+    {
+        target += 4;
+    }
+    return fo_open_tcp(s, target, r);
+}
+
+/* 结束 exec 端点的进程组：先 SIGTERM，限定时间内未退出则 SIGKILL */
+static void fo_kill(pid_t pid)
+{
+    static const struct timespec tick = { 0, 10 * 1000000L };
+
+    kill(-pid, SIGTERM);
+    for (unsigned waited = 0; waited < FANOUT_KILL_WAIT_MS; waited += 10u)
+    {
+        if (waitpid(pid, NULL, WNOHANG) != 0)
+        {
+            return;
+        }
+        nanosleep(&tick, NULL);
+    }
+    kill(-pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+static void fo_close(fo_slot_t *s)
+{
+    if (s->fd >= 0)
+    {
+        close(s->fd);
+        s->fd = -1;
+    }
+    if (s->ai_list != NULL)
+    {
+        freeaddrinfo(s->ai_list);
+        s->ai_list = NULL;
+        s->ai_next = NULL;
+    }
+    if (s->pid > 0)
+    {
+        fo_kill(s->pid);
+        s->pid = -1;
+    }
+}
+
+/* 保存输出：去掉 ANSI 转义序列和 '\r' */
+static void fo_set_output(cli_fanout_result_t *r, const char *p, size_t len)
+{
+    size_t i = 0;
+    size_t o = 0;
+
+    free(r->output);
+    r->output = malloc(len + 1);
+    if (r->output == NULL)
+    {
+        r->len = 0;
+        return;
+    }
+    while (i < len)
+    {
+        char c = p[i++];
+        if (c == '\033')
+        {
+            if (i < len && p[i] == '[')
+            {
+                /* CSI：参数直到 0x40..0x7E 的结束字节 */
+                for (i++; i < len && (p[i] < 0x40 || p[i] > 0x7E); i++)
+                {
+                }
+            }
+            i++;
+            continue;
+        }
+        if (c != '\r')
+        {
+            r->output[o++] = c;
+        }
+    }
+    r->output[o] = '\0';
+    r->len = o;
+}
+
+/* 查找开始标记之后的输出，返回其起点，没有时返回 NULL */
+static const char *fo_body(const fo_slot_t *s)
+{
+    const char *b = memmem(s->buf, s->len, "@@begin " FANOUT_TAG, sizeof("@@begin " FANOUT_TAG) - 1);
+    const char *nl;
+
+    if (b == NULL)
+    {
+        return NULL;
+    }
+    nl = memchr(b, '\n', (size_t)(s->buf + s->len - b));
+    return (nl != NULL) ? nl + 1 : NULL;
+}
+
+/* 收到完整的结束标记时返回1并填写结果 */
+static int fo_parse(const fo_slot_t *s, cli_fanout_result_t *r)
+{
+    static const char end_mark[] = "@@end " FANOUT_TAG " ";
+    const char *body = fo_body(s);
+    const char *e;
+    const char *eol;
+
+    if (body == NULL)
+    {
+        return 0;
+    }
+    e = memmem(body, (size_t)(s->buf + s->len - body), end_mark, sizeof(end_mark) - 1);
+    if (e == NULL)
+    {
+        return 0;
+    }
+    eol = memchr(e, '\n', (size_t)(s->buf + s->len - e));
+    if (eol == NULL)
+    {
+        return 0;
+    }
+    r->rc = (int)strtol(e + sizeof(end_mark) - 1, NULL, 10);
+    r->status = CLI_FANOUT_OK;
+    fo_set_output(r, body, (size_t)(e - body));
+    return 1;
+}
+
+/* 未完成时保留已收到的输出 */
+static void fo_keep_partial(const fo_slot_t *s, cli_fanout_result_t *r)
+{
+    const char *body = fo_body(s);
+    if (body != NULL)
+    {
+        fo_set_output(r, body, (size_t)(s->buf + s->len - body));
+    }
+}
+
+/* 读取可用数据，返回1表示该端点已结束 */
+static int fo_read(fo_slot_t *s, cli_fanout_result_t *r)
+{
+    for (;;)
+    {
+        ssize_t n;
+
+        if (s->cap - s->len < FANOUT_READ_CHUNK)
+        {
+            size_t cap = s->cap ? s->cap * 2 : FANOUT_READ_CHUNK * 2;
+            char *p = realloc(s->buf, cap);
+            if (p == NULL)
+            {
+                fo_error(r, "out of memory");
+                return 1;
+            }
+            s->buf = p;
+            s->cap = cap;
+        }
+        n = recv(s->fd, s->buf + s->len, s->cap - s->len, 0);
+        if (n > 0)
+        {
+            s->len += (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            return fo_parse(s, r);
+        }
+        if (fo_parse(s, r))
+        {
+            return 1;
+        }
+        fo_keep_partial(s, r);
+        if (n == 0)
+        {
+            fo_error(r, "connection closed");
+        }
+        else
+        {
+            fo_error(r, "recv: %s", strerror(errno));
+        }
+        return 1;
+    }
+}
+
+size_t cli_fanout_run(const char *const *targets, size_t n, const char *command,
+                      const cli_fanout_opts_t *opts, cli_fanout_result_t *results)
+{
+    unsigned conc = (opts != NULL && opts->concurrency != 0) ? opts->concurrency : FANOUT_DEF_CONCURRENCY;
+    unsigned timeout = (opts != NULL && opts->timeout_ms != 0) ? opts->timeout_ms : FANOUT_DEF_TIMEOUT_MS;
+    fo_slot_t *slots;
+    struct pollfd *pfds;
+    char *req;
+    size_t req_len;
+    size_t next = 0;
+    size_t active = 0;
+    size_t ok = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        memset(&results[i], 0, sizeof(results[i]));
+        results[i].target = targets[i];
+        results[i].status = CLI_FANOUT_ERROR;
+    }
+    if (conc > n)
+    {
+        conc = (unsigned)n;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    /* 设备可能不在自动化模式，先切换，避免回显和提示符混入输出 */
+    req_len = strlen("auto on\r@" FANOUT_TAG " \r") + strlen(command);
+    req = malloc(req_len + 1);
+    slots = calloc(conc, sizeof(*slots));
+    pfds = calloc(conc, sizeof(*pfds));
+    if (req == NULL || slots == NULL || pfds == NULL)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            fo_error(&results[i], "out of memory");
+        }
+        free(req);
+        free(slots);
+        free(pfds);
+        return 0;
+    }
+    snprintf(req, req_len + 1, "auto on\r@" FANOUT_TAG " %s\r", command);
+    for (unsigned k = 0; k < conc; k++)
+    {
+        slots[k].fd = -1;
+    }
+
+    while (next < n || active > 0)
+    {
+        uint64_t now;
+        int wait = -1;
+
+        /* 填充空闲槽位 */
+        for (unsigned k = 0; k < conc && next < n; k++)
+        {
+            while (slots[k].fd < 0 && next < n)
+            {
+                slots[k].idx = next++;
+                slots[k].start_ms = fo_now_ms();
+                if (fo_open(&slots[k], targets[slots[k].idx], &results[slots[k].idx]) == 0)
+                {
+                    active++;
+                }
+                else
+                {
+                    results[slots[k].idx].elapsed_ms = (uint32_t)(fo_now_ms() - slots[k].start_ms);
+                }
+            }
+        }
+        if (active == 0)
+        {
+            continue;
+        }
+
+        now = fo_now_ms();
+        for (unsigned k = 0; k < conc; k++)
+        {
+            fo_slot_t *s = &slots[k];
+            pfds[k].fd = s->fd;
+            pfds[k].events = POLLIN;
+            pfds[k].revents = 0;
+            if (s->fd < 0)
+            {
+                continue;
+            }
+            if (s->connecting || s->req_pos < req_len)
+            {
+                pfds[k].events |= POLLOUT;
+            }
+            {
+                uint64_t deadline = s->start_ms + timeout;
+                int left = (deadline > now) ? (int)(deadline - now) : 0;
+                if (wait < 0 || left < wait)
+                {
+                    wait = left;
+                }
+            }
+        }
+        if (poll(pfds, conc, wait) < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        now = fo_now_ms();
+        for (unsigned k = 0; k < conc; k++)
+        {
+            fo_slot_t *s = &slots[k];
+            cli_fanout_result_t *r = &results[s->idx];
+            short ev = pfds[k].revents;
+            int finished = 0;
+
+            if (s->fd < 0)
+            {
+                continue;
+            }
+            if (s->connecting && (ev & (POLLOUT | POLLERR | POLLHUP)))
+            {
+                int err = 0;
+                socklen_t elen = sizeof(err);
+                getsockopt(s->fd, SOL_SOCKET, SO_ERROR, &err, &elen);
+                s->connecting = 0;
+                if (err != 0)
+                {
+                    fo_error(r, "connect: %s", strerror(err));
+                    /* 换下一个解析出的地址，本轮的事件属于旧连接，忽略 */
+                    close(s->fd);
+                    s->fd = -1;
+                    if (fo_connect_next(s, r) != 0)
+                    {
+                        finished = 1;
+                    }
+                    ev = 0;
+                }
+            }
+            if (!finished && !s->connecting && s->req_pos < req_len && (ev & POLLOUT))
+            {
+                ssize_t w = send(s->fd, req + s->req_pos, req_len - s->req_pos, MSG_NOSIGNAL);
+                if (w > 0)
+                {
+                    s->req_pos += (size_t)w;
+                }
+                else if (w < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                {
+                    fo_error(r, "send: %s", strerror(errno));
+                    finished = 1;
+                }
+            }
+            if (!finished && !s->connecting && (ev & (POLLIN | POLLHUP | POLLERR)))
+            {
+                finished = fo_read(s, r);
+            }
+            if (!finished && now >= s->start_ms + timeout)
+            {
+                fo_keep_partial(s, r);
+                r->status = CLI_FANOUT_TIMEOUT;
+                finished = 1;
+            }
+            if (finished)
+            {
+                if (r->status == CLI_FANOUT_OK)
+                {
+                    /* 恢复交互模式，不等待回应；发送失败不影响结果 */
+                    send(s->fd, "auto off\r", sizeof("auto off\r") - 1, MSG_NOSIGNAL);
+                }
+                r->elapsed_ms = (uint32_t)(now - s->start_ms);
+                if (r->status == CLI_FANOUT_OK && r->rc == 0)
+                {
+                    ok++;
+                }
+                fo_close(s);
+                active--;
+            }
+        }
+    }
+
+    for (unsigned k = 0; k < conc; k++)
+    {
+        free(slots[k].buf);
+    }
+    free(slots);
+    free(pfds);
+    free(req);
+    return ok;
+}
+
+void cli_fanout_free(cli_fanout_result_t *results, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        free(results[i].output);
+        results[i].output = NULL;
+        results[i].len = 0;
+    }
+}
+
+/* 两个结果是否归为一组 */
+static int fo_same(const cli_fanout_result_t *a, const cli_fanout_result_t *b)
+{
+    if (a->status != b->status)
+    {
+        return 0;
+    }
+    switch (a->status)
+    {
+        case CLI_FANOUT_OK:
+            return a->rc == b->rc && a->len == b->len &&
+                   (a->len == 0 || memcmp(a->output, b->output, a->len) == 0);
+        case CLI_FANOUT_ERROR:
+            return strcmp(a->error, b->error) == 0;
+        default:
+            return 1;
+    }
+}
+
+/* 拆分为行，返回行数；lines 为 NULL 时只计数 */
+static size_t fo_split(const char *p, size_t len, fo_line_t *lines)
+{
+    size_t count = 0;
+    size_t start = 0;
+
+    for (size_t i = 0; i <= len; i++)
+    {
+        if (i == len || p[i] == '\n')
+        {
+            if (i == len && i == start)
+            {
+                break;          /* 末尾的换行不产生空行 */
+            }
+            if (lines != NULL)
+            {
+                lines[count].p = p + start;
+                lines[count].len = i - start;
+            }
+            count++;
+            start = i + 1;
+        }
+    }
+    return count;
+}
+
+static int fo_line_eq(const fo_line_t *a, const fo_line_t *b)
+{
+    return a->len == b->len && memcmp(a->p, b->p, a->len) == 0;
+}
+
+static void fo_print_line(FILE *out, char mark, const fo_line_t *l, int color)
+{
+    const char *on = "";
+    const char *off = "";
+
+    if (color && mark == '-')
+    {
+        on = "\033[31m";
+        off = "\033[m";
+    }
+    else if (color && mark == '+')
+    {
+        on = "\033[32m";
+        off = "\033[m";
+    }
+    fprintf(out, "%s  %c %.*s%s\n", on, mark, (int)l->len, l->p, off);
+}
+
+static void fo_print_text(FILE *out, const char *p, size_t len)
+{
+    size_t count = fo_split(p, len, NULL);
+    fo_line_t *lines = malloc((count ? count : 1) * sizeof(*lines));
+
+    if (lines == NULL)
+    {
+        return;
+    }
+    fo_split(p, len, lines);
+    for (size_t i = 0; i < count; i++)
+    {
+        fprintf(out, "    %.*s\n", (int)lines[i].len, lines[i].p);
+    }
+    free(lines);
+}
+
+/* 逐行比较（最长公共子序列），只显示差异及其前后几行 */
+static void fo_print_diff(FILE *out, const cli_fanout_result_t *base, const cli_fanout_result_t *r, int color)
+{
+    size_t na = fo_split(base->output, base->len, NULL);
+    size_t nb = fo_split(r->output, r->len, NULL);
+    fo_line_t *a;
+    fo_line_t *b;
+    uint32_t *lcs;
+    char *ops;
+    size_t *ref;
+    size_t nops = 0;
+    size_t i;
+    size_t j;
+    size_t last = 0;
+
+    if ((na + 1) * (nb + 1) > FANOUT_DIFF_CELLS)
+    {
+        fprintf(out, "    (too large to compare, full output follows)\n");
+        fo_print_text(out, r->output, r->len);
+        return;
+    }
+    a = malloc((na + 1) * sizeof(*a));
+    b = malloc((nb + 1) * sizeof(*b));
+    lcs = calloc((na + 1) * (nb + 1), sizeof(*lcs));
+    ops = malloc(na + nb + 1);
+    ref = malloc((na + nb + 1) * sizeof(*ref));
+    if (a == NULL || b == NULL || lcs == NULL || ops == NULL || ref == NULL)
+    {
+        goto out;
+    }
+    fo_split(base->output, base->len, a);
+    fo_split(r->output, r->len, b);
+
+#define LCS(x, y)   lcs[(x) * (nb + 1) + (y)]
+    for (i = na; i-- > 0;)
+    {
+        for (j = nb; j-- > 0;)
+        {
+            if (fo_line_eq(&a[i], &b[j]))
+            {
+                LCS(i, j) = LCS(i + 1, j + 1) + 1;
+            }
+            else
+            {
+                LCS(i, j) = (LCS(i + 1, j) >= LCS(i, j + 1)) ? LCS(i + 1, j) : LCS(i, j + 1);
+            }
+        }
+    }
+
+    /* 生成编辑序列：' ' 相同（ref 为 a 的下标），'-' 仅基准有，'+' 仅本组有 */
+    i = 0;
+    j = 0;
+    while (i < na || j < nb)
+    {
+        if (i < na && j < nb && fo_line_eq(&a[i], &b[j]))
+        {
+            ops[nops] = ' ';
+            ref[nops++] = i;
+            i++;
+            j++;
+        }
+        else if (i < na && (j == nb || LCS(i + 1, j) >= LCS(i, j + 1)))
+        {
+            ops[nops] = '-';
+            ref[nops++] = i++;
+        }
+        else
+        {
+            ops[nops] = '+';
+            ref[nops++] = j++;
+        }
+    }
+#undef LCS
+
+    /* 输出差异，相同行只保留差异附近的几行 */
+    for (size_t k = 0; k < nops; k++)
+    {
+        int near = 0;
+        if (ops[k] == ' ')
+        {
+            size_t lo = (k > FANOUT_DIFF_CONTEXT) ? k - FANOUT_DIFF_CONTEXT : 0;
+            size_t hi = (k + FANOUT_DIFF_CONTEXT < nops) ? k + FANOUT_DIFF_CONTEXT : nops - 1;
+            for (size_t m = lo; m <= hi && !near; m++)
+            {
+                near = (ops[m] != ' ');
+            }
+            if (!near)
+            {
+                continue;
+            }
+        }
+        if (k > last)
+        {
+            fprintf(out, "    ...\n");
+        }
+        fo_print_line(out, ops[k], (ops[k] == '+') ? &b[ref[k]] : &a[ref[k]], color);
+        last = k + 1;
+    }
+    if (last == 0)
+    {
+        fprintf(out, "    (same output)\n");
+    }
+    else if (last < nops)
+    {
+        fprintf(out, "    ...\n");
+    }
+
+out:
+    free(a);
+    free(b);
+    free(lcs);
+    free(ops);
+    free(ref);
+}
+
+size_t cli_fanout_report(FILE *out, const cli_fanout_result_t *results, size_t n, int color)
+{
+    size_t *group = malloc((n ? n : 1) * sizeof(*group));     /* 每个结果所属组的首个下标 */
+    size_t *count = calloc(n ? n : 1, sizeof(*count));        /* 以首个下标计的组大小 */
+    size_t *order = malloc((n ? n : 1) * sizeof(*order));     /* 组（首个下标）按大小排序 */
+    size_t ngroups = 0;
+    size_t base = n;
+    size_t ok = 0;
+    size_t failed = 0;
+    size_t timeouts = 0;
+    size_t errors = 0;
+    uint32_t slowest = 0;
+
+    if (group == NULL || count == NULL || order == NULL)
+    {
+        free(group);
+        free(count);
+        free(order);
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t g;
+        for (g = 0; g < ngroups; g++)
+        {
+            if (fo_same(&results[order[g]], &results[i]))
+            {
+                break;
+            }
+        }
+        if (g == ngroups)
+        {
+            order[ngroups++] = i;
+        }
+        group[i] = order[g];
+        count[order[g]]++;
+    }
+
+    /* 按组大小降序，大小相同时保持出现顺序（插入排序，稳定） */
+    for (size_t g = 1; g < ngroups; g++)
+    {
+        size_t v = order[g];
+        size_t h = g;
+        while (h > 0 && count[order[h - 1]] < count[v])
+        {
+            order[h] = order[h - 1];
+            h--;
+        }
+        order[h] = v;
+    }
+    for (size_t g = 0; g < ngroups; g++)
+    {
+        if (results[order[g]].status == CLI_FANOUT_OK)
+        {
+            base = order[g];
+            break;
+        }
+    }
+
+    for (size_t g = 0; g < ngroups; g++)
+    {
+        const cli_fanout_result_t *r = &results[order[g]];
+        size_t listed = 0;
+
+        fprintf(out, "%s== %zu/%zu ", color ? "\033[1m" : "", count[order[g]], n);
+        switch (r->status)
+        {
+            case CLI_FANOUT_OK:
+                fprintf(out, "rc=%d", r->rc);
+                break;
+            case CLI_FANOUT_TIMEOUT:
+                fprintf(out, "timeout");
+                break;
+            default:
+                fprintf(out, "error: %s", r->error);
+                break;
+        }
+        if (order[g] != base && r->status == CLI_FANOUT_OK)
+        {
+            fprintf(out, " (differs)");
+        }
+        fprintf(out, ":%s", color ? "\033[m" : "");
+        for (size_t i = 0; i < n; i++)
+        {
+            if (group[i] == order[g])
+            {
+                fprintf(out, "%s %s", listed++ ? "," : "", results[i].target);
+            }
+        }
+        fprintf(out, "\n");
+
+        if (order[g] == base)
+        {
+            fo_print_text(out, r->output, r->len);
+        }
+        else if (r->status == CLI_FANOUT_OK && base < n)
+        {
+            fo_print_diff(out, &results[base], r, color);
+        }
+        else if (r->status == CLI_FANOUT_OK || (r->status == CLI_FANOUT_TIMEOUT && r->len > 0 && count[order[g]] == 1))
+        {
+            fo_print_text(out, r->output, r->len);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        switch (results[i].status)
+        {
+            case CLI_FANOUT_OK:
+                if (results[i].rc == 0)
+                {
+                    ok++;
+                }
+                else
+                {
+                    failed++;
+                }
+                break;
+            case CLI_FANOUT_TIMEOUT:
+                timeouts++;
+                break;
+            default:
+                errors++;
+                break;
+        }
+        if (results[i].elapsed_ms > slowest)
+        {
+            slowest = results[i].elapsed_ms;
+        }
+    }
+    fprintf(out, "%zu targets: %zu ok, %zu rc!=0, %zu timeout, %zu error; %zu distinct; slowest %u ms\n",
+            n, ok, failed, timeouts, errors, ngroups, (unsigned)slowest);
+
+    free(group);
+    free(count);
+    free(order);
+    return ngroups;
+}
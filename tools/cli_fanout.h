@@ -0,0 +1,73 @@
+/*
+ * @file cli_fanout.h
+ * @brief 主机端批量执行：把同一条命令并行发送到多个 CLI 端点并汇总结果
+ *
+ * 端点格式：
+ *   tcp:主机:端口   （也可省略 "tcp:"）
+ *   unix:路径
+ *   exec:命令行     由 /bin/sh 启动本地进程，标准输入输出接到 CLI（测试用）
+ *
+ * 每个端点上发送 "auto on" 和带标记的命令（见 cli.h 的自动化模式），
+ * 取 "@@begin" 与 "@@end" 之间的输出和返回码，收到 "@@end" 后发送 "auto off"
+ * 恢复交互模式。主机名解析出多个地址时依次尝试，直到连接成功。
+ */
+
+#ifndef CLI_FANOUT_H
+#define CLI_FANOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 单个端点的执行结果 */
+typedef enum
+{
+    CLI_FANOUT_OK,              /* 收到结束标记 */
+    CLI_FANOUT_TIMEOUT,         /* 超时，output 为已收到的部分 */
+    CLI_FANOUT_ERROR            /* 连接失败或提前断开，原因见 error */
+} cli_fanout_status_t;
+
+typedef struct
+{
+    const char *target;         /* 指向调用方传入的端点字符串 */
+    cli_fanout_status_t status;
+    int rc;                     /* 命令返回码（仅 CLI_FANOUT_OK 有效） */
+    char *output;               /* 命令输出（已去掉颜色转义，换行统一为 '\n'），'\0' 结尾 */
+    size_t len;
+    uint32_t elapsed_ms;        /* 从开始连接到结束的时间 */
+    char error[96];
+} cli_fanout_result_t;
+
+/* 执行参数，取0的项使用默认值 */
+typedef struct
+{
+    unsigned concurrency;       /* 同时进行的端点数，默认 16 */
+    unsigned timeout_ms;        /* 每个端点的超时（含连接），默认 5000 */
+} cli_fanout_opts_t;
+
+/*
+ * 在 n 个端点上执行 command，results 需有 n 项，完成后用 cli_fanout_free 释放。
+ * 返回成功（CLI_FANOUT_OK 且返回码为0）的端点数。
+ */
+size_t cli_fanout_run(const char *const *targets, size_t n, const char *command,
+                      const cli_fanout_opts_t *opts, cli_fanout_result_t *results);
+
+/* 释放结果中的输出缓冲区 */
+void cli_fanout_free(cli_fanout_result_t *results, size_t n);
+
+/*
+ * 汇总输出：相同结果的端点归为一组，按组大小排序；人数最多的成功组作为基准
+ * 完整输出，其余组只输出与基准的逐行差异（color 非0时以红/绿标出）。
+ * 返回分组数。
+ */
+size_t cli_fanout_report(FILE *out, const cli_fanout_result_t *results, size_t n, int color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLI_FANOUT_H */
@@ -0,0 +1,138 @@
+/*
+ * @file cli_fanout_main.c
+ * @brief 主机端工具：在多个 CLI 端点上并行执行同一条命令
+ *
+ * 用法：cli_fanout [-j 并发数] [-t 超时ms] [-f 端点列表] [-C] 命令 [端点...]
+ * 端点格式见 cli_fanout.h；列表文件每行一个端点，'#' 开头为注释。
+ * 全部端点成功且返回码为0时退出码为0，否则为1。
+ *
+ * 示例：cli_fanout -j 32 "version" tcp:10.0.0.1:2323 tcp:10.0.0.2:2323
+ *       cli_fanout "get loops" exec:./cli_demo exec:./cli_demo
+ */
+
+#define _GNU_SOURCE
+
+#include "cli_fanout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char **s_targets = NULL;
+static size_t s_count = 0;
+static size_t s_cap = 0;
+
+static void fanout_usage(void)
+{
+    fprintf(stderr, "usage: cli_fanout [-j jobs] [-t timeout_ms] [-f file] [-C] command [target...]\n"
+                    "targets: tcp:host:port | host:port | unix:path | exec:cmdline\n");
+    exit(2);
+}
+
+static void fanout_add(const char *target)
+{
+    if (s_count == s_cap)
+    {
+        s_cap = s_cap ? s_cap * 2 : 16;
+        s_targets = realloc(s_targets, s_cap * sizeof(*s_targets));
+        if (s_targets == NULL)
+        {
+            perror("cli_fanout");
+            exit(2);
+        }
+    }
+    s_targets[s_count++] = target;
+}
+
+/* 读取端点列表文件 */
+static void fanout_load(const char *path)
+{
+    FILE *f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+
+    if (f == NULL)
+    {
+        perror(path);
+        exit(2);
+    }
+    while ((len = getline(&line, &cap, f)) >= 0)
+    {
+        char *p = line;
+        while (len > 0 && (p[len - 1] == '\n' || p[len - 1] == '\r' || p[len - 1] == ' '))
+        {
+            p[--len] = '\0';
+        }
+        while (*p == ' ' || *p == '\t')
+        {
+            p++;
+        }
+        if (*p != '\0' && *p != '#')
+        {
+            fanout_add(strdup(p));
+        }
+    }
+    free(line);
+    if (f != stdin)
+    {
+        fclose(f);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    cli_fanout_opts_t opts = { 0, 0 };
+    cli_fanout_result_t *results;
+    int color = isatty(STDOUT_FILENO);
+    const char *command;
+    size_t ok;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:t:f:C")) != -1)
+    {
+        switch (opt)
+        {
+            case 'j':
+                opts.concurrency = (unsigned)strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                opts.timeout_ms = (unsigned)strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                fanout_load(optarg);
+                break;
+            case 'C':
+                color = 0;
+                break;
+            default:
+                fanout_usage();
+                break;
+        }
+    }
+    if (optind >= argc)
+    {
+        fanout_usage();
+    }
+    command = argv[optind++];
+    while (optind < argc)
+    {
+        fanout_add(argv[optind++]);
+    }
+    if (s_count == 0)
+    {
+        fanout_usage();
+    }
+
+    results = calloc(s_count, sizeof(*results));
+    if (results == NULL)
+    {
+        perror("cli_fanout");
+        return 2;
+    }
+    ok = cli_fanout_run(s_targets, s_count, command, &opts, results);
+    cli_fanout_report(stdout, results, s_count, color);
+    cli_fanout_free(results, s_count);
+    free(results);
+    return (ok == s_count) ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/*
+ * @file cli_fmt_bench.c
+ * @brief 主机端工具：校验 cli_fmt 与 libc 的一致性并对比 snprintf 的速度
+ *
+ * 用法：cli_fmt_bench [count]
+ * 校验项：最短表示能否往返（strtod/strtof）及是否最短；%.Nf、%.Ne、%.Ng
+ * （N = 0..17，含一组已知的中点和 subnormal 用例）与 snprintf 的差异数。
+ * 随后分别计时 cli_fmt 与 snprintf。
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <cli_fmt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static uint64_t bench_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return s_rng;
+}
+
+/* 随机有限 double：一半取任意位模式，一半取常见量级 */
+static double bench_rand_double(int i)
+{
+    double v;
+    uint64_t bits;
+
+    if (i & 1)
+    {
+        do {
+            bits = bench_rand();
+            memcpy(&v, &bits, sizeof(v));
+        } while (v != v || v - v != 0.0);
+        return v;
+    }
+    v = (double)(bench_rand() >> 11) / 9007199254740992.0;
+    return (v - 0.5) * (double)(1u << (bench_rand() % 24));
+}
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* libc 能往返的最短 %.Ng 有效位数 */
+static int bench_shortest_len(double v)
+{
+    char buf[40];
+    for (int p = 1; p <= 17; p++)
+    {
+        snprintf(buf, sizeof(buf), "%.*g", p, v);
+        if (strtod(buf, NULL) == v)
+        {
+            return p;
+        }
+    }
+    return 17;
+}
+
+/* 数字串中的有效位数 */
+static int bench_digits(const char *s)
+{
+    int n = 0;
+    int leading = 1;
+    for (; *s != '\0' && *s != 'e'; s++)
+    {
+        if (*s >= '0' && *s <= '9')
+        {
+            if (*s != '0')
+            {
+                leading = 0;
+            }
+            if (!leading)
+            {
+                n++;
+            }
+        }
+    }
+    /* 定点形式的整数末尾0不算有效位 */
+    return n;
+}
+
+/* 舍入容易出错的值：十进制中点附近、末位为5、subnormal */
+static const double s_edge_values[] = {
+    2.675, 1.45, 0.15, 0.125, 0.1, 0.3, 5e-324, 2.5, 0.5, 1.5, 9.5, 0.05, 1e23,
+    9.9999999999999995e-1, 123456789012345680.0, 4.35, 1e-300, 2.2250738585072014e-308,
+    1.7976931348623157e308, 0.0, 1e16, 99999999999999999.0, 0.000123456,
+};
+
+/* 按 %.Nc 与 libc 比较，返回差异数（前10个差异输出） */
+static int bench_compare(double v, char conv, int prec)
+{
+    static int reported = 0;
+    char fmt[8] = { '%', '.', '*', conv, '\0' };
+    char a[CLI_FMT_DOUBLE_MAX];
+    char b[400];
+
+    /* 整数部分超过17位的 %f 改用指数形式，不与 libc 比较 */
+    if (conv == 'f' && (v >= 1e17 || v <= -1e17))
+    {
+        return 0;
+    }
+    cli_fmt_double(a, v, conv, prec);
+    snprintf(b, sizeof(b), fmt, prec, v);
+    if (strcmp(a, b) != 0)
+    {
+        if (reported++ < 10)
+        {
+            printf("%%.%d%c of %.17g: %s vs libc %s\n", prec, conv, v, a, b);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 200000;
+    char a[CLI_FMT_DOUBLE_MAX];
+    char b[64];
+    int bad_rt = 0;
+    int longer = 0;
+    int bad_rt_f = 0;
+    int diff_f = 0;
+    int diff_e = 0;
+    int diff_g = 0;
+    double *vals;
+    double t0;
+    double t1;
+    volatile size_t sink = 0;
+
+    if (count <= 0)
+    {
+        count = 200000;
+    }
+    vals = malloc(sizeof(double) * (size_t)count);
+    if (vals == NULL)
+    {
+        return 1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        vals[i] = bench_rand_double(i);
+    }
+
+    /* 校验 */
+    for (int i = 0; i < count; i++)
+    {
+        double v = vals[i];
+        float f;
+
+        cli_fmt_double(a, v, 'g', -1);
+        if (strtod(a, NULL) != v)
+        {
+            if (bad_rt++ < 5)
+            {
+                printf("round-trip: %.17g -> %s\n", v, a);
+            }
+        }
+        else if (bench_digits(a) > bench_shortest_len(v) && strchr(a, 'e') != NULL)
+        {
+            longer++;
+        }
+
+        f = (float)v;
+        if (f - f == 0.0f)
+        {
+            cli_fmt_float(a, f);
+            if (strtof(a, NULL) != f && bad_rt_f++ < 5)
+            {
+                printf("round-trip float: %.9g -> %s\n", (double)f, a);
+            }
+        }
+
+        {
+            int prec = i % (CLI_FMT_PREC_MAX + 1);
+            diff_f += bench_compare(v, 'f', prec);
+            diff_e += bench_compare(v, 'e', prec);
+            diff_g += bench_compare(v, 'g', prec);
+        }
+    }
+    for (size_t i = 0; i < sizeof(s_edge_values) / sizeof(s_edge_values[0]); i++)
+    {
+        for (int prec = 0; prec <= CLI_FMT_PREC_MAX; prec++)
+        {
+            double v = s_edge_values[i];
+            diff_f += bench_compare(v, 'f', prec) + bench_compare(-v, 'f', prec);
+            diff_e += bench_compare(v, 'e', prec) + bench_compare(-v, 'e', prec);
+            diff_g += bench_compare(v, 'g', prec) + bench_compare(-v, 'g', prec);
+        }
+    }
+    printf("%d values: round-trip failures %d (float %d), not shortest %d, "
+           "%%.Nf diffs %d, %%.Ne diffs %d, %%.Ng diffs %d\n",
+           count, bad_rt, bad_rt_f, longer, diff_f, diff_e, diff_g);
+
+    /* 计时 */
+    t0 = bench_now();
+    for (int i = 0; i < count; i++)
+    {
+        sink += cli_fmt_double(a, vals[i], 'g', -1);
+    }
+    t1 = bench_now();
+    printf("shortest     cli_fmt %7.1f ns/op", (t1 - t0) * 1e9 / count);
+    t0 = bench_now();
+    for (int i = 0; i < count; i++)
+    {
+        sink += (size_t)snprintf(b, sizeof(b), "%.17g", vals[i]);
+    }
+    t1 = bench_now();
+    printf("   snprintf %%.17g %7.1f ns/op\n", (t1 - t0) * 1e9 / count);
+
+    t0 = bench_now();
+    for (int i = 0; i < count; i += 2)
+    {
+        sink += cli_fmt_double(a, vals[i], 'f', 3);
+    }
+    t1 = bench_now();
+    printf("%%.3f         cli_fmt %7.1f ns/op", (t1 - t0) * 2e9 / count);
+    t0 = bench_now();
+    for (int i = 0; i < count; i += 2)
+    {
+        sink += (size_t)snprintf(b, sizeof(b), "%.3f", vals[i]);
+    }
+    t1 = bench_now();
+    printf("   snprintf %%.3f  %7.1f ns/op\n", (t1 - t0) * 2e9 / count);
+
+    t0 = bench_now();
+    for (int i = 0; i < count; i++)
+    {
+        sink += cli_fmt_double(a, vals[i], 'e', 6);
+    }
+    t1 = bench_now();
+    printf("%%e           cli_fmt %7.1f ns/op", (t1 - t0) * 1e9 / count);
+    t0 = bench_now();
+    for (int i = 0; i < count; i++)
+    {
+        sink += (size_t)snprintf(b, sizeof(b), "%e", vals[i]);
+    }
+    t1 = bench_now();
+    printf("   snprintf %%e    %7.1f ns/op\n", (t1 - t0) * 1e9 / count);
+
+    free(vals);
+    return (bad_rt != 0 || bad_rt_f != 0 || diff_f != 0 || diff_e != 0 || diff_g != 0) ? 1 : 0;
+}
@@ -0,0 +1,493 @@
+/*
+ * @file cli_helpgen.c
+ * @brief 构建时工具：从源码提取命令帮助文本，压缩生成 cli_help_data.c（格式见 cli_help.h）
+ *
+ * 用法：cli_helpgen -o cli_help_data.c source.c...
+ * 在每个源文件中找 .name = "..." 及其后的 CLI_HELP("..." ...)（跳过注释，
+ * 支持转义和相邻字符串拼接），帮助文本只能含 ASCII 字符。
+ * 压缩为贪心字节对编码：反复把出现次数最多的相邻符号对替换为新代码，
+ * 直到 128 个代码用完或再替换不能节省空间；展开深度限制为 CLI_HELP_MAX_DEPTH。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define GEN_MAX_DEPTH   16              /* 与 cli_help.h 中的 CLI_HELP_MAX_DEPTH 一致 */
+#define GEN_MAX_CODES   128
+#define GEN_TEXT_MAX    4096
+
+typedef struct
+{
+    char *name;
+    uint32_t hash;
+    uint8_t *sym;                       /* 当前编码 */
+    size_t len;
+    size_t raw_len;
+    const char *file;
+    int line;
+} gen_entry_t;
+
+static gen_entry_t *s_entries = NULL;
+static size_t s_count = 0;
+static uint8_t s_pairs[GEN_MAX_CODES][2];
+static int s_depth[256];
+static int s_codes = 0;
+
+static uint32_t gen_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s != '\0')
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static char *gen_read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    char *buf;
+    long n;
+
+    if (f == NULL)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc((size_t)n + 1);
+    if (buf == NULL || fread(buf, 1, (size_t)n, f) != (size_t)n)
+    {
+        fclose(f);
+        free(buf);
+        return NULL;
+    }
+    fclose(f);
+    buf[n] = '\0';
+    *size = (size_t)n;
+    return buf;
+}
+
+static int gen_ident(char c)
+{
+    return c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+/* 跳过空白和注释，统计行号 */
+static const char *gen_skip(const char *p, int *line)
+{
+    for (;;)
+    {
+        if (*p == '\n')
+        {
+            (*line)++;
+            p++;
+        }
+        else if (*p == ' ' || *p == '\t' || *p == '\r')
+        {
+            p++;
+        }
+        else if (p[0] == '/' && p[1] == '*')
+        {
+            p += 2;
+            while (*p != '\0' && !(p[0] == '*' && p[1] == '/'))
+            {
+                if (*p++ == '\n')
+                {
+                    (*line)++;
+                }
+            }
+            p += (*p != '\0') ? 2 : 0;
+        }
+        else if (p[0] == '/' && p[1] == '/')
+        {
+            while (*p != '\0' && *p != '\n')
+            {
+                p++;
+            }
+        }
+        else
+        {
+            return p;
+        }
+    }
+}
+
+/*
+ * 解析一个或多个相邻字符串字面量，结果写入 out（以'\0'结尾）。
+ * 返回字面量之后的位置，格式错误返回 NULL。
+ */
+static const char *gen_string(const char *p, int *line, char *out, size_t max, const char **err)
+{
+    size_t n = 0;
+
+    if (*p != '"')
+    {
+        *err = "expected string literal";
+        return NULL;
+    }
+    while (*p == '"')
+    {
+        p++;
+        while (*p != '"')
+        {
+            int c = (unsigned char)*p++;
+            if (c == '\0' || c == '\n')
+            {
+                *err = "unterminated string";
+                return NULL;
+            }
+            if (c == '\\')
+            {
+                c = (unsigned char)*p++;
+                switch (c)
+                {
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case '\\': case '"': case '\'': case '?': break;
+                case 'x':
+                {
+                    char *end;
+                    c = (int)strtol(p, &end, 16);
+                    p = end;
+                    break;
+                }
+                default:
+                    *err = "unsupported escape";
+                    return NULL;
+                }
+            }
+            if (c <= 0 || c >= 0x80)
+            {
+                *err = "help text must be ASCII";
+                return NULL;
+            }
+            if (n + 1 >= max)
+            {
+                *err = "string too long";
+                return NULL;
+            }
+            out[n++] = (char)c;
+        }
+        p = gen_skip(p + 1, line);
+    }
+    out[n] = '\0';
+    return p;
+}
+
+static int gen_add(const char *name, const char *text, const char *file, int line)
+{
+    gen_entry_t *e;
+    size_t i;
+    size_t len = strlen(text);
+
+    s_entries = realloc(s_entries, (s_count + 1) * sizeof(*s_entries));
+    if (s_entries == NULL)
+    {
+        return -1;
+    }
+    e = &s_entries[s_count++];
+    e->name = strdup(name);
+    e->hash = gen_hash(name);
+    e->sym = malloc(len + 1);
+    e->len = len;
+    e->raw_len = len;
+    e->file = file;
+    e->line = line;
+    for (i = 0; i < len; i++)
+    {
+        e->sym[i] = (uint8_t)text[i];
+    }
+    return 0;
+}
+
+static int gen_scan(const char *path)
+{
+    size_t size;
+    char *buf = gen_read_file(path, &size);
+    const char *p;
+    const char *err = NULL;
+    char name[64];
+    char text[GEN_TEXT_MAX];
+    int have_name = 0;
+    int line = 1;
+
+    if (buf == NULL)
+    {
+        fprintf(stderr, "cli_helpgen: cannot read %s\n", path);
+        return -1;
+    }
+    p = buf;
+    while (*p != '\0')
+    {
+        p = gen_skip(p, &line);
+        if (*p == '"' || *p == '\'')
+        {
+            /* 其它字面量整体跳过 */
+            char q = *p++;
+            while (*p != '\0' && *p != q && *p != '\n')
+            {
+                p += (*p == '\\' && p[1] != '\0') ? 2 : 1;
+            }
+            p += (*p == q) ? 1 : 0;
+        }
+        else if (strncmp(p, ".name", 5) == 0)
+        {
+            p = gen_skip(p + 5, &line);
+            if (*p == '=')
+            {
+                p = gen_skip(p + 1, &line);
+                if (*p == '"')
+                {
+                    p = gen_string(p, &line, name, sizeof(name), &err);
+                    if (p == NULL)
+                    {
+                        break;
+                    }
+                    have_name = 1;
+                }
+            }
+        }
+        else if (strncmp(p, "CLI_HELP", 8) == 0 && (p == buf || !gen_ident(p[-1])))
+        {
+            p = gen_skip(p + 8, &line);
+            if (*p != '(')
+            {
+                continue;
+            }
+            if (!have_name)
+            {
+                err = "CLI_HELP without preceding .name";
+                break;
+            }
+            p = gen_string(gen_skip(p + 1, &line), &line, text, sizeof(text), &err);
+            if (p == NULL)
+            {
+                break;
+            }
+            if (*p != ')')
+            {
+                err = "expected ')'";
+                break;
+            }
+            if (gen_add(name, text, path, line) != 0)
+            {
+                err = "out of memory";
+                break;
+            }
+            have_name = 0;
+            p++;
+        }
+        else
+        {
+            p++;
+        }
+    }
+    free(buf);
+    if (err != NULL)
+    {
+        fprintf(stderr, "%s:%d: error: %s\n", path, line, err);
+        return -1;
+    }
+    return 0;
+}
+
+/* 贪心字节对编码 */
+static void gen_compress(void)
+{
+    static uint32_t counts[256 * 256];
+    int c;
+
+    for (c = 0; c < 256; c++)
+    {
+        s_depth[c] = 1;
+    }
+    while (s_codes < GEN_MAX_CODES)
+    {
+        size_t i;
+        size_t k;
+        uint32_t best = 0;
+        int best_pair = -1;
+        uint8_t code = (uint8_t)(0x80 + s_codes);
+
+        memset(counts, 0, sizeof(counts));
+        for (i = 0; i < s_count; i++)
+        {
+            const gen_entry_t *e = &s_entries[i];
+            size_t last = (size_t)-1;
+            for (k = 0; k + 1 < e->len; k++)
+            {
+                /* "aaa" 中重叠的两个对只能替换一次 */
+                if (last + 1 == k && e->sym[k - 1] == e->sym[k] && e->sym[k] == e->sym[k + 1])
+                {
+                    continue;
+                }
+                counts[(e->sym[k] << 8) | e->sym[k + 1]]++;
+                last = k;
+            }
+        }
+        for (i = 0; i < 256 * 256; i++)
+        {
+            int d = s_depth[i >> 8] > s_depth[i & 0xFF] ? s_depth[i >> 8] : s_depth[i & 0xFF];
+            if (counts[i] > best && d + 1 <= GEN_MAX_DEPTH)
+            {
+                best = counts[i];
+                best_pair = (int)i;
+            }
+        }
+        /* 新代码占字典2字节，至少出现3次才有收益 */
+        if (best < 3)
+        {
+            break;
+        }
+        s_pairs[s_codes][0] = (uint8_t)(best_pair >> 8);
+        s_pairs[s_codes][1] = (uint8_t)(best_pair & 0xFF);
+        s_depth[code] = 1 + (s_depth[best_pair >> 8] > s_depth[best_pair & 0xFF] ?
+                             s_depth[best_pair >> 8] : s_depth[best_pair & 0xFF]);
+        s_codes++;
+        for (i = 0; i < s_count; i++)
+        {
+            gen_entry_t *e = &s_entries[i];
+            size_t w = 0;
+            for (k = 0; k < e->len; k++)
+            {
+                if (k + 1 < e->len && ((e->sym[k] << 8) | e->sym[k + 1]) == best_pair)
+                {
+                    e->sym[w++] = code;
+                    k++;
+                }
+                else
+                {
+                    e->sym[w++] = e->sym[k];
+                }
+            }
+            e->len = w;
+        }
+    }
+}
+
+static int gen_cmp(const void *a, const void *b)
+{
+    const gen_entry_t *x = a;
+    const gen_entry_t *y = b;
+    return (x->hash > y->hash) - (x->hash < y->hash);
+}
+
+static int gen_write(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    size_t i;
+    size_t k;
+    size_t offset = 0;
+    size_t raw = 0;
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "cli_helpgen: cannot write %s\n", path);
+        return -1;
+    }
+    fprintf(f, "/* 由 tools/cli_helpgen 生成，请勿修改 */\n\n#include <cli_help.h>\n\n");
+    fprintf(f, "const uint8_t cli_help_pairs[%d][2] = {\n", s_codes > 0 ? s_codes : 1);
+    for (i = 0; i < (size_t)s_codes; i++)
+    {
+        fprintf(f, "    { 0x%02X, 0x%02X },\n", s_pairs[i][0], s_pairs[i][1]);
+    }
+    if (s_codes == 0)
+    {
+        fprintf(f, "    { 0, 0 }\n");
+    }
+    fprintf(f, "};\n\nconst uint8_t cli_help_blob[] = {\n");
+    for (i = 0; i < s_count; i++)
+    {
+        fprintf(f, "    /* %s */\n   ", s_entries[i].name);
+        for (k = 0; k < s_entries[i].len; k++)
+        {
+            fprintf(f, "%s 0x%02X,", (k > 0 && k % 12 == 0) ? "\n   " : "", s_entries[i].sym[k]);
+        }
+        fprintf(f, "\n");
+    }
+    if (s_count == 0)
+    {
+        fprintf(f, "    0\n");
+    }
+    fprintf(f, "};\n\nconst cli_help_entry_t cli_help_index[] = {\n");
+    for (i = 0; i < s_count; i++)
+    {
+        fprintf(f, "    { 0x%08lXu, %lu, %lu },\n", (unsigned long)s_entries[i].hash,
+                (unsigned long)offset, (unsigned long)s_entries[i].len);
+        offset += s_entries[i].len;
+        raw += s_entries[i].raw_len;
+    }
+    if (s_count == 0)
+    {
+        fprintf(f, "    { 0, 0, 0 }\n");
+    }
+    fprintf(f, "};\n\nconst uint16_t cli_help_count = %lu;\n", (unsigned long)s_count);
+    if (fclose(f) != 0)
+    {
+        return -1;
+    }
+    printf("cli_helpgen: %lu texts, %lu bytes -> %lu (dictionary %d, blob %lu, index %lu)\n",
+           (unsigned long)s_count, (unsigned long)raw,
+           (unsigned long)(s_codes * 2 + offset + s_count * sizeof(uint32_t) * 2),
+           s_codes * 2, (unsigned long)offset, (unsigned long)(s_count * sizeof(uint32_t) * 2));
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *out = NULL;
+    size_t i;
+    size_t offset = 0;
+    int a;
+
+    for (a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-o") == 0 && a + 1 < argc)
+        {
+            out = argv[++a];
+        }
+        else if (gen_scan(argv[a]) != 0)
+        {
+            return 1;
+        }
+    }
+    if (out == NULL)
+    {
+        fprintf(stderr, "usage: cli_helpgen -o cli_help_data.c source.c...\n");
+        return 2;
+    }
+
+    qsort(s_entries, s_count, sizeof(*s_entries), gen_cmp);
+    for (i = 1; i < s_count; i++)
+    {
+        if (s_entries[i].hash == s_entries[i - 1].hash)
+        {
+            fprintf(stderr, "%s:%d: error: command name '%s' %s '%s' (%s:%d)\n",
+                    s_entries[i].file, s_entries[i].line, s_entries[i].name,
+                    strcmp(s_entries[i].name, s_entries[i - 1].name) == 0 ?
+                    "duplicates" : "has the same hash as",
+                    s_entries[i - 1].name, s_entries[i - 1].file, s_entries[i - 1].line);
+            return 1;
+        }
+    }
+
+    gen_compress();
+
+    for (i = 0; i < s_count; i++)
+    {
+        offset += s_entries[i].len;
+        if (offset > 0xFFFFu || s_entries[i].len > 0xFFFFu)
+        {
+            fprintf(stderr, "cli_helpgen: compressed help exceeds 64 KiB\n");
+            return 1;
+        }
+    }
+    return gen_write(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/*
+ * @file cli_unz.c
+ * @brief 主机端解压工具：透传普通文本，遇到压缩帧（见 cli_z.h）时实时解压
+ *
+ * 用法：cli_unz < capture.bin 或 串口工具 | cli_unz
+ * 每解出一块立即刷新 stdout；每个会话结束时在 stderr 输出压缩比。
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define UNZ_WINDOW      2048u           /* 与格式的最大距离一致 */
+#define UNZ_MAGIC       "\0CZ1"
+#define UNZ_MAGIC_LEN   4
+
+static uint8_t s_window[UNZ_WINDOW];
+static uint32_t s_wpos = 0;
+
+static void unz_put(uint8_t c)
+{
+    s_window[s_wpos++ & (UNZ_WINDOW - 1)] = c;
+    putchar(c);
+}
+
+/* 解压一块，返回0成功，-1格式错误 */
+static int unz_chunk(const uint8_t *p, size_t n, uint32_t *out_bytes)
+{
+    size_t i = 0;
+
+    while (i < n)
+    {
+        uint8_t t = p[i++];
+        if ((t & 0x80) == 0)
+        {
+            size_t run = (size_t)t + 1;
+            if (i + run > n)
+            {
+                return -1;
+            }
+            for (size_t k = 0; k < run; k++)
+            {
+                unz_put(p[i + k]);
+            }
+            i += run;
+            *out_bytes += (uint32_t)run;
+        }
+        else
+        {
+            uint32_t m;
+            uint32_t offset;
+            uint32_t len;
+            if (i >= n)
+            {
+                return -1;
+            }
+            m = (t >> 3) & 0x0F;
+            offset = ((((uint32_t)t & 0x07) << 8) | p[i++]) + 1;
+            len = m + 3;
+            if (m == 15)
+            {
+                if (i >= n)
+                {
+                    return -1;
+                }
+                len = 18u + p[i++];
+            }
+            if (offset > s_wpos)
+            {
+                return -1;
+            }
+            for (uint32_t k = 0; k < len; k++)
+            {
+                unz_put(s_window[(s_wpos - offset) & (UNZ_WINDOW - 1)]);
+            }
+            *out_bytes += len;
+        }
+    }
+    return 0;
+}
+
+/* 读取一个压缩会话直到结束标记，返回0成功 */
+static int unz_session(void)
+{
+    static uint8_t chunk[65536];
+    uint32_t bytes_in = UNZ_MAGIC_LEN;
+    uint32_t bytes_out = 0;
+
+    s_wpos = 0;
+    for (;;)
+    {
+        int lo = getchar();
+        int hi = getchar();
+        size_t n;
+
+        if (lo == EOF || hi == EOF)
+        {
+            fprintf(stderr, "cli_unz: truncated stream\n");
+            return -1;
+        }
+        bytes_in += 2;
+        n = (size_t)lo | ((size_t)hi << 8);
+        if (n == 0)
+        {
+            break;
+        }
+        if (fread(chunk, 1, n, stdin) != n)
+        {
+            fprintf(stderr, "cli_unz: truncated chunk\n");
+            return -1;
+        }
+        bytes_in += (uint32_t)n;
+        if (unz_chunk(chunk, n, &bytes_out) != 0)
+        {
+            fprintf(stderr, "cli_unz: corrupt chunk\n");
+            return -1;
+        }
+        fflush(stdout);
+    }
+    fprintf(stderr, "cli_unz: %u -> %u bytes (%.2f:1)\n", bytes_in, bytes_out,
+            bytes_in ? (double)bytes_out / bytes_in : 0.0);
+    return 0;
+}
+
+int main(void)
+{
+    size_t matched = 0;
+    int c;
+
+    while ((c = getchar()) != EOF)
+    {
+        if ((char)c == UNZ_MAGIC[matched])
+        {
+            if (++matched == UNZ_MAGIC_LEN)
+            {
+                matched = 0;
+                fflush(stdout);
+                if (unz_session() != 0)
+                {
+                    return 1;
+                }
+            }
+            continue;
+        }
+        /* 未构成完整帧头的前缀按原样输出 */
+        fwrite(UNZ_MAGIC, 1, matched, stdout);
+        matched = 0;
+        if ((char)c == UNZ_MAGIC[0])
+        {
+            matched = 1;
+            continue;
+        }
+        putchar(c);
+        if (c == '\n')
+        {
+            fflush(stdout);
+        }
+    }
+    fwrite(UNZ_MAGIC, 1, matched, stdout);
+    return 0;
+}